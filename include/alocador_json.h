@@ -0,0 +1,115 @@
+#ifndef ALOCADOR_JSON_H
+#define ALOCADOR_JSON_H
+
+#include <stdlib.h>
+#include <ArduinoJson.h>
+
+// Alocador do ArduinoJson que guarda os blocos liberados para o próximo
+// documento. No ArduinoJson 7 o JsonDocument (e o StaticJsonDocument, que
+// virou apelido dele) tira do heap um pool de variantes de ~1 KB no ESP32;
+// serializado a cada requisição ou ciclo de telemetria, esse pool seria
+// alocado e liberado sempre. Aqui só os primeiros documentos vão ao heap e
+// os seguintes reutilizam os mesmos blocos.
+// Não é seguro entre tarefas: cada tarefa usa a sua instância.
+class AlocadorJson : public ArduinoJson::Allocator {
+public:
+    static const size_t MAXIMO_BLOCOS = 4;
+
+    AlocadorJson() : alocacoes_(0) {
+        for (Bloco &bloco : blocos_) {
+            bloco = Bloco{NULL, 0, false};
+        }
+    }
+
+    ~AlocadorJson() {
+        for (Bloco &bloco : blocos_) {
+            free(bloco.memoria);
+        }
+    }
+
+    void *allocate(size_t tamanho) override {
+        // O menor bloco livre que comporta o pedido
+        Bloco *escolhido = NULL;
+        Bloco *vazio = NULL;
+        Bloco *pequeno = NULL;
+        for (Bloco &bloco : blocos_) {
+            if (!bloco.memoria) {
+                vazio = vazio ? vazio : &bloco;
+            } else if (!bloco.em_uso) {
+                if (bloco.capacidade >= tamanho) {
+                    if (!escolhido || bloco.capacidade < escolhido->capacidade) {
+                        escolhido = &bloco;
+                    }
+                } else {
+                    pequeno = &bloco;
+                }
+            }
+        }
+        if (escolhido) {
+            escolhido->em_uso = true;
+            return escolhido->memoria;
+        }
+
+        alocacoes_++;
+        if (pequeno) {
+            void *memoria = realloc(pequeno->memoria, tamanho);
+            if (!memoria) {
+                return NULL;
+            }
+            *pequeno = Bloco{memoria, tamanho, true};
+            return memoria;
+        }
+        void *memoria = malloc(tamanho);
+        if (memoria && vazio) {
+            *vazio = Bloco{memoria, tamanho, true};
+        }
+        return memoria;
+    }
+
+    void deallocate(void *memoria) override {
+        Bloco *bloco = procurar(memoria);
+        if (bloco) {
+            bloco->em_uso = false;
+        } else {
+            free(memoria);
+        }
+    }
+
+    void *reallocate(void *memoria, size_t tamanho) override {
+        Bloco *bloco = procurar(memoria);
+        if (bloco && bloco->capacidade >= tamanho) {
+            return memoria;     // Encolher mantém o bloco inteiro para o próximo documento
+        }
+        alocacoes_++;
+        void *nova = realloc(memoria, tamanho);
+        if (nova && bloco) {
+            *bloco = Bloco{nova, tamanho, true};
+        }
+        return nova;
+    }
+
+    // Chamadas a malloc/realloc desde a criação; para de crescer quando os
+    // documentos passam a caber nos blocos guardados
+    unsigned long alocacoes() const { return alocacoes_; }
+
+private:
+    struct Bloco {
+        void *memoria;
+        size_t capacidade;
+        bool em_uso;
+    };
+
+    Bloco *procurar(void *memoria) {
+        for (Bloco &bloco : blocos_) {
+            if (memoria && bloco.memoria == memoria) {
+                return &bloco;
+            }
+        }
+        return NULL;
+    }
+
+    Bloco blocos_[MAXIMO_BLOCOS];
+    unsigned long alocacoes_;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef ANTECIPACAO_H
+#define ANTECIPACAO_H
+
+// Ação antecipatória (feed-forward) a partir do lado quente da pastilha.
+// Em regime, o PWM que segura a câmara no alvo cresce com a diferença entre
+// o dissipador e o alvo: o calor que vaza para a câmara e o que volta pela
+// pastilha acompanham essa diferença. O modelo é linear, em unidades de PWM:
+//   avanço = ganho * (quente - alvo) + base
+// Ganho e base podem ser fixos ou aprendidos por mínimos quadrados
+// recursivos com esquecimento. Cada ponto do ajuste é a média de um bloco
+// de DURACAO_BLOCO_S com a malha acomodada: a média da saída é o PWM de
+// regime para a média do lado quente. Amostras isoladas não servem, porque
+// o próprio PWM aquece o dissipador em segundos e a malha pode oscilar.
+// Só somas e multiplicações por amostra; não aloca memória.
+class Antecipacao {
+public:
+    static constexpr float DURACAO_BLOCO_S = 120;
+    static constexpr float ESQUECIMENTO = 0.98;        // Por bloco: memória de ~50 blocos
+    static constexpr float COVARIANCIA_INICIAL = 100;
+    static constexpr float COVARIANCIA_MAXIMA = 1000;  // Limite do traço sem excitação
+
+    Antecipacao(float ganho, float base, bool aprender) { configurar(ganho, base, aprender); }
+
+    // Ponto de partida do modelo; o aprendizado recomeça dele
+    void configurar(float ganho, float base, bool aprender) {
+        ganho_ = ganho;
+        base_ = base;
+        aprender_ = aprender;
+        p00_ = p11_ = COVARIANCIA_INICIAL;
+        p01_ = 0;
+        blocos_ = 0;
+        interromper();
+    }
+
+    float calcular(float quente, float alvo) const { return ganho_ * (quente - alvo) + base_; }
+
+    // Amostra com a malha acomodada: com a diferença quente - alvo, o
+    // controlador aplicou `saida` (PID mais avanço) durante dt segundos
+    void aprender(float quente, float alvo, float saida, float dt) {
+        if (!aprender_) {
+            return;
+        }
+        soma_x_ += (quente - alvo) * dt;
+        soma_saida_ += saida * dt;
+        duracao_s_ += dt;
+        if (duracao_s_ >= DURACAO_BLOCO_S) {
+            atualizar(soma_x_ / duracao_s_, soma_saida_ / duracao_s_);
+            interromper();
+        }
+    }
+
+    // A malha saiu da faixa: o bloco em andamento não representa o regime
+    void interromper() { soma_x_ = soma_saida_ = duracao_s_ = 0; }
+
+    float ganho() const { return ganho_; }
+    float base() const { return base_; }
+    bool aprendendo() const { return aprender_; }
+    unsigned long blocos() const { return blocos_; }
+
+private:
+    void atualizar(float x, float saida) {
+        // P·φ com φ = (x, 1)
+        float pf0 = p00_ * x + p01_;
+        float pf1 = p01_ * x + p11_;
+        float denominador = ESQUECIMENTO + x * pf0 + pf1;
+        float k0 = pf0 / denominador;
+        float k1 = pf1 / denominador;
+
+        float erro = saida - (ganho_ * x + base_);
+        ganho_ += k0 * erro;
+        base_ += k1 * erro;
+
+        p00_ = (p00_ - k0 * pf0) / ESQUECIMENTO;
+        p01_ = (p01_ - k0 * pf1) / ESQUECIMENTO;
+        p11_ = (p11_ - k1 * pf1) / ESQUECIMENTO;
+
+        // Com o dissipador parado a direção do ganho não recebe informação e
+        // o esquecimento faria a covariância crescer sem limite
+        float traco = p00_ + p11_;
+        if (traco > COVARIANCIA_MAXIMA) {
+            float escala = COVARIANCIA_MAXIMA / traco;
+            p00_ *= escala;
+            p01_ *= escala;
+            p11_ *= escala;
+        }
+        blocos_++;
+    }
+
+    float ganho_, base_;
+    bool aprender_;
+    float p00_, p01_, p11_;     // Covariância simétrica 2x2
+    unsigned long blocos_;
+    float soma_x_, soma_saida_, duracao_s_;
+};
+
+#endif
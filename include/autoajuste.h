@@ -0,0 +1,71 @@
+#ifndef AUTOAJUSTE_H
+#define AUTOAJUSTE_H
+
+#include <stdint.h>
+
+// Autoajuste por realimentação a relé (Åström–Hägglund): a saída alterna
+// entre máxima e zero em torno do alvo, com histerese, até a temperatura
+// oscilar de forma regular. Da amplitude e do período da oscilação saem o
+// ganho e o período últimos (Ku, Pu), e deles os ganhos do PID.
+enum FaseAutoajuste : uint8_t {
+    AUTOAJUSTE_OCIOSO = 0,
+    AUTOAJUSTE_EM_ANDAMENTO,
+    AUTOAJUSTE_CONCLUIDO,
+    AUTOAJUSTE_FALHOU,
+    AUTOAJUSTE_CANCELADO
+};
+
+enum RegraAutoajuste : uint8_t {
+    REGRA_ZIEGLER_NICHOLS = 0,      // Resposta rápida, mais sobressinal
+    REGRA_TYREUS_LUYBEN             // Mais conservadora, menos oscilação
+};
+
+// POD, vai no snapshot do controlador
+struct ResultadoAutoajuste {
+    uint8_t fase;           // FaseAutoajuste
+    uint8_t regra;          // RegraAutoajuste
+    uint8_t ciclos;         // Ciclos completos medidos até agora
+    float ku;               // PWM/°C
+    float pu_s;
+    float kp, ki, kd;
+};
+
+const char *nome_fase_autoajuste(FaseAutoajuste fase);
+
+class AutoajusteRele {
+public:
+    static const uint8_t CICLOS_DESCARTADOS = 1;    // O primeiro ciclo ainda é transitório
+    static const uint8_t CICLOS_MEDIDOS = 4;
+    static const unsigned long DURACAO_MAXIMA_MS = 90UL * 60 * 1000;
+
+    AutoajusteRele();
+
+    void iniciar(float alvo, float histerese, RegraAutoajuste regra, int saida_maxima);
+    void cancelar();
+    bool em_andamento() const { return resultado_.fase == AUTOAJUSTE_EM_ANDAMENTO; }
+
+    // Uma amostra do experimento; retorna o PWM do relé
+    int passo(float temperatura, unsigned long agora);
+
+    const ResultadoAutoajuste &resultado() const { return resultado_; }
+
+private:
+    void concluir();
+
+    float alvo_, histerese_;
+    int saida_maxima_;
+    bool primeira_amostra_;
+    unsigned long inicio_ms_;
+
+    bool resfriando_;               // Saída atual do relé
+    float pico_, vale_;             // Extremos do ciclo em andamento
+    bool tem_virada_;
+    unsigned long ultima_virada_ms_; // Última virada para resfriando: início do ciclo
+    uint8_t ciclos_vistos_;
+    float soma_amplitudes_;
+    float soma_periodos_s_;
+
+    ResultadoAutoajuste resultado_;
+};
+
+#endif
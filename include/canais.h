@@ -0,0 +1,18 @@
+#ifndef CANAIS_H
+#define CANAIS_H
+
+#include <DallasTemperature.h>
+
+// Cada canal é uma malha de controle independente: um DS18B20 no barramento
+// compartilhado e uma saída PWM (um canal ledc) com sua pastilha Peltier.
+// Um segundo DS18B20 opcional, no dissipador (lado quente), alimenta a ação
+// antecipatória do controlador (ver antecipacao.h).
+const size_t MAXIMO_CANAIS = 4;
+
+struct ConfiguracaoCanal {
+    uint8_t pino_pwm;
+    DeviceAddress sensor;   // ROM do DS18B20; zerado = o n-ésimo sensor encontrado
+    DeviceAddress sensor_quente;    // ROM do sensor do dissipador; zerado = sem ele
+};
+
+#endif
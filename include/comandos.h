@@ -0,0 +1,36 @@
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+#include <Arduino.h>
+
+// Comandos vindos da rede (HTTP, WebSocket), aplicados pela tarefa de
+// controle no início do ciclo. Quem envia nunca toca no estado do controlador.
+enum TipoComando : uint8_t {
+    CMD_DEFINIR_ALVO,
+    CMD_ALTERNAR,
+    CMD_RESETAR_LIMITE,
+    CMD_DEFINIR_PID,
+    CMD_RESETAR_TEMPORIZACAO,
+    CMD_AUTOAJUSTAR,            // valores: regra, histerese (°C, 0 = padrão)
+    CMD_CANCELAR_AUTOAJUSTE,
+    CMD_DEFINIR_FILTRO,         // valores: TipoFiltro, mediana (0/1), parâmetro
+    CMD_DEFINIR_ESTRUTURA_PID,  // valores: b, c, n (ver nucleo_pid.h)
+    CMD_DEFINIR_ANTECIPACAO     // valores: ganho, base, aprender (0/1) (ver antecipacao.h)
+};
+
+struct Comando {
+    TipoComando tipo;
+    float valores[3];
+    uint8_t canal;              // Malha de destino (ver canais.h)
+};
+
+void iniciar_fila_comandos();
+
+// Não bloqueia: retorna false se a fila estiver cheia
+bool enviar_comando(TipoComando tipo, float v0 = 0, float v1 = 0, float v2 = 0, uint8_t canal = 0);
+bool enviar_comando(const Comando &comando);
+
+// Usado só pela tarefa de controle
+bool receber_comando(Comando &comando);
+
+#endif
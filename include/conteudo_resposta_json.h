@@ -0,0 +1,61 @@
+#ifndef CONTEUDO_RESPOSTA_JSON_H
+#define CONTEUDO_RESPOSTA_JSON_H
+
+#include <stdio.h>
+#include <string.h>
+#include "interpretador.h"
+
+// Cabeçalho HTTP e corpo JSON de uma RespostaJson (resposta_json.h), em
+// buffers fixos. Fica separado do servidor web para compilar no ambiente
+// nativo: a ferramenta alocacoes mede com ele o mesmo caminho de /dados.
+class ConteudoRespostaJson {
+public:
+    static const size_t CAPACIDADE = TAMANHO_JSON_SNAPSHOT;
+    static const size_t CAPACIDADE_CABECALHO = 256;
+    static const size_t RESPOSTAS_SIMULTANEAS = 4;     // Blocos do pool; acima disso cai no heap
+
+    ConteudoRespostaJson() : tamanho_(0), tamanho_cabecalho_(0) {}
+
+    size_t serializar_snapshot(const SnapshotControlador &snapshot, ArduinoJson::Allocator &alocador) {
+        tamanho_ = serializar_snapshot_json(snapshot, json_, CAPACIDADE, alocador);
+        return tamanho_;
+    }
+
+    // Linha de status e cabeçalhos fixos; os extras entram enquanto couberem
+    // e fechar_cabecalho põe a linha vazia
+    void iniciar_cabecalho(uint8_t versao, int codigo, const char *razao) {
+        int tamanho = snprintf(cabecalho_, sizeof(cabecalho_),
+                               "HTTP/1.%u %d %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+                               "Connection: close\r\n%s",
+                               versao, codigo, razao, (unsigned)tamanho_, versao ? "Accept-Ranges: none\r\n" : "");
+        tamanho_cabecalho_ = tamanho > 0 ? (size_t)tamanho : 0;
+    }
+
+    bool acrescentar_cabecalho(const char *nome, const char *valor) {
+        size_t linha = strlen(nome) + strlen(valor) + 4;
+        if (tamanho_cabecalho_ + linha + 2 >= sizeof(cabecalho_)) {
+            return false;
+        }
+        tamanho_cabecalho_ += snprintf(cabecalho_ + tamanho_cabecalho_, sizeof(cabecalho_) - tamanho_cabecalho_,
+                                       "%s: %s\r\n", nome, valor);
+        return true;
+    }
+
+    void fechar_cabecalho() {
+        memcpy(cabecalho_ + tamanho_cabecalho_, "\r\n", 2);
+        tamanho_cabecalho_ += 2;
+    }
+
+    const char *cabecalho() const { return cabecalho_; }
+    size_t tamanho_cabecalho() const { return tamanho_cabecalho_; }
+    const char *json() const { return json_; }
+    size_t tamanho() const { return tamanho_; }
+
+private:
+    char cabecalho_[CAPACIDADE_CABECALHO];
+    char json_[CAPACIDADE];
+    size_t tamanho_;
+    size_t tamanho_cabecalho_;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef CONTROLADOR_H
+#define CONTROLADOR_H
+
+#include "antecipacao.h"
+#include "autoajuste.h"
+#include "comandos.h"
+#include "estado_controlador.h"
+#include "filtros.h"
+#include "nucleo_pid.h"
+#include "snapshot_controlador.h"
+
+// Configurações de temperatura e controle
+const float ALVO_INICIAL = 4.0;
+const float ALVO_MINIMO = -40.0;            // Faixa aceita nos comandos (dentro da do DS18B20)
+const float ALVO_MAXIMO = 85.0;
+const float BANDA_MORTA = 0.2;              // Banda morta para evitar oscilação
+const float LIMITE_INICIAL = 2.0;           // Threshold para sair do resfriamento inicial
+const float TEMPERATURA_MINIMA_VALIDA = -50; // Abaixo disso a leitura é erro do sensor
+const float HISTERESE_AUTOAJUSTE = 0.2;     // °C em torno do alvo no experimento de relé
+const int PWM_MAXIMO = 255;
+const int PWM_MINIMO = 0;
+
+// Parâmetros PID
+const float KP_INICIAL = 30.0;
+const float KI_INICIAL = 0.1;
+const float KD_INICIAL = 10.0;
+const float INTEGRAL_MAXIMO = 100.0;        // Limite do integrador
+const float PESO_ALVO_P_INICIAL = 1.0;      // b: peso do alvo no termo P
+const float PESO_ALVO_D_INICIAL = 1.0;      // c: 1 = derivada do erro, 0 = da medida
+const float FILTRO_DERIVADA_INICIAL = 0;    // n: Tf = Td/n; 0 = derivada sem filtro
+const unsigned long TIMEOUT_LIMITE_MS = 30000; // 30s para detectar setpoint inatingível
+
+// Ação antecipatória pelo lado quente (ver antecipacao.h e a ferramenta
+// "antecipacao"): só atua nos canais com sensor no dissipador, e parte de
+// zero aprendendo com as amostras acomodadas
+const float GANHO_ANTECIPACAO_INICIAL = 0;     // PWM por °C de (quente - alvo)
+const float BASE_ANTECIPACAO_INICIAL = 0;      // PWM
+const bool APRENDER_ANTECIPACAO_INICIAL = true;
+const float FAIXA_APRENDIZADO_ANTECIPACAO = 0.5; // °C do alvo em que a malha conta como acomodada
+
+// Filtro da leitura (ver filtros.h e a ferramenta "filtros"): a média de 3
+// de sempre, agora precedida da mediana de 3 contra picos
+const TipoFiltro FILTRO_INICIAL = FILTRO_MEDIA_MOVEL;
+const bool MEDIANA_INICIAL = true;
+
+// Resolução do DS18B20 pedida pelo controlador (ver resolucao_desejada())
+const uint8_t RESOLUCAO_RAPIDA = 9;         // 0.5°C, conversão de 94 ms
+const uint8_t RESOLUCAO_PADRAO = 11;        // 0.125°C, 375 ms
+const uint8_t RESOLUCAO_FINA = 12;          // 0.0625°C, 750 ms
+const float ERRO_RESOLUCAO_RAPIDA = 2.0;    // °C do alvo a partir dos quais vale amostrar rápido
+const float HISTERESE_RESOLUCAO = 0.3;     // °C além dos limites acima antes de voltar atrás
+
+// Controle da pastilha Peltier: filtro da leitura, resfriamento inicial em
+// potência máxima, PID com banda morta e detecção de setpoint inatingível.
+// Não acessa hardware: recebe a leitura do sensor e devolve o PWM, então
+// roda igual no ESP32 e no ambiente nativo. Pertence à tarefa de controle.
+class Controlador {
+public:
+    explicit Controlador(float dt);
+
+    void resetar();
+    void aplicar_comando(const Comando &comando);
+
+    // Processa uma leitura do sensor e devolve o PWM (0 a PWM_MAXIMO). A
+    // saída contínua, antes do truncamento, fica em saida() para o driver
+    // de PWM de alta resolução (ver saida_pwm.h). `quente` é a leitura do
+    // lado quente; sem ela (NAN ou erro do sensor) não há ação antecipatória.
+    int processar_leitura(float temperatura, unsigned long agora, float quente = NAN);
+
+    // Período até a próxima leitura; o escalonador muda junto com a resolução
+    void definir_periodo(float dt) {
+        periodo_s_ = dt;
+        pid_.definir_dt(dt);
+        filtro_.definir_periodo(dt);
+    }
+
+    // Longe do alvo importa reagir rápido e a quantização de 0.5°C não pesa;
+    // na banda morta importa enxergar décimos, então vale esperar a conversão.
+    // Com histerese: cada troca regrava a configuração de todos os sensores,
+    // e a temperatura oscilando na borda da banda morta não pode alternar.
+    uint8_t resolucao_desejada() const { return resolucao_; }
+
+    const FiltroTemperatura &filtro() const { return filtro_; }
+    const Antecipacao &antecipacao() const { return antecipacao_; }
+
+    // Preenche tudo menos ciclo, tempo_ms, canal e dados da amostragem
+    void preencher_snapshot(SnapshotControlador &snapshot) const;
+
+    bool ligado() const { return ligado_; }
+    float alvo() const { return alvo_; }
+    float temperatura() const { return temperatura_; }
+    bool recebeu_leitura() const { return recebeu_leitura_; }   // Antes da primeira, temperatura() é 0
+    float temperatura_quente() const { return temperatura_quente_; }
+    float saida() const { return saida_; }
+    int pwm() const { return pwm_; }
+    EstadoControlador estado() const { return estado_; }
+
+private:
+    void iniciar_resfriamento();
+    void definir_estado(EstadoControlador novo_estado);
+    float calcular_pid(float temperatura, unsigned long agora);
+    float executar_autoajuste(float temperatura, unsigned long agora);
+    void cancelar_autoajuste(const char *motivo);
+    void atualizar_resolucao();
+
+    float alvo_;
+    float kp_, ki_, kd_;
+
+    NucleoPID<NumeroPID> pid_;
+    unsigned long tempo_no_maximo_;
+    bool resfriamento_inicial_;
+    bool limite_atingido_;
+    float termo_p_, termo_i_, termo_d_;   // Últimos termos do PID, para telemetria
+    float termo_ff_;                      // Parcela antecipatória já somada à saída
+    Antecipacao antecipacao_;
+    AutoajusteRele autoajuste_;
+
+    bool ligado_;
+    float periodo_s_;
+    float temperatura_;
+    bool recebeu_leitura_;
+    float temperatura_quente_;
+    float saida_;       // Em unidades de PWM, com fração
+    int pwm_;
+    EstadoControlador estado_;
+    uint8_t resolucao_;
+    FiltroTemperatura filtro_;
+};
+
+#endif
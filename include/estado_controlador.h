@@ -0,0 +1,34 @@
+#ifndef ESTADO_CONTROLADOR_H
+#define ESTADO_CONTROLADOR_H
+
+#include <stdint.h>
+
+// Estados do controlador. O valor numérico é enviado no JSON e usado pela
+// página como índice, então a ordem não deve mudar.
+enum EstadoControlador : uint8_t {
+    ESTADO_DESLIGADO = 0,
+    ESTADO_RESFRIAMENTO_INICIAL,
+    ESTADO_CONTROLE_PID,
+    ESTADO_BANDA_MORTA,
+    ESTADO_LIMITE_ATINGIDO,
+    ESTADO_ERRO_SENSOR,
+    ESTADO_SEM_RESFRIAMENTO,
+    ESTADO_AUTOAJUSTE,
+    NUM_ESTADOS
+};
+
+inline const char *nome_estado(EstadoControlador estado) {
+    static constexpr const char *NOMES[NUM_ESTADOS] = {
+        "DESLIGADO",
+        "RESFR. INICIAL",
+        "CONTROLE PID",
+        "ESTÁVEL (DEADBAND)",
+        "LIMITE ATINGIDO",
+        "ERRO SENSOR",
+        "SEM RESFRIAMENTO",
+        "AUTOAJUSTE"
+    };
+    return estado < NUM_ESTADOS ? NOMES[estado] : "DESCONHECIDO";
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef ESTATISTICAS_PERIODO_H
+#define ESTATISTICAS_PERIODO_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Estatísticas do período real da tarefa de controle (mínimo, máximo e
+// percentis). Um único escritor (a tarefa de controle) e qualquer número de
+// leitores; os contadores são atômicos, então a leitura nunca bloqueia.
+class EstatisticasPeriodo {
+public:
+    static const uint32_t LARGURA_FAIXA_US = 50;
+    static const size_t NUM_FAIXAS = 128;   // Janela de ±3,2 ms em torno do nominal
+
+    explicit EstatisticasPeriodo(uint32_t periodo_nominal_us);
+
+    void registrar(uint32_t periodo_us);
+    void zerar();
+
+    uint32_t periodo_nominal_us() const { return periodo_nominal_us_; }
+    uint32_t amostras() const { return amostras_.load(std::memory_order_relaxed); }
+    uint32_t minimo_us() const { return minimo_us_.load(std::memory_order_relaxed); }
+    uint32_t maximo_us() const { return maximo_us_.load(std::memory_order_relaxed); }
+
+    // Limite superior da faixa que contém o percentil pedido (0 a 100)
+    uint32_t percentil_us(float percentil) const;
+
+private:
+    uint32_t inicio_janela_us() const;
+
+    const uint32_t periodo_nominal_us_;
+    std::atomic<uint32_t> amostras_{0};
+    std::atomic<uint32_t> minimo_us_{UINT32_MAX};
+    std::atomic<uint32_t> maximo_us_{0};
+    std::atomic<uint32_t> faixas_[NUM_FAIXAS];
+};
+
+#endif
@@ -0,0 +1,314 @@
+#ifndef FILTROS_H
+#define FILTROS_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Filtros da leitura de temperatura. Todos custam O(1) por amostra (a
+// mediana ordena N fixo e pequeno) e não alocam memória. O aquecimento é
+// feito com a própria primeira amostra: nada parte de zero, então a saída
+// já começa na temperatura medida.
+
+// Média móvel de N amostras com soma corrente. Enquanto o buffer não enche,
+// a média é só das amostras recebidas.
+template <size_t N>
+class MediaMovel {
+public:
+    MediaMovel() { reiniciar(); }
+
+    void reiniciar() {
+        posicao_ = 0;
+        quantidade_ = 0;
+        soma_ = 0;
+    }
+
+    float filtrar(float amostra) {
+        if (quantidade_ == N) {
+            soma_ -= amostras_[posicao_];
+        } else {
+            quantidade_++;
+        }
+        amostras_[posicao_] = amostra;
+        posicao_ = (posicao_ + 1) % N;
+        soma_ += amostra;
+        return soma_ / quantidade_;
+    }
+
+private:
+    float amostras_[N];
+    size_t posicao_;
+    size_t quantidade_;
+    float soma_;
+};
+
+// Mediana das últimas N amostras (N ímpar): descarta picos isolados, como o
+// 85°C que o DS18B20 devolve quando perde a alimentação no meio da conversão
+template <size_t N>
+class Mediana {
+public:
+    static_assert(N % 2 == 1, "A mediana precisa de uma janela ímpar");
+
+    Mediana() { reiniciar(); }
+
+    void reiniciar() {
+        posicao_ = 0;
+        quantidade_ = 0;
+    }
+
+    float filtrar(float amostra) {
+        amostras_[posicao_] = amostra;
+        posicao_ = (posicao_ + 1) % N;
+        if (quantidade_ < N) {
+            quantidade_++;
+        }
+
+        // Ordenação por inserção de uma cópia: N é pequeno
+        float ordenadas[N];
+        for (size_t i = 0; i < quantidade_; i++) {
+            float valor = amostras_[i];
+            size_t j = i;
+            while (j > 0 && ordenadas[j - 1] > valor) {
+                ordenadas[j] = ordenadas[j - 1];
+                j--;
+            }
+            ordenadas[j] = valor;
+        }
+        return ordenadas[quantidade_ / 2];
+    }
+
+private:
+    float amostras_[N];
+    size_t posicao_;
+    size_t quantidade_;
+};
+
+// Média exponencial com constante de tempo em segundos; o coeficiente
+// acompanha o período de amostragem
+class MediaExponencial {
+public:
+    MediaExponencial(float constante_s, float dt) : constante_s_(constante_s), dt_(dt) {
+        calcular_alfa();
+        reiniciar();
+    }
+
+    void definir_constante(float constante_s) {
+        constante_s_ = constante_s;
+        calcular_alfa();
+    }
+
+    void definir_periodo(float dt) {
+        dt_ = dt;
+        calcular_alfa();
+    }
+
+    void reiniciar() { iniciado_ = false; }
+
+    float filtrar(float amostra) {
+        if (!iniciado_) {
+            saida_ = amostra;
+            iniciado_ = true;
+        } else {
+            saida_ += alfa_ * (amostra - saida_);
+        }
+        return saida_;
+    }
+
+private:
+    void calcular_alfa() { alfa_ = dt_ / (constante_s_ + dt_); }
+
+    float constante_s_, dt_, alfa_;
+    float saida_;
+    bool iniciado_;
+};
+
+// Passa-baixas Butterworth de segunda ordem (biquad, forma direta I) com
+// corte em Hz. Os coeficientes só são recalculados quando o período muda;
+// o corte é limitado abaixo de Nyquist.
+class PassaBaixasBiquad {
+public:
+    PassaBaixasBiquad(float corte_hz, float dt) : corte_hz_(corte_hz), dt_(dt) {
+        calcular_coeficientes();
+        reiniciar();
+    }
+
+    void definir_corte(float corte_hz) {
+        corte_hz_ = corte_hz;
+        calcular_coeficientes();
+    }
+
+    void definir_periodo(float dt) {
+        dt_ = dt;
+        calcular_coeficientes();
+    }
+
+    void reiniciar() { iniciado_ = false; }
+
+    float filtrar(float amostra) {
+        if (!iniciado_) {
+            // Estado de regime para a primeira amostra: ganho DC é 1
+            x1_ = x2_ = y1_ = y2_ = amostra;
+            iniciado_ = true;
+        }
+        float y = b0_ * amostra + b1_ * x1_ + b2_ * x2_ - a1_ * y1_ - a2_ * y2_;
+        x2_ = x1_;
+        x1_ = amostra;
+        y2_ = y1_;
+        y1_ = y;
+        return y;
+    }
+
+private:
+    void calcular_coeficientes() {
+        float corte = fminf(corte_hz_, 0.45f / dt_);
+        float k = tanf((float)M_PI * corte * dt_);
+        float norma = 1 / (1 + (float)M_SQRT2 * k + k * k);
+        b0_ = k * k * norma;
+        b1_ = 2 * b0_;
+        b2_ = b0_;
+        a1_ = 2 * (k * k - 1) * norma;
+        a2_ = (1 - (float)M_SQRT2 * k + k * k) * norma;
+    }
+
+    float corte_hz_, dt_;
+    float b0_, b1_, b2_, a1_, a2_;
+    float x1_, x2_, y1_, y2_;
+    bool iniciado_;
+};
+
+// Kalman escalar com modelo de passeio aleatório: a temperatura muda com
+// variância q (°C²/s) e o sensor mede com variância r (°C²). Quanto maior
+// q, mais o filtro confia na leitura nova.
+class KalmanEscalar {
+public:
+    KalmanEscalar(float q, float r, float dt) : q_(q), r_(r), dt_(dt) { reiniciar(); }
+
+    void definir_ruido_processo(float q) { q_ = q; }
+    void definir_periodo(float dt) { dt_ = dt; }
+    void reiniciar() { iniciado_ = false; }
+
+    float filtrar(float amostra) {
+        if (!iniciado_) {
+            estimativa_ = amostra;
+            variancia_ = r_;
+            iniciado_ = true;
+            return estimativa_;
+        }
+        variancia_ += q_ * dt_;
+        float ganho = variancia_ / (variancia_ + r_);
+        estimativa_ += ganho * (amostra - estimativa_);
+        variancia_ *= 1 - ganho;
+        return estimativa_;
+    }
+
+private:
+    float q_, r_, dt_;
+    float estimativa_, variancia_;
+    bool iniciado_;
+};
+
+const float VARIANCIA_SENSOR_KALMAN = 0.01;  // r do Kalman: ~0.1°C de desvio
+
+// Estágio de suavização do pipeline. O valor é enviado em /definirFiltro e
+// no JSON, então a ordem não deve mudar.
+enum TipoFiltro : uint8_t {
+    FILTRO_NENHUM = 0,
+    FILTRO_MEDIA_MOVEL,         // 3 amostras; parâmetro ignorado
+    FILTRO_EXPONENCIAL,         // parâmetro: constante de tempo (s)
+    FILTRO_BIQUAD,              // parâmetro: frequência de corte (Hz)
+    FILTRO_KALMAN,              // parâmetro: ruído de processo q (°C²/s)
+    NUM_TIPOS_FILTRO
+};
+
+inline const char *nome_filtro(TipoFiltro tipo) {
+    static constexpr const char *NOMES[NUM_TIPOS_FILTRO] = {
+        "nenhum", "media", "exponencial", "biquad", "kalman"
+    };
+    return tipo < NUM_TIPOS_FILTRO ? NOMES[tipo] : "?";
+}
+
+// Parâmetro usado quando /definirFiltro não informa um
+inline float parametro_padrao_filtro(TipoFiltro tipo) {
+    switch (tipo) {
+        case FILTRO_EXPONENCIAL: return 1.0f;   // s
+        case FILTRO_BIQUAD: return 0.2f;        // Hz
+        case FILTRO_KALMAN: return 0.01f;       // °C²/s
+        default: return 1.0f;
+    }
+}
+
+// Pipeline da leitura: mediana de 3 opcional contra picos, seguida de um
+// estágio de suavização escolhido em tempo de execução. Todos os estágios
+// ficam instanciados (são poucos bytes) para trocar sem alocar.
+class FiltroTemperatura {
+public:
+    FiltroTemperatura(TipoFiltro tipo, bool mediana, float parametro, float dt)
+        : exponencial_(parametro_padrao_filtro(FILTRO_EXPONENCIAL), dt),
+          biquad_(parametro_padrao_filtro(FILTRO_BIQUAD), dt),
+          kalman_(parametro_padrao_filtro(FILTRO_KALMAN), VARIANCIA_SENSOR_KALMAN, dt) {
+        configurar(tipo, mediana, parametro);
+    }
+
+    // Retorna false (sem mudar nada) se o tipo ou o parâmetro não servem
+    bool configurar(TipoFiltro tipo, bool mediana, float parametro) {
+        if (tipo >= NUM_TIPOS_FILTRO || !(parametro > 0)) {
+            return false;
+        }
+        tipo_ = tipo;
+        usar_mediana_ = mediana;
+        parametro_ = parametro;
+        switch (tipo) {
+            case FILTRO_EXPONENCIAL: exponencial_.definir_constante(parametro); break;
+            case FILTRO_BIQUAD: biquad_.definir_corte(parametro); break;
+            case FILTRO_KALMAN: kalman_.definir_ruido_processo(parametro); break;
+            default: break;
+        }
+        reiniciar();
+        return true;
+    }
+
+    void definir_periodo(float dt) {
+        exponencial_.definir_periodo(dt);
+        biquad_.definir_periodo(dt);
+        kalman_.definir_periodo(dt);
+    }
+
+    // Descarta o histórico: a próxima amostra volta a ser o ponto de partida
+    void reiniciar() {
+        mediana_.reiniciar();
+        media_.reiniciar();
+        exponencial_.reiniciar();
+        biquad_.reiniciar();
+        kalman_.reiniciar();
+    }
+
+    float filtrar(float amostra) {
+        if (usar_mediana_) {
+            amostra = mediana_.filtrar(amostra);
+        }
+        switch (tipo_) {
+            case FILTRO_MEDIA_MOVEL: return media_.filtrar(amostra);
+            case FILTRO_EXPONENCIAL: return exponencial_.filtrar(amostra);
+            case FILTRO_BIQUAD: return biquad_.filtrar(amostra);
+            case FILTRO_KALMAN: return kalman_.filtrar(amostra);
+            default: return amostra;
+        }
+    }
+
+    TipoFiltro tipo() const { return tipo_; }
+    bool mediana() const { return usar_mediana_; }
+    float parametro() const { return parametro_; }
+
+private:
+    TipoFiltro tipo_;
+    bool usar_mediana_;
+    float parametro_;
+
+    Mediana<3> mediana_;
+    MediaMovel<3> media_;
+    MediaExponencial exponencial_;
+    PassaBaixasBiquad biquad_;
+    KalmanEscalar kalman_;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef FORMATO_REGISTRO_H
+#define FORMATO_REGISTRO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "historico.h"
+
+// Formato dos segmentos do registro persistente (/log/sNNNNN.bin):
+//
+//   CabecalhoSegmento
+//   CabecalhoBloco + AmostraBruta[quantidade]
+//   CabecalhoBloco + AmostraBruta[quantidade]
+//   ...
+//
+// Blocos só são acrescentados ao final do segmento e cada um tem seu próprio
+// CRC: um bloco cortado por falta de energia é reconhecido e a leitura para
+// ali. Todos os campos são little-endian.
+
+const uint32_t ASSINATURA_SEGMENTO = 0x474C4D54;   // "TMLG"
+const uint32_t ASSINATURA_INDICE = 0x58494D54;     // "TMIX"
+const uint16_t VERSAO_REGISTRO = 1;
+const uint16_t MARCADOR_BLOCO = 0xB10C;
+
+struct __attribute__((packed)) CabecalhoSegmento {
+    uint32_t assinatura;
+    uint16_t versao;
+    uint16_t periodo_ms;        // Intervalo entre amostras consecutivas
+    uint32_t boot;              // O tempo recomeça a cada boot
+    uint32_t tempo_inicial_ms;  // Tempo da amostra de índice 0 neste boot
+    uint32_t crc;
+};
+
+struct __attribute__((packed)) CabecalhoBloco {
+    uint16_t marcador;
+    uint16_t quantidade;
+    uint32_t indice_inicial;    // Índice da primeira amostra desde o boot
+    uint32_t crc;               // Campos acima + amostras
+};
+
+// Índice compacto (/log/indice.bin): CabecalhoIndice + EntradaIndice[quantidade]
+struct __attribute__((packed)) CabecalhoIndice {
+    uint32_t assinatura;
+    uint16_t versao;
+    uint16_t quantidade;
+    uint32_t crc;               // Só das entradas
+};
+
+struct __attribute__((packed)) EntradaIndice {
+    uint32_t segmento;
+    uint32_t boot;
+    uint32_t tempo_inicial_ms;
+    uint32_t indice_inicial;
+    uint32_t amostras;
+};
+
+static_assert(sizeof(AmostraBruta) == 4, "AmostraBruta é gravada direto na flash");
+static_assert(sizeof(CabecalhoSegmento) == 20, "Layout do segmento mudou");
+static_assert(sizeof(CabecalhoBloco) == 12, "Layout do bloco mudou");
+
+// CRC-32 (IEEE 802.3), encadeável
+uint32_t calcular_crc32(const void *dados, size_t tamanho, uint32_t crc = 0);
+
+void selar_segmento(CabecalhoSegmento &cabecalho);
+bool segmento_valido(const CabecalhoSegmento &cabecalho);
+
+void selar_bloco(CabecalhoBloco &cabecalho, const AmostraBruta *amostras);
+bool bloco_valido(const CabecalhoBloco &cabecalho, const AmostraBruta *amostras);
+
+// O que sobrou de íntegro em um segmento
+struct ContagemSegmento {
+    uint32_t indice_inicial;    // Índice da primeira amostra (0 sem blocos)
+    uint32_t amostras;
+};
+
+// Lê um segmento do início e conta os blocos até o fim do arquivo ou até o
+// primeiro bloco cortado; false se nem o cabeçalho do segmento está íntegro.
+// `Arquivo` só precisa de read(uint8_t *, size_t), como fs::File (nos testes,
+// um buffer em memória); `lote` cabe `maximo_por_bloco` amostras.
+template <typename Arquivo>
+bool varrer_segmento(Arquivo &arquivo, CabecalhoSegmento &cabecalho, AmostraBruta *lote,
+                     uint16_t maximo_por_bloco, ContagemSegmento &contagem) {
+    if (arquivo.read((uint8_t *)&cabecalho, sizeof(cabecalho)) != sizeof(cabecalho) || !segmento_valido(cabecalho)) {
+        return false;
+    }
+    contagem.indice_inicial = 0;
+    contagem.amostras = 0;
+
+    CabecalhoBloco bloco;
+    while (arquivo.read((uint8_t *)&bloco, sizeof(bloco)) == sizeof(bloco)) {
+        if (bloco.quantidade == 0 || bloco.quantidade > maximo_por_bloco) {
+            break;
+        }
+        size_t tamanho = bloco.quantidade * sizeof(AmostraBruta);
+        if (arquivo.read((uint8_t *)lote, tamanho) != tamanho || !bloco_valido(bloco, lote)) {
+            break;
+        }
+        if (contagem.amostras == 0) {
+            contagem.indice_inicial = bloco.indice_inicial;
+        }
+        contagem.amostras += bloco.quantidade;
+    }
+    return true;
+}
+
+#endif
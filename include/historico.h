@@ -0,0 +1,134 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Histórico em RAM, sem alocação dinâmica, em três resoluções:
+// bruto (um registro por ciclo), 10 s e 5 min (mínimo/máximo/média).
+// Escrito só pela tarefa de controle; lido sem bloqueio pelo servidor web.
+
+const int16_t SEM_LEITURA = INT16_MIN;     // Temperatura inválida (sensor ausente)
+
+struct AmostraBruta {
+    int16_t temperatura;    // Centésimos de °C
+    uint8_t pwm;
+    uint8_t estado;         // EstadoControlador
+};
+
+struct AmostraAgregada {
+    int16_t minimo;         // Centésimos de °C
+    int16_t maximo;
+    int16_t media;
+    uint8_t pwm_medio;
+    uint8_t estado;         // Último estado da janela
+};
+
+// Anel de capacidade fixa com um escritor. O contador `total` só avança
+// depois que a posição foi escrita, e o leitor descarta o que pode ter sido
+// sobrescrito enquanto copiava.
+template <typename T, size_t N>
+class AnelHistorico {
+public:
+    static const size_t CAPACIDADE = N;
+
+    void adicionar(const T &amostra) {
+        uint32_t indice = total_.load(std::memory_order_relaxed);
+        itens_[indice % N] = amostra;
+        total_.store(indice + 1, std::memory_order_release);
+    }
+
+    uint32_t total() const { return total_.load(std::memory_order_acquire); }
+
+    uint32_t mais_antigo() const {
+        uint32_t n = total();
+        return n > N ? n - N : 0;
+    }
+
+    // Copia o registro de índice global `indice`; false se já foi sobrescrito
+    bool ler(uint32_t indice, T &destino) const {
+        if (indice >= total() || indice < mais_antigo()) {
+            return false;
+        }
+        destino = itens_[indice % N];
+        return indice + N > total();
+    }
+
+private:
+    T itens_[N];
+    std::atomic<uint32_t> total_{0};
+};
+
+enum NivelHistorico : uint8_t {
+    NIVEL_BRUTO = 0,
+    NIVEL_10S,
+    NIVEL_5MIN,
+    NUM_NIVEIS
+};
+
+class Historico {
+public:
+    static const uint32_t PERIODO_10S_MS = 10000;
+    static const uint32_t PERIODO_5MIN_MS = 300000;
+
+    explicit Historico(uint32_t periodo_bruto_ms);
+
+    // Um registro por ciclo de controle
+    void registrar(uint32_t tempo_ms, float temperatura, int pwm, uint8_t estado);
+
+    uint32_t periodo_ms(NivelHistorico nivel) const;
+    uint32_t tempo_inicial_ms() const { return tempo_inicial_ms_.load(std::memory_order_acquire); }
+
+    // Faixa [primeiro, fim) de índices do nível cobrindo o intervalo pedido
+    void faixa(NivelHistorico nivel, uint32_t de_ms, uint32_t ate_ms, uint32_t &primeiro, uint32_t &fim) const;
+
+    const AnelHistorico<AmostraBruta, 1200> &bruto() const { return bruto_; }       // 10 min
+    const AnelHistorico<AmostraAgregada, 1080> &nivel_10s() const { return n10s_; } // 3 h
+    const AnelHistorico<AmostraAgregada, 576> &nivel_5min() const { return n5min_; } // 48 h
+
+private:
+    struct Acumulador {
+        int16_t minimo;
+        int16_t maximo;
+        int32_t soma;
+        uint32_t soma_pwm;
+        uint16_t validas;
+        uint16_t amostras;
+        uint8_t estado;
+
+        void zerar();
+        void somar(int16_t min, int16_t max, int16_t media, uint8_t pwm, uint8_t estado);
+        AmostraAgregada resultado() const;
+    };
+
+    const uint32_t periodo_bruto_ms_;
+    const uint16_t brutos_por_10s_;
+    std::atomic<uint32_t> tempo_inicial_ms_{0};
+
+    AnelHistorico<AmostraBruta, 1200> bruto_;
+    AnelHistorico<AmostraAgregada, 1080> n10s_;
+    AnelHistorico<AmostraAgregada, 576> n5min_;
+    Acumulador acc_10s_;
+    Acumulador acc_5min_;
+};
+
+// Leitura incremental do histórico em CSV, para respostas em blocos: cada
+// chamada escreve só linhas completas e nada é montado inteiro na memória.
+struct CursorHistorico {
+    const Historico *historico;
+    NivelHistorico nivel;
+    uint32_t proximo;
+    uint32_t fim;
+    bool cabecalho_enviado;
+
+    void iniciar(const Historico &origem, NivelHistorico nivel_pedido, uint32_t de_ms, uint32_t ate_ms);
+
+    // Retorna o número de bytes escritos. Pode ser 0 com linhas pendentes se
+    // a próxima não couber em `tamanho`: só terminou() diz que acabou.
+    size_t ler_csv(char *destino, size_t tamanho);
+
+    bool terminou() const { return cabecalho_enviado && proximo >= fim; }
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef INTERPRETADOR_H
+#define INTERPRETADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+#include "comandos.h"
+#include "snapshot_controlador.h"
+
+// Conversão entre o que trafega na rede e os tipos do controlador. Não
+// depende do servidor web, então compila também no ambiente nativo.
+
+// JSON de /dados e dos eventos SSE; retorna o tamanho escrito. O buffer de
+// TAMANHO_JSON_SNAPSHOT cabe o pior caso (todos os números com casas decimais).
+// Quem serializa a cada requisição ou ciclo passa o alocador da sua tarefa
+// (um AlocadorJson) para o documento não ir ao heap.
+const size_t TAMANHO_JSON_SNAPSHOT = 320;
+size_t serializar_snapshot_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho);
+size_t serializar_snapshot_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho,
+                                ArduinoJson::Allocator &alocador);
+
+// JSON de GET /filtro
+size_t serializar_filtro_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho);
+
+// JSON de GET /antecipacao
+size_t serializar_antecipacao_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho);
+
+// JSON de GET /autoajuste
+size_t serializar_autoajuste_json(const ResultadoAutoajuste &resultado, char *destino, size_t tamanho);
+
+// Corpo JSON de /definirAlvo ({"alvo":x}), /definirPID ({"kp":..,"ki":..,"kd":..})
+// /autoajuste ({"regra":"zn"|"tl","histerese":x}, ambos opcionais) e
+// /definirFiltro ({"filtro":"kalman","mediana":true,"parametro":x}; só o filtro é obrigatório),
+// /definirEstruturaPID ({"b":x,"c":x,"n":x}; b e c entre 0 e 1, n >= 0) e
+// /definirAntecipacao ({"ganho":x,"base":x,"aprender":true}; aprender é opcional).
+// Nos dois formatos, valores não finitos são recusados, o alvo fica entre
+// ALVO_MINIMO e ALVO_MAXIMO e os ganhos do PID não podem ser negativos.
+bool interpretar_comando_json(TipoComando tipo, const uint8_t *corpo, size_t tamanho, Comando &comando);
+
+// Quadro binário de comando do WebSocket (ver protocolo_ws.h)
+bool interpretar_quadro_comando(const uint8_t *dados, size_t tamanho, Comando &comando);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef LEITOR_DS18B20_H
+#define LEITOR_DS18B20_H
+
+#include <DallasTemperature.h>
+#include "canais.h"
+
+// Leitura não bloqueante dos DS18B20 de todos os canais.
+// A conversão é disparada em uma amostra e lida na amostra seguinte, de modo
+// que o loop nunca fica parado esperando os até 750 ms da conversão. Um único
+// requestTemperatures() converte todos os sensores do barramento ao mesmo
+// tempo, e cada um é lido pelo seu endereço ROM, sem busca no barramento.
+// A busca só se repete quando um canal está sem sensor ou uma leitura falha
+// (sensor trocado ou reconectado), no máximo a cada INTERVALO_BUSCA_MS.
+// A resolução vai só para o scratchpad (WRITE SCRATCHPAD direto no
+// barramento): o setResolution() da biblioteca também a copia para a EEPROM,
+// com 20 ms de espera por sensor, e a EEPROM tem vida útil limitada. Depois
+// de religar, os sensores voltam à da EEPROM até a primeira busca.
+class LeitorDS18B20 {
+public:
+    static const uint8_t MAXIMO_SENSORES = 8;
+    static const unsigned long INTERVALO_BUSCA_MS = 5000;
+
+    LeitorDS18B20(OneWire &barramento, DallasTemperature &sensores);
+
+    // Procura os sensores, configura a resolução (9 a 12 bits) e desliga a
+    // espera interna da biblioteca. Cada canal fica com o sensor configurado,
+    // se ele estiver no barramento, ou com o n-ésimo encontrado; o sensor do
+    // lado quente só pelo endereço, e nunca entra na distribuição automática.
+    void iniciar(uint8_t resolucao, const ConfiguracaoCanal *canais, size_t num_canais);
+
+    // Avança a máquina de estados. Retorna true quando há leituras novas em
+    // `temperaturas` (uma por canal; DEVICE_DISCONNECTED_C se o canal não tem
+    // sensor) e, se pedido, em `quentes` (lado quente de cada canal); a
+    // próxima conversão já sai disparada.
+    bool amostrar(unsigned long agora, float *temperaturas, float *quentes = NULL);
+
+    // Resolução das próximas conversões. Vale para todo o barramento e é
+    // aplicada no próximo disparo; a conversão em andamento não muda. Só os
+    // sensores com outra configuração são gravados.
+    void definir_resolucao(uint8_t resolucao) { resolucao_pendente_ = resolucao; }
+
+    // Resolução e tempo da conversão em andamento (o escalonador espera por ela)
+    uint8_t resolucao() const { return resolucao_; }
+    unsigned long tempo_conversao_ms() const { return tempo_conversao_ms_; }
+    // Resolução com que foram feitas as leituras da última amostra
+    uint8_t resolucao_leitura() const { return resolucao_leitura_; }
+
+    // Tempo de barramento da última amostra (leituras + disparo da conversão)
+    // e o máximo desde o último zerar_tempos()
+    uint32_t tempo_barramento_us() const { return tempo_barramento_us_; }
+    uint32_t tempo_barramento_max_us() const { return tempo_barramento_max_us_; }
+    // Duração da última busca de sensores e quantas já foram feitas
+    uint32_t tempo_busca_us() const { return tempo_busca_us_; }
+    uint32_t buscas() const { return buscas_; }
+    // Gravações de configuração feitas (uma por sensor que mudou)
+    uint32_t gravacoes_resolucao() const { return gravacoes_resolucao_; }
+    void zerar_tempos() { tempo_barramento_max_us_ = 0; }
+
+    uint8_t sensores_encontrados() const { return num_encontrados_; }
+    const uint8_t *endereco_encontrado(uint8_t indice) const { return encontrados_[indice]; }
+
+    // Endereço do sensor do canal, ou NULL se o canal ficou sem sensor
+    const uint8_t *endereco_canal(size_t canal) const;
+    // Endereço do sensor do lado quente, ou NULL se não há (ou não foi achado)
+    const uint8_t *endereco_quente(size_t canal) const;
+
+private:
+    enum Estado : uint8_t {
+        OCIOSO,
+        CONVERTENDO
+    };
+
+    bool conversao_concluida(unsigned long agora);
+    void buscar_sensores(unsigned long agora);
+    int8_t procurar_endereco(const uint8_t *endereco, bool *usado) const;
+    bool precisa_busca(const float *temperaturas, const float *quentes) const;
+    void gravar_resolucao(uint8_t resolucao);
+
+    OneWire &barramento_;
+    DallasTemperature &sensores_;
+    Estado estado_ = OCIOSO;
+    unsigned long inicio_conversao_ = 0;
+    unsigned long tempo_conversao_ms_ = 750;
+    uint8_t resolucao_ = 12;
+    uint8_t resolucao_pendente_ = 12;
+    uint8_t resolucao_leitura_ = 12;
+
+    const ConfiguracaoCanal *canais_ = NULL;
+    unsigned long ultima_busca_ = 0;
+    uint32_t tempo_busca_us_ = 0;
+    uint32_t buscas_ = 0;
+    uint32_t gravacoes_resolucao_ = 0;
+    uint32_t tempo_barramento_us_ = 0;
+    uint32_t tempo_barramento_max_us_ = 0;
+
+    DeviceAddress encontrados_[MAXIMO_SENSORES];
+    uint8_t alarmes_[MAXIMO_SENSORES][2];       // TH e TL, regravados junto com a configuração
+    uint8_t configuracao_[MAXIMO_SENSORES];     // Byte de configuração no scratchpad; 0 = desconhecido
+    uint8_t num_encontrados_ = 0;
+    int8_t sensor_do_canal_[MAXIMO_CANAIS];     // Índice em encontrados_, -1 = sem sensor
+    int8_t sensor_quente_do_canal_[MAXIMO_CANAIS];
+    size_t num_canais_ = 0;
+};
+
+#endif
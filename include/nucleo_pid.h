@@ -0,0 +1,143 @@
+#ifndef NUCLEO_PID_H
+#define NUCLEO_PID_H
+
+#include "ponto_fixo.h"
+
+// Aritmética do PID, separada da máquina de estados do Controlador para
+// poder rodar em float ou em ponto fixo (N = float ou Q16). Os limites são
+// convertidos uma vez; dt, ganhos e coeficientes derivados, só quando mudam.
+// Por ciclo só há somas, multiplicações e comparações, sem divisão.
+//
+// Estrutura de dois graus de liberdade, com o sinal do controlador (erro =
+// medida - alvo, positivo pede resfriamento):
+//   P = kp * (medida - b * alvo)
+//   D = kd * d(medida - c * alvo)/dt, passando por um filtro de primeira
+//       ordem com constante Tf = (kd / kp) / n
+// b = c = 1 e n = 0 (sem filtro) é o PID clássico sobre o erro. c = 0 é a
+// derivada sobre a medida, que não dá pico quando o alvo muda. Um termo de
+// avanço (feed-forward) opcional entra na soma antes da saturação, então o
+// anti-windup enxerga a saída realmente aplicada.
+template <typename N>
+class NucleoPID {
+public:
+    NucleoPID(float dt, float saida_maxima, float integral_maxima)
+        : saida_maxima_(numero_de_float<N>(saida_maxima)),
+          integral_maxima_(numero_de_float<N>(integral_maxima)),
+          zero_(numero_de_float<N>(0)),
+          dt_s_(dt), kp_f_(0), kd_f_(0), ki_f_(0), b_f_(1), c_f_(1), n_f_(0) {
+        reiniciar();
+        recalcular();
+    }
+
+    // Intervalo até a próxima chamada de calcular()
+    void definir_dt(float dt) {
+        dt_s_ = dt;
+        recalcular();
+    }
+
+    void definir_ganhos(float kp, float ki, float kd) {
+        kp_f_ = kp;
+        ki_f_ = ki;
+        kd_f_ = kd;
+        recalcular();
+    }
+
+    // Pesos do alvo nos termos P (b) e D (c), entre 0 e 1, e fator n do
+    // filtro da derivada (0 desliga o filtro)
+    void definir_estrutura(float b, float c, float n) {
+        b_f_ = b;
+        c_f_ = c;
+        n_f_ = n;
+        recalcular();
+    }
+
+    void reiniciar() {
+        integral_ = zero_;
+        ultimo_valor_d_ = zero_;
+        termo_p_ = termo_i_ = termo_d_ = zero_;
+        primeira_ = true;
+    }
+
+    void zerar_integral() { integral_ = zero_; }
+
+    N calcular(N medida, N alvo) { return calcular(medida, alvo, zero_); }
+
+    // Saída limitada a [0, saida_maxima], com anti-windup condicional
+    N calcular(N medida, N alvo, N avanco) {
+        N erro = medida - alvo;
+        N valor_d = medida - c_ * alvo;
+
+        // Sem amostra anterior não há derivada: evita o pico da primeira chamada
+        if (primeira_) {
+            ultimo_valor_d_ = valor_d;
+            primeira_ = false;
+        }
+        if (filtrar_derivada_) {
+            termo_d_ = alfa_d_ * termo_d_ + ganho_d_ * (valor_d - ultimo_valor_d_);
+        } else {
+            termo_d_ = kd_ * ((valor_d - ultimo_valor_d_) * inverso_dt_);
+        }
+        ultimo_valor_d_ = valor_d;
+
+        termo_p_ = kp_ * (medida - b_ * alvo);
+        N saida = termo_p_ + ki_ * integral_ + termo_d_ + avanco;
+
+        // Anti-windup inteligente
+        bool saturando_alto = (saida >= saida_maxima_ && erro > zero_);
+        bool saturando_baixo = (saida <= zero_ && erro < zero_);
+
+        if (!saturando_alto && !saturando_baixo) {
+            integral_ += erro * dt_;
+            integral_ = limitar(integral_, -integral_maxima_, integral_maxima_);
+        }
+
+        // Recalcular com integral atualizada
+        termo_i_ = ki_ * integral_;
+        saida = limitar(termo_p_ + termo_i_ + termo_d_ + avanco, zero_, saida_maxima_);
+        return saida;
+    }
+
+    N termo_p() const { return termo_p_; }
+    N termo_i() const { return termo_i_; }
+    N termo_d() const { return termo_d_; }
+
+private:
+    static N limitar(N valor, N minimo, N maximo) {
+        return valor < minimo ? minimo : (valor > maximo ? maximo : valor);
+    }
+
+    // Tf/(Tf + dt) e kd/(Tf + dt): derivada filtrada discretizada por Euler implícito
+    void recalcular() {
+        dt_ = numero_de_float<N>(dt_s_);
+        inverso_dt_ = numero_de_float<N>(1.0f / dt_s_);
+        kp_ = numero_de_float<N>(kp_f_);
+        ki_ = numero_de_float<N>(ki_f_);
+        kd_ = numero_de_float<N>(kd_f_);
+        b_ = numero_de_float<N>(b_f_);
+        c_ = numero_de_float<N>(c_f_);
+
+        float tf = n_f_ > 0 && kp_f_ > 0 ? kd_f_ / (kp_f_ * n_f_) : 0;
+        filtrar_derivada_ = tf > 0;
+        alfa_d_ = numero_de_float<N>(tf / (tf + dt_s_));
+        ganho_d_ = numero_de_float<N>(kd_f_ / (tf + dt_s_));
+    }
+
+    const N saida_maxima_, integral_maxima_, zero_;
+    float dt_s_, kp_f_, kd_f_, ki_f_, b_f_, c_f_, n_f_;
+    N dt_, inverso_dt_;
+    N kp_, ki_, kd_;
+    N b_, c_, alfa_d_, ganho_d_;
+    bool filtrar_derivada_;
+    bool primeira_;
+    N integral_, ultimo_valor_d_;
+    N termo_p_, termo_i_, termo_d_;
+};
+
+// Aritmética escolhida na compilação: -D PID_PONTO_FIXO usa Q16.16
+#ifdef PID_PONTO_FIXO
+typedef Q16 NumeroPID;
+#else
+typedef float NumeroPID;
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef PONTO_FIXO_H
+#define PONTO_FIXO_H
+
+#include <stdint.h>
+
+// Número em ponto fixo com FRACAO bits fracionários em um int32 (Q16.16 com
+// FRACAO = 16). Soma e subtração são inteiras; a multiplicação usa um
+// produto de 64 bits. Conversões de constantes saem em tempo de compilação.
+// Tudo satura em INT32_MIN/INT32_MAX em vez de dar a volta: com ganhos
+// grandes um termo do PID passa de ±32768 e a saída não pode trocar de sinal.
+// Dois termos saturados de sinais opostos ainda se anulam, então ganhos que
+// levam os dois além da faixa pedem o PID em float.
+template <int FRACAO>
+struct PontoFixo {
+    int32_t bruto;
+
+    static constexpr int32_t UM = (int32_t)1 << FRACAO;
+
+    static constexpr PontoFixo de_bruto(int32_t valor) {
+        return PontoFixo{valor};
+    }
+
+    static constexpr int32_t saturar(int64_t valor) {
+        return valor > INT32_MAX ? INT32_MAX : (valor < INT32_MIN ? INT32_MIN : (int32_t)valor);
+    }
+
+    // NaN vira zero
+    static constexpr PontoFixo de_float(float valor) {
+        return PontoFixo{valor != valor ? 0
+                         : valor * UM >= 2147483648.0f ? INT32_MAX
+                         : valor * UM <= -2147483648.0f ? INT32_MIN
+                         : (int32_t)(valor * UM + (valor >= 0 ? 0.5f : -0.5f))};
+    }
+
+    constexpr float para_float() const {
+        return (float)bruto / UM;
+    }
+
+    // Truncado em direção a zero, como o (int) de um float
+    constexpr int32_t para_int() const {
+        // Nega em 64 bits: INT32_MIN, que a saturação produz, não tem oposto em 32
+        return bruto >= 0 ? bruto >> FRACAO : -(int32_t)((-(int64_t)bruto) >> FRACAO);
+    }
+
+    constexpr PontoFixo operator+(PontoFixo outro) const { return PontoFixo{saturar((int64_t)bruto + outro.bruto)}; }
+    constexpr PontoFixo operator-(PontoFixo outro) const { return PontoFixo{saturar((int64_t)bruto - outro.bruto)}; }
+    constexpr PontoFixo operator-() const { return PontoFixo{saturar(-(int64_t)bruto)}; }
+    constexpr PontoFixo operator*(PontoFixo outro) const {
+        return PontoFixo{saturar(((int64_t)bruto * outro.bruto) >> FRACAO)};
+    }
+
+    PontoFixo &operator+=(PontoFixo outro) { bruto = saturar((int64_t)bruto + outro.bruto); return *this; }
+
+    constexpr bool operator<(PontoFixo outro) const { return bruto < outro.bruto; }
+    constexpr bool operator>(PontoFixo outro) const { return bruto > outro.bruto; }
+    constexpr bool operator<=(PontoFixo outro) const { return bruto <= outro.bruto; }
+    constexpr bool operator>=(PontoFixo outro) const { return bruto >= outro.bruto; }
+};
+
+typedef PontoFixo<16> Q16;
+
+// Conversões usadas pelo núcleo do PID, para float e ponto fixo igualmente
+template <typename N> inline N numero_de_float(float valor);
+template <> inline float numero_de_float<float>(float valor) { return valor; }
+template <> inline Q16 numero_de_float<Q16>(float valor) { return Q16::de_float(valor); }
+
+inline float numero_para_float(float valor) { return valor; }
+template <int F> inline float numero_para_float(PontoFixo<F> valor) { return valor.para_float(); }
+
+inline int numero_para_int(float valor) { return (int)valor; }
+template <int F> inline int numero_para_int(PontoFixo<F> valor) { return valor.para_int(); }
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef POOL_BLOCOS_H
+#define POOL_BLOCOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+
+// Blocos de tamanho fixo reservados estaticamente, para objetos que nascem
+// e morrem a cada requisição (operator new/delete da classe). Com todos os
+// blocos emprestados, cai no heap. Não é seguro entre tarefas: o servidor
+// web atende todas as requisições na tarefa do AsyncTCP.
+template <size_t TAMANHO, size_t QUANTIDADE>
+class PoolBlocos {
+public:
+    static_assert(QUANTIDADE <= 32, "ocupados_ tem 32 bits");
+
+    PoolBlocos() : ocupados_(0), alocacoes_heap_(0) {}
+
+    void *obter() {
+        for (size_t i = 0; i < QUANTIDADE; i++) {
+            if (!(ocupados_ & (1u << i))) {
+                ocupados_ |= 1u << i;
+                return blocos_[i].bytes;
+            }
+        }
+        alocacoes_heap_++;
+        return ::operator new(TAMANHO);
+    }
+
+    void devolver(void *memoria) {
+        for (size_t i = 0; i < QUANTIDADE; i++) {
+            if (memoria == blocos_[i].bytes) {
+                ocupados_ &= ~(1u << i);
+                return;
+            }
+        }
+        ::operator delete(memoria);
+    }
+
+    // Se a memória é um dos blocos estáticos (e não do heap ou de outro lugar)
+    bool contem(const void *memoria) const {
+        for (size_t i = 0; i < QUANTIDADE; i++) {
+            if (memoria == blocos_[i].bytes) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t em_uso() const { return __builtin_popcount(ocupados_); }
+    unsigned long alocacoes_heap() const { return alocacoes_heap_; }
+
+private:
+    union Bloco {
+        unsigned char bytes[TAMANHO];
+        long double alinhamento;
+        void *ponteiro;
+    };
+
+    Bloco blocos_[QUANTIDADE];
+    uint32_t ocupados_;
+    unsigned long alocacoes_heap_;
+};
+
+#endif
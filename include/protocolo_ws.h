@@ -0,0 +1,57 @@
+#ifndef PROTOCOLO_WS_H
+#define PROTOCOLO_WS_H
+
+#include <stdint.h>
+
+// Protocolo binário do WebSocket /ws.
+// Todo quadro começa com um byte de tipo; os campos seguem em little-endian
+// (ordem nativa do ESP32), sem padding. Um quadro de comando pode terminar
+// com um byte extra com o número do canal; sem ele, vale o canal 0.
+enum TipoQuadroWS : uint8_t {
+    QUADRO_TELEMETRIA = 0x01,       // Servidor -> cliente, um por ciclo de controle
+    QUADRO_RESPOSTA = 0x02,         // Servidor -> cliente, resposta a um comando
+    QUADRO_DEFINIR_ALVO = 0x10,     // float alvo
+    QUADRO_DEFINIR_PID = 0x11,      // float kp, float ki, float kd
+    QUADRO_ALTERNAR = 0x12,
+    QUADRO_RESETAR_LIMITE = 0x13
+};
+
+enum ResultadoComandoWS : uint8_t {
+    RESULTADO_OK = 0,
+    RESULTADO_FILA_CHEIA = 1,
+    RESULTADO_INVALIDO = 2
+};
+
+const uint8_t FLAG_LIGADO = 0x01;
+const uint8_t FLAG_LIMITE_ATINGIDO = 0x02;
+
+struct __attribute__((packed)) QuadroTelemetria {
+    uint8_t tipo;           // QUADRO_TELEMETRIA
+    uint8_t estado;         // EstadoControlador
+    uint8_t flags;          // FLAG_LIGADO | FLAG_LIMITE_ATINGIDO
+    uint8_t canal;
+    uint32_t ciclo;
+    uint32_t tempo_ms;
+    float temperatura;
+    float alvo;
+    float erro;
+    float termo_p;
+    float termo_i;
+    float termo_d;
+    uint16_t pwm;
+    uint16_t periodo_ms;
+    uint8_t resolucao;
+    float termo_ff;         // Parcela antecipatória da saída
+    float temperatura_quente;   // NaN sem sensor no dissipador
+};
+
+struct __attribute__((packed)) QuadroResposta {
+    uint8_t tipo;           // QUADRO_RESPOSTA
+    uint8_t comando;        // Tipo do quadro de comando respondido
+    uint8_t resultado;      // ResultadoComandoWS
+};
+
+static_assert(sizeof(QuadroTelemetria) == 49, "Layout do quadro de telemetria mudou");
+static_assert(sizeof(QuadroResposta) == 3, "Layout do quadro de resposta mudou");
+
+#endif
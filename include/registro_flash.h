@@ -0,0 +1,59 @@
+#ifndef REGISTRO_FLASH_H
+#define REGISTRO_FLASH_H
+
+#include <FS.h>
+#include <mutex>
+#include "formato_registro.h"
+#include "historico.h"
+
+// Registro persistente da telemetria no LittleFS, para análise depois de
+// uma queda de energia. As amostras saem do histórico bruto em blocos de
+// AMOSTRAS_POR_BLOCO (uma escrita a cada 30 s poupa a flash); os segmentos
+// giram ao atingir TAMANHO_MAXIMO_SEGMENTO e os mais antigos são apagados.
+//
+// A gravação bloqueia durante o acesso à flash, então só deve ser chamada
+// fora da tarefa de controle.
+class RegistroFlash {
+public:
+    static const uint16_t AMOSTRAS_POR_BLOCO = 60;
+    static const uint32_t TAMANHO_MAXIMO_SEGMENTO = 64 * 1024;
+    static const size_t MAXIMO_SEGMENTOS = 16;
+
+    // Monta o LittleFS, recupera o índice e descarta blocos cortados do
+    // segmento que estava aberto no último desligamento
+    bool iniciar(uint16_t periodo_ms);
+
+    // Grava as amostras do histórico que ainda não foram para a flash
+    void sincronizar(const Historico &historico);
+
+    // Cópia do índice, segura para o servidor web
+    size_t copiar_indice(EntradaIndice *destino, size_t maximo) const;
+
+    uint16_t periodo_ms() const { return periodo_ms_; }
+
+private:
+    bool carregar_indice();
+    void reconstruir_indice();
+    void inserir_no_indice(const EntradaIndice &entrada);
+    bool verificar_segmento(uint32_t numero, EntradaIndice &entrada);
+    bool gravar_indice();
+    void remover_mais_antigo();
+    bool abrir_segmento(uint32_t tempo_inicial_ms, uint32_t indice_inicial);
+    bool gravar_bloco(uint32_t indice_inicial, uint16_t quantidade, uint32_t tempo_inicial_ms);
+
+    EntradaIndice indice_[MAXIMO_SEGMENTOS];
+    size_t num_segmentos_ = 0;
+    mutable std::mutex trava_indice_;
+
+    fs::File segmento_;
+    uint32_t tamanho_segmento_ = 0;
+    uint32_t proximo_segmento_ = 1;
+    uint32_t boot_ = 1;
+    uint32_t proximo_indice_ = 0;
+    uint16_t periodo_ms_ = 0;
+    bool pronto_ = false;
+
+    AmostraBruta lote_[AMOSTRAS_POR_BLOCO];
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef RESPOSTA_JSON_H
+#define RESPOSTA_JSON_H
+
+#include <ESPAsyncWebServer.h>
+#include "conteudo_resposta_json.h"
+#include "pool_blocos.h"
+
+// Resposta JSON com o cabeçalho e o corpo no próprio objeto. A
+// AsyncAbstractResponse monta o cabeçalho numa String, guarda o tipo e o
+// "Connection: close" em Strings e faz um malloc do tamanho do pacote a cada
+// envio; aqui o cabeçalho é escrito num buffer fixo e os dois buffers vão
+// direto para o cliente TCP. Os objetos saem de um pool estático, então uma
+// requisição de /dados não passa pelo heap do nosso lado (o AsyncTCP ainda
+// aloca os seus pbufs e eventos, como para qualquer resposta). Cabeçalhos
+// extras (addHeader, middlewares) entram enquanto couberem no buffer.
+class RespostaJson final : public AsyncWebServerResponse {
+public:
+    explicit RespostaJson(int codigo = 200) {
+        _code = codigo;
+    }
+
+    size_t serializar_snapshot(const SnapshotControlador &snapshot, ArduinoJson::Allocator &alocador) {
+        return _contentLength = conteudo_.serializar_snapshot(snapshot, alocador);
+    }
+
+    bool _sourceValid() const override { return true; }
+
+    void _respond(AsyncWebServerRequest *request) override {
+        _state = RESPONSE_HEADERS;
+        conteudo_.iniciar_cabecalho(request->version(), _code, responseCodeToString(_code));
+        for (const auto &extra : _headers) {
+            if (!conteudo_.acrescentar_cabecalho(extra.name().c_str(), extra.value().c_str())) {
+                break;
+            }
+        }
+        conteudo_.fechar_cabecalho();
+        _headLength = conteudo_.tamanho_cabecalho();
+        _state = RESPONSE_CONTENT;
+        enviar(request);
+    }
+
+    size_t _ack(AsyncWebServerRequest *request, size_t tamanho, uint32_t tempo) override {
+        (void)tempo;
+        _ackedLength += tamanho;
+        if (_state == RESPONSE_CONTENT) {
+            return enviar(request);
+        }
+        if (_state == RESPONSE_WAIT_ACK && _ackedLength >= _writtenLength) {
+            _state = RESPONSE_END;
+        }
+        return 0;
+    }
+
+    static void *operator new(size_t tamanho);
+    static void operator delete(void *memoria);
+
+private:
+    // Escreve o que couber no cliente: primeiro o cabeçalho, depois o corpo.
+    // _sentLength conta os dois juntos.
+    size_t enviar(AsyncWebServerRequest *request) {
+        size_t total = _headLength + conteudo_.tamanho();
+        size_t escrito = 0;
+        while (_sentLength < total) {
+            size_t espaco = request->client()->space();
+            if (espaco == 0) {
+                break;
+            }
+            const char *origem;
+            size_t restante;
+            if (_sentLength < _headLength) {
+                origem = conteudo_.cabecalho() + _sentLength;
+                restante = _headLength - _sentLength;
+            } else {
+                origem = conteudo_.json() + (_sentLength - _headLength);
+                restante = total - _sentLength;
+            }
+            size_t aceito = request->client()->write(origem, restante < espaco ? restante : espaco);
+            if (aceito == 0) {
+                break;
+            }
+            _sentLength += aceito;
+            escrito += aceito;
+        }
+        _writtenLength += escrito;
+        if (_sentLength >= total) {
+            _state = RESPONSE_WAIT_ACK;
+        }
+        return escrito;
+    }
+
+    ConteudoRespostaJson conteudo_;
+};
+
+typedef PoolBlocos<sizeof(RespostaJson), ConteudoRespostaJson::RESPOSTAS_SIMULTANEAS> PoolRespostasJson;
+
+inline PoolRespostasJson &pool_respostas_json() {
+    static PoolRespostasJson pool;
+    return pool;
+}
+
+inline void *RespostaJson::operator new(size_t tamanho) { return pool_respostas_json().obter(); }
+inline void RespostaJson::operator delete(void *memoria) { pool_respostas_json().devolver(memoria); }
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef ROTA_CORPO_H
+#define ROTA_CORPO_H
+
+#include <functional>
+#include <string.h>
+#include <ESPAsyncWebServer.h>
+#include "pool_blocos.h"
+
+// Rota POST que entrega o corpo inteiro ao tratador, no molde do
+// AsyncCallbackJsonWebHandler da biblioteca (que não dá para estender:
+// handleBody e handleRequest são final). O corpo pode chegar em vários
+// segmentos TCP; o tratador recebe ponteiro e tamanho, sem terminador, e
+// só roda depois do último segmento. Rotas sem corpo também chegam a ele,
+// com tamanho zero.
+// O estado de cada requisição fica nela mesma, em _tempObject, e nunca no
+// tratador, que todas as requisições da rota compartilham:
+// - Num segmento só (o caso comum), _tempObject aponta direto para o pbuf,
+//   sem cópia: handleRequest roda na mesma chamada de _onData que entregou
+//   o último segmento, com o pbuf ainda vivo.
+// - Em vários, os segmentos são montados num bloco de TAMANHO_MAXIMO de um
+//   pool estático, com CORPOS_SIMULTANEOS blocos para todas as rotas.
+// Como a requisição chamaria free() no que sobrar em _tempObject, o corpo é
+// solto ao fim de handleRequest e também no onDisconnect, que cobre o
+// cliente que desconecta no meio do corpo.
+// Corpo application/x-www-form-urlencoded, ou text/plain que começa com
+// chave=, a biblioteca consome como parâmetros e handleBody nunca roda; a
+// resposta é 415.
+class RotaCorpo : public AsyncWebHandler {
+public:
+    typedef std::function<void(AsyncWebServerRequest *request, const uint8_t *corpo, size_t tamanho)> Tratador;
+
+    static const size_t TAMANHO_MAXIMO = 512;   // Os comandos têm menos de 100 bytes
+    static const size_t CORPOS_SIMULTANEOS = 2; // Corpos em vários segmentos ao mesmo tempo
+
+    RotaCorpo(const char *uri, Tratador tratador) : uri_(uri), tratador_(tratador) {}
+
+    bool canHandle(AsyncWebServerRequest *request) const override {
+        return request->method() == HTTP_POST && request->url() == uri_;
+    }
+
+    bool isRequestHandlerTrivial() const override { return false; }
+
+    void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) override {
+        if (index == 0) {
+            if (len == total) {
+                request->_tempObject = data;
+            } else if (total <= TAMANHO_MAXIMO && pool().em_uso() < CORPOS_SIMULTANEOS) {
+                request->_tempObject = pool().obter();
+            }
+            if (request->_tempObject) {
+                request->onDisconnect([request]() { soltar_corpo(request); });
+            }
+        }
+        if (pool().contem(request->_tempObject) && index + len <= total) {
+            memcpy((uint8_t *)request->_tempObject + index, data, len);
+        }
+    }
+
+    void handleRequest(AsyncWebServerRequest *request) override {
+        size_t tamanho = request->contentLength();
+        const uint8_t *corpo = (const uint8_t *)request->_tempObject;
+        if (tamanho == 0) {
+            corpo = (const uint8_t *)"";
+        }
+
+        if (!corpo) {
+            if (tamanho > TAMANHO_MAXIMO) {
+                request->send(413, "text/plain", "Corpo muito grande");
+            } else if (lido_como_formulario(request)) {
+                request->send(415, "text/plain", "Envie o corpo como application/json");
+            } else {
+                request->send(503, "text/plain", "Corpos demais em andamento, tente de novo");
+            }
+            return;
+        }
+        tratador_(request, corpo, tamanho);
+        soltar_corpo(request);
+    }
+
+private:
+    typedef PoolBlocos<TAMANHO_MAXIMO, CORPOS_SIMULTANEOS> PoolCorpos;
+
+    static PoolCorpos &pool() {
+        static PoolCorpos blocos;
+        return blocos;
+    }
+
+    // Devolve o bloco ao pool; o ponteiro para o pbuf só é esquecido
+    static void soltar_corpo(AsyncWebServerRequest *request) {
+        if (pool().contem(request->_tempObject)) {
+            pool().devolver(request->_tempObject);
+        }
+        request->_tempObject = NULL;
+    }
+
+    // A biblioteca só guarda parâmetros de POST quando leu o corpo ela mesma
+    static bool lido_como_formulario(AsyncWebServerRequest *request) {
+        for (size_t i = 0; i < request->params(); i++) {
+            if (request->getParam(i)->isPost()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *uri_;
+    Tratador tratador_;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SAIDA_PWM_H
+#define SAIDA_PWM_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Configuração do ledc das pastilhas. O ledc deriva o PWM do APB de 80 MHz,
+// então frequência * 2^bits não passa de 80 MHz: 20 kHz (acima do audível)
+// comporta 11 bits (12 bits só até 19.5 kHz).
+const uint32_t FREQUENCIA_PWM_HZ = 20000;
+const uint8_t RESOLUCAO_PWM_BITS = 11;
+const bool DITHERING_PWM = true;
+const float TAXA_MAXIMA_PWM = 0.5;      // Fração do fundo de escala por segundo; 0 = sem limite
+
+// Converte a saída do controlador (fração de 0 a 1) no duty do ledc. É
+// chamada a cada tick da tarefa de controle, mais rápido que as amostras:
+// - a taxa de variação é limitada para poupar a pastilha de choque térmico
+//   (a potência sobe e desce em rampa, inclusive no erro do sensor);
+// - com dithering, o resto do arredondamento é acumulado (sigma-delta de
+//   primeira ordem), então a média do duty acompanha a saída abaixo de 1 LSB.
+// Não acessa hardware, como o Controlador.
+class SaidaPWM {
+public:
+    SaidaPWM(uint8_t resolucao_bits = RESOLUCAO_PWM_BITS, float taxa_maxima = TAXA_MAXIMA_PWM,
+             bool dithering = DITHERING_PWM)
+        : duty_maximo_((1u << resolucao_bits) - 1), taxa_maxima_(taxa_maxima), dithering_(dithering) {
+        desligar();
+    }
+
+    void definir_alvo(float fracao) {
+        alvo_ = fracao > 0 ? (fracao < 1 ? fracao : 1) : 0;   // NaN vira 0
+    }
+
+    // Desligar pelo usuário corta na hora, sem rampa
+    void desligar() {
+        alvo_ = atual_ = residuo_ = 0;
+        duty_ = 0;
+    }
+
+    // Avança dt segundos e devolve o duty a escrever no ledc
+    uint32_t atualizar(float dt) {
+        float passo = taxa_maxima_ * dt;
+        if (taxa_maxima_ <= 0 || fabsf(alvo_ - atual_) <= passo) {
+            atual_ = alvo_;
+        } else {
+            atual_ += alvo_ > atual_ ? passo : -passo;
+        }
+
+        float desejado = atual_ * duty_maximo_;
+        if (dithering_) {
+            desejado += residuo_;
+            duty_ = (uint32_t)desejado;
+            residuo_ = desejado - duty_;
+        } else {
+            duty_ = (uint32_t)(desejado + 0.5f);
+        }
+        if (duty_ > duty_maximo_) {
+            duty_ = duty_maximo_;
+        }
+        return duty_;
+    }
+
+    uint32_t duty() const { return duty_; }
+    uint32_t duty_maximo() const { return duty_maximo_; }
+    float fracao() const { return atual_; }     // Depois da rampa, antes do dithering
+
+private:
+    const uint32_t duty_maximo_;
+    const float taxa_maxima_;
+    const bool dithering_;
+    float alvo_, atual_, residuo_;
+    uint32_t duty_;
+};
+
+#endif
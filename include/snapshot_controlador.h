@@ -0,0 +1,89 @@
+#ifndef SNAPSHOT_CONTROLADOR_H
+#define SNAPSHOT_CONTROLADOR_H
+
+#include <atomic>
+#include <stdint.h>
+#include "autoajuste.h"
+
+// Retrato do controlador publicado uma vez por ciclo de controle.
+// POD de tamanho fixo: copiar não aloca memória.
+struct SnapshotControlador {
+    uint32_t ciclo;         // Incrementa a cada publicação
+    uint32_t tempo_ms;
+    float temperatura;
+    float alvo;
+    float erro;
+    float termo_p;          // Termos do último cálculo do PID (zero fora do PID)
+    float termo_i;
+    float termo_d;
+    float termo_ff;         // Parcela antecipatória da saída (zero sem o lado quente)
+    float temperatura_quente;   // NAN sem sensor no dissipador
+    int pwm;
+    bool ligado;
+    bool limite_atingido;
+    uint8_t estado;         // EstadoControlador
+    uint8_t canal;
+    uint8_t resolucao;      // Bits da leitura desta amostra
+    uint16_t periodo_ms;    // Intervalo desde a amostra anterior (dt do PID)
+    uint8_t filtro;         // TipoFiltro, com mediana e parâmetro (GET /filtro)
+    bool mediana;
+    float parametro_filtro;
+    float ganho_antecipacao;    // Modelo da ação antecipatória (GET /antecipacao)
+    float base_antecipacao;
+    bool aprender_antecipacao;
+    uint32_t blocos_antecipacao;       // Blocos de regime já aprendidos
+    ResultadoAutoajuste autoajuste;
+};
+
+// Buffer duplo com um único escritor (a tarefa de controle) e qualquer
+// número de leitores (HTTP, SSE, WebSocket). O escritor grava sempre a cópia
+// que não está publicada e depois troca o índice; ninguém espera ninguém.
+// Cada cópia tem sua sequência: o leitor só falha se o escritor publicar duas
+// vezes durante uma única cópia, e então tenta de novo um número limitado de
+// vezes em vez de girar (um leitor de prioridade maior no núcleo do escritor
+// nunca fica preso esperando a publicação terminar).
+class CanalSnapshot {
+public:
+    static const uint8_t TENTATIVAS_LEITURA = 3;
+
+    void publicar(const SnapshotControlador &novo) {
+        uint8_t livre = 1 - publicado_.load(std::memory_order_relaxed);
+        Copia &destino = copias_[livre];
+        uint32_t seq = destino.sequencia.load(std::memory_order_relaxed);
+        destino.sequencia.store(seq + 1, std::memory_order_relaxed); // Ímpar: escrita em andamento
+        std::atomic_thread_fence(std::memory_order_release);
+        destino.dados = novo;
+        destino.sequencia.store(seq + 2, std::memory_order_release);
+        publicado_.store(livre, std::memory_order_release);
+    }
+
+    // Falso só se todas as tentativas coincidirem com publicações; aí
+    // "copia" fica como estava (a última boa do chamador)
+    bool ler(SnapshotControlador &copia) const {
+        for (uint8_t tentativa = 0; tentativa < TENTATIVAS_LEITURA; tentativa++) {
+            const Copia &origem = copias_[publicado_.load(std::memory_order_acquire)];
+            uint32_t antes = origem.sequencia.load(std::memory_order_acquire);
+            if (antes & 1) {
+                continue;
+            }
+            SnapshotControlador lida = origem.dados;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (origem.sequencia.load(std::memory_order_relaxed) == antes) {
+                copia = lida;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Copia {
+        std::atomic<uint32_t> sequencia{0};
+        SnapshotControlador dados{};
+    };
+
+    std::atomic<uint8_t> publicado_{0};
+    Copia copias_[2];
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <ESPAsyncWebServer.h>
+#include "alocador_json.h"
+#include "snapshot_controlador.h"
+#include "interpretador.h"
+
+// Stream SSE em /eventos. Cada ciclo de controle vira um único quadro por
+// canal, serializado uma vez e compartilhado pelas filas de todos os assinantes.
+class TelemetriaSSE {
+public:
+    TelemetriaSSE(const CanalSnapshot *canais, size_t num_canais);
+
+    void registrar(AsyncWebServer &servidor);
+
+    // Deve rodar fora da tarefa de controle para não atrasá-la com o lwIP
+    void publicar(const SnapshotControlador &snapshot);
+
+private:
+    const CanalSnapshot *canais_;
+    const size_t num_canais_;
+    AsyncEventSource eventos_;
+    AlocadorJson alocador_;     // Usado só por publicar
+};
+
+// WebSocket binário em /ws (formato em protocolo_ws.h). A telemetria vai em
+// um único buffer compartilhado por todos os clientes; no sentido contrário
+// o mesmo socket recebe os comandos de alvo, PID, liga/desliga e limite.
+class TelemetriaWS {
+public:
+    explicit TelemetriaWS(size_t num_canais);
+
+    void registrar(AsyncWebServer &servidor);
+    void publicar(const SnapshotControlador &snapshot);
+
+private:
+    void tratar_evento(AsyncWebSocketClient *cliente, AwsEventType tipo, void *arg,
+                       uint8_t *dados, size_t tamanho);
+
+    const size_t num_canais_;
+    AsyncWebSocket ws_;
+};
+
+#endif
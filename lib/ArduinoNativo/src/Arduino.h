@@ -0,0 +1,66 @@
+#ifndef ARDUINO_NATIVO_H
+#define ARDUINO_NATIVO_H
+
+// Shim mínimo da API do Arduino para compilar a lógica do firmware no PC
+// (env:native). Só o que os módulos portáveis usam; o tempo é simulado e
+// avança apenas quando a ferramenta chama definir_millis_nativo() ou quando
+// uma operação simulada ocupa o processador (avancar_micros_nativo()).
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OUTPUT 0x03
+#define INPUT 0x01
+
+template <typename T, typename L, typename H>
+inline T constrain(T valor, L minimo, H maximo) {
+    return valor < minimo ? minimo : (valor > maximo ? maximo : valor);
+}
+
+unsigned long millis();
+unsigned long micros();
+void definir_millis_nativo(unsigned long agora);
+// Tempo gasto por uma operação bloqueante simulada, como uma transação no
+// barramento OneWire
+void avancar_micros_nativo(unsigned long duracao_us);
+
+void pinMode(uint8_t pino, uint8_t modo);
+
+// ledc: guarda o último duty de cada canal para a ferramenta consultar
+uint32_t ledcSetup(uint8_t canal, uint32_t frequencia, uint8_t resolucao);
+void ledcAttachPin(uint8_t pino, uint8_t canal);
+void ledcWrite(uint8_t canal, uint32_t duty);
+uint32_t ledc_duty_nativo(uint8_t canal);
+
+// Serial vai para stderr, deixando stdout livre para a saída das ferramentas
+class SerialNativo {
+public:
+    void begin(unsigned long) {}
+    void silenciar(bool silencioso) { silencioso_ = silencioso; }
+
+    size_t print(const char *texto) { return escrever("%s", texto); }
+    size_t print(int valor) { return escrever("%d", valor); }
+    size_t print(unsigned long valor) { return escrever("%lu", valor); }
+    size_t print(double valor, int casas = 2) { return escrever("%.*f", casas, valor); }
+
+    size_t println() { return escrever("\n"); }
+    template <typename T>
+    size_t println(T valor) { return print(valor) + println(); }
+    size_t println(double valor, int casas) { return print(valor, casas) + println(); }
+
+    size_t printf(const char *formato, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    size_t escrever(const char *formato, ...) __attribute__((format(printf, 2, 3)));
+
+    bool silencioso_ = false;
+};
+
+extern SerialNativo Serial;
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef DALLAS_TEMPERATURE_NATIVO_H
+#define DALLAS_TEMPERATURE_NATIVO_H
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+typedef uint8_t ScratchPad[9];
+
+// DS18B20 simulados: requestTemperatures() captura as temperaturas definidas
+// por definir_temperatura(), quantizadas na resolução de cada sensor (a
+// configuração fica no OneWire nativo), e a conversão termina depois do mesmo
+// tempo que no sensor real. O sensor i tem o endereço ROM 28 i+1 00 00 00 00
+// 00 00. Com simular_latencia(true), cada chamada ocupa o processador pelo
+// tempo que a transação leva no barramento (e requestTemperatures() pela
+// conversão inteira, se a espera da biblioteca estiver ligada).
+class DallasTemperature {
+public:
+    static const uint8_t MAXIMO_SIMULADOS = 8;
+
+    static const uint32_t RESET_US = OneWire::RESET_US;
+    static const uint32_t SLOT_US = OneWire::SLOT_US;
+    static const uint32_t BYTE_US = OneWire::BYTE_US;
+    static const uint32_t BUSCA_US = RESET_US + BYTE_US + 64 * 3 * SLOT_US;
+    // Reset, MATCH ROM com o endereço, READ SCRATCHPAD e os 9 bytes
+    static const uint32_t LEITURA_SCRATCHPAD_US = RESET_US + 19 * BYTE_US;
+
+    explicit DallasTemperature(OneWire *barramento) : barramento_(barramento) {
+        for (uint8_t i = 0; i < MAXIMO_SIMULADOS; i++) {
+            temperaturas_[i] = 25;
+            convertidas_[i] = DEVICE_DISCONNECTED_C;
+        }
+    }
+
+    // Enumeração: uma busca por sensor e mais uma que acha o fim, e a
+    // leitura do scratchpad de cada um
+    void begin() { ocupar((quantidade_ + 1) * BUSCA_US + quantidade_ * LEITURA_SCRATCHPAD_US); }
+
+    // Como na biblioteca: para cada sensor, lê o scratchpad, grava a
+    // configuração e a copia para a EEPROM, com 20 ms de espera
+    void setResolution(uint8_t resolucao) {
+        resolucao = resolucao < 9 ? 9 : (resolucao > 12 ? 12 : resolucao);
+        for (uint8_t i = 0; i < quantidade_; i++) {
+            DeviceAddress endereco = {0x28, (uint8_t)(i + 1)};
+            ScratchPad scratchpad;
+            readScratchPad(endereco, scratchpad);
+            barramento_->reset();
+            barramento_->select(endereco);
+            barramento_->write(0x4E);   // WRITE SCRATCHPAD: TH, TL e configuração
+            barramento_->write(scratchpad[2]);
+            barramento_->write(scratchpad[3]);
+            barramento_->write((resolucao - 9) << 5 | 0x1F);
+            barramento_->reset();
+            barramento_->select(endereco);
+            barramento_->write(0x48);   // COPY SCRATCHPAD
+            ocupar(20000);
+        }
+    }
+
+    // 9 bytes; a temperatura é a última convertida, sem o CRC
+    bool readScratchPad(const uint8_t *endereco, uint8_t *scratchpad) const {
+        ocupar(LEITURA_SCRATCHPAD_US);
+        uint8_t indice = endereco[1] - 1;
+        if (endereco[0] != 0x28 || indice >= quantidade_) {
+            return false;
+        }
+        int16_t bruto = (int16_t)(convertidas_[indice] * 16);
+        memset(scratchpad, 0, sizeof(ScratchPad));
+        scratchpad[0] = bruto & 0xFF;
+        scratchpad[1] = bruto >> 8;
+        scratchpad[2] = barramento_->alarme_alto(indice);
+        scratchpad[3] = barramento_->alarme_baixo(indice);
+        scratchpad[4] = barramento_->configuracao(indice);
+        return true;
+    }
+
+    void setWaitForConversion(bool esperar) { esperar_ = esperar; }
+
+    uint8_t getDeviceCount() const { return quantidade_; }
+
+    // A biblioteca refaz a busca do começo até o índice pedido
+    bool getAddress(uint8_t *endereco, uint8_t indice) const {
+        ocupar((indice + 1) * BUSCA_US);
+        if (indice >= quantidade_) {
+            return false;
+        }
+        memset(endereco, 0, sizeof(DeviceAddress));
+        endereco[0] = 0x28;
+        endereco[1] = indice + 1;
+        return true;
+    }
+
+    int16_t millisToWaitForConversion(uint8_t resolucao) const {
+        switch (resolucao) {
+            case 9: return 94;
+            case 10: return 188;
+            case 11: return 375;
+            default: return 750;
+        }
+    }
+
+    // Todos convertem juntos; o barramento só libera quando o mais lento termina
+    void requestTemperatures() {
+        // Reset, SKIP ROM e CONVERT T
+        ocupar(RESET_US + 2 * BYTE_US);
+        inicio_conversao_ = millis();
+        resolucao_conversao_ = 9;
+        for (uint8_t i = 0; i < quantidade_; i++) {
+            uint8_t resolucao = barramento_->resolucao(i);
+            float passo = 0.0625f * (1 << (12 - resolucao));
+            float temperatura = temperaturas_[i];
+            convertidas_[i] = temperatura == DEVICE_DISCONNECTED_C ? temperatura : floorf(temperatura / passo) * passo;
+            if (resolucao > resolucao_conversao_) {
+                resolucao_conversao_ = resolucao;
+            }
+        }
+        if (esperar_) {
+            ocupar(millisToWaitForConversion(resolucao_conversao_) * 1000UL);
+        }
+    }
+
+    bool isConversionComplete() const {
+        ocupar(SLOT_US);
+        return millis() - inicio_conversao_ >= (unsigned long)millisToWaitForConversion(resolucao_conversao_);
+    }
+
+    float getTempC(const uint8_t *endereco) const {
+        ocupar(LEITURA_SCRATCHPAD_US);
+        uint8_t indice = endereco[1] - 1;
+        return endereco[0] == 0x28 && indice < quantidade_ ? convertidas_[indice] : DEVICE_DISCONNECTED_C;
+    }
+
+    float getTempCByIndex(uint8_t indice) const {
+        ocupar((indice + 1) * BUSCA_US + LEITURA_SCRATCHPAD_US);
+        return indice < quantidade_ ? convertidas_[indice] : DEVICE_DISCONNECTED_C;
+    }
+
+    // Pontos de injeção do ambiente nativo
+    void simular_latencia(bool simular) {
+        latencia_ = simular;
+        barramento_->simular_latencia(simular);
+    }
+    void definir_quantidade(uint8_t quantidade) {
+        quantidade_ = quantidade < MAXIMO_SIMULADOS ? quantidade : MAXIMO_SIMULADOS;
+    }
+    void definir_temperatura(float temperatura, uint8_t indice = 0) {
+        if (indice < MAXIMO_SIMULADOS) {
+            temperaturas_[indice] = temperatura;
+        }
+    }
+
+private:
+    void ocupar(unsigned long duracao_us) const {
+        if (latencia_) {
+            avancar_micros_nativo(duracao_us);
+        }
+    }
+
+    OneWire *barramento_;
+    bool latencia_ = false;
+    bool esperar_ = true;
+    uint8_t quantidade_ = 1;
+    uint8_t resolucao_conversao_ = 12;
+    float temperaturas_[MAXIMO_SIMULADOS];
+    float convertidas_[MAXIMO_SIMULADOS];
+    unsigned long inicio_conversao_ = 0;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ONEWIRE_NATIVO_H
+#define ONEWIRE_NATIVO_H
+
+#include "Arduino.h"
+
+// O barramento não existe no PC. Guarda o que os DS18B20 simulados (ver
+// DallasTemperature.h) receberiam: TH, TL e configuração de cada sensor, o
+// sensor i com o endereço ROM 28 i+1 00 00 00 00 00 00. Conta as gravações
+// do scratchpad e as cópias para a EEPROM, e com a latência ligada cada
+// transação ocupa o processador pelo tempo que leva no fio.
+class OneWire {
+public:
+    static const uint8_t MAXIMO_DISPOSITIVOS = 8;
+
+    // Tempos do OneWire padrão: reset com presença e bytes de 8 slots
+    static const uint32_t RESET_US = 960;
+    static const uint32_t SLOT_US = 70;
+    static const uint32_t BYTE_US = 8 * SLOT_US;
+
+    explicit OneWire(uint8_t pino) {
+        for (uint8_t i = 0; i < MAXIMO_DISPOSITIVOS; i++) {
+            alarme_alto_[i] = 75;
+            alarme_baixo_[i] = 70;
+            configuracao_[i] = 0x7F;    // 12 bits, o padrão de fábrica
+        }
+    }
+
+    uint8_t reset() {
+        ocupar(RESET_US);
+        selecionado_ = NENHUM;
+        comando_ = 0;
+        bytes_ = 0;
+        return 1;
+    }
+
+    void select(const uint8_t *endereco) {
+        ocupar(9 * BYTE_US);
+        uint8_t indice = endereco[1] - 1;
+        selecionado_ = endereco[0] == 0x28 && indice < MAXIMO_DISPOSITIVOS ? indice : NENHUM;
+    }
+
+    void skip() {
+        ocupar(BYTE_US);
+        selecionado_ = TODOS;
+    }
+
+    void write(uint8_t valor, uint8_t energia = 0) {
+        ocupar(BYTE_US);
+        if (comando_ == 0) {
+            comando_ = valor;
+            if (comando_ == 0x48) {     // COPY SCRATCHPAD
+                copias_eeprom_++;
+            }
+            return;
+        }
+        if (comando_ != 0x4E || bytes_ >= 3) {
+            return;
+        }
+        // WRITE SCRATCHPAD: TH, TL e configuração
+        for (uint8_t i = 0; i < MAXIMO_DISPOSITIVOS; i++) {
+            if (selecionado_ != TODOS && selecionado_ != i) {
+                continue;
+            }
+            uint8_t *destino = bytes_ == 0 ? alarme_alto_ : (bytes_ == 1 ? alarme_baixo_ : configuracao_);
+            destino[i] = bytes_ == 2 ? (valor | 0x1F) & 0x7F : valor;
+        }
+        if (++bytes_ == 3) {
+            gravacoes_scratchpad_++;
+        }
+    }
+
+    // Estado dos sensores simulados
+    uint8_t alarme_alto(uint8_t indice) const { return alarme_alto_[indice]; }
+    uint8_t alarme_baixo(uint8_t indice) const { return alarme_baixo_[indice]; }
+    uint8_t configuracao(uint8_t indice) const { return configuracao_[indice]; }
+    uint8_t resolucao(uint8_t indice) const { return 9 + ((configuracao_[indice] >> 5) & 3); }
+    uint32_t gravacoes_scratchpad() const { return gravacoes_scratchpad_; }
+    uint32_t copias_eeprom() const { return copias_eeprom_; }
+
+    void simular_latencia(bool simular) { latencia_ = simular; }
+    void ocupar(unsigned long duracao_us) const {
+        if (latencia_) {
+            avancar_micros_nativo(duracao_us);
+        }
+    }
+
+private:
+    static const uint8_t NENHUM = 0xFF;
+    static const uint8_t TODOS = 0xFE;
+
+    bool latencia_ = false;
+    uint8_t selecionado_ = NENHUM;
+    uint8_t comando_ = 0;
+    uint8_t bytes_ = 0;
+    uint8_t alarme_alto_[MAXIMO_DISPOSITIVOS];
+    uint8_t alarme_baixo_[MAXIMO_DISPOSITIVOS];
+    uint8_t configuracao_[MAXIMO_DISPOSITIVOS];
+    uint32_t gravacoes_scratchpad_ = 0;
+    uint32_t copias_eeprom_ = 0;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "Arduino.h"
+
+SerialNativo Serial;
+
+static unsigned long long micros_simulado = 0;
+static const uint8_t NUM_CANAIS_LEDC = 16;
+static uint32_t duty_ledc[NUM_CANAIS_LEDC];
+
+unsigned long millis() {
+    return micros_simulado / 1000;
+}
+
+unsigned long micros() {
+    return micros_simulado;
+}
+
+void definir_millis_nativo(unsigned long agora) {
+    micros_simulado = agora * 1000ULL;
+}
+
+void avancar_micros_nativo(unsigned long duracao_us) {
+    micros_simulado += duracao_us;
+}
+
+void pinMode(uint8_t pino, uint8_t modo) {}
+
+uint32_t ledcSetup(uint8_t canal, uint32_t frequencia, uint8_t resolucao) {
+    return frequencia;
+}
+
+void ledcAttachPin(uint8_t pino, uint8_t canal) {}
+
+void ledcWrite(uint8_t canal, uint32_t duty) {
+    if (canal < NUM_CANAIS_LEDC) {
+        duty_ledc[canal] = duty;
+    }
+}
+
+uint32_t ledc_duty_nativo(uint8_t canal) {
+    return canal < NUM_CANAIS_LEDC ? duty_ledc[canal] : 0;
+}
+
+size_t SerialNativo::printf(const char *formato, ...) {
+    if (silencioso_) {
+        return 0;
+    }
+    va_list argumentos;
+    va_start(argumentos, formato);
+    int escritos = vfprintf(stderr, formato, argumentos);
+    va_end(argumentos);
+    return escritos > 0 ? escritos : 0;
+}
+
+size_t SerialNativo::escrever(const char *formato, ...) {
+    if (silencioso_) {
+        return 0;
+    }
+    va_list argumentos;
+    va_start(argumentos, formato);
+    int escritos = vfprintf(stderr, formato, argumentos);
+    va_end(argumentos);
+    return escritos > 0 ? escritos : 0;
+}
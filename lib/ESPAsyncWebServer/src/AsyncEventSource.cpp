@@ -397,7 +397,10 @@ size_t AsyncEventSource::avgPacketsWaiting() const {
 
 AsyncEventSource::SendStatus AsyncEventSource::send(
   const char* message, const char* event, uint32_t id, uint32_t reconnect) {
-  AsyncEvent_SharedData_t shared_msg = std::make_shared<String>(generateEventMessage(message, event, id, reconnect));
+  return write(std::make_shared<String>(generateEventMessage(message, event, id, reconnect)));
+}
+
+AsyncEventSource::SendStatus AsyncEventSource::write(AsyncEvent_SharedData_t shared_msg) {
 #ifdef ESP32
   std::lock_guard<std::mutex> lock(_client_queue_lock);
 #endif
@@ -428,6 +431,10 @@ bool AsyncEventSource::canHandle(AsyncWebServerRequest* request) const {
   return request->isSSE() && request->url().equals(_url);
 }
 
+bool AsyncEventSource::isInterestingHeader(const AsyncHeadView& name) const {
+  return name.equalsIgnoreCase(T_Last_Event_ID) || AsyncWebHandler::isInterestingHeader(name);
+}
+
 void AsyncEventSource::handleRequest(AsyncWebServerRequest* request) {
   request->send(new AsyncEventSourceResponse(this));
 }
@@ -261,6 +261,16 @@ class AsyncEventSource : public AsyncWebHandler {
     SendStatus send(const String& message, const String& event, uint32_t id = 0, uint32_t reconnect = 0) { return send(message.c_str(), event.c_str(), id, reconnect); }
     SendStatus send(const String& message, const char* event, uint32_t id = 0, uint32_t reconnect = 0) { return send(message.c_str(), event, id, reconnect); }
 
+    /**
+     * @brief place supplied preformatted SSE message to all connected client's message queues
+     * the same shared buffer is referenced by every client's queue, so the message is built only once
+     * @note message must a properly formatted SSE string according to https://developer.mozilla.org/en-US/docs/Web/API/Server-sent_events/Using_server-sent_events
+     *
+     * @param message data
+     * @return SendStatus if message was placed in any/all/part of the client's queues
+     */
+    SendStatus write(AsyncEvent_SharedData_t message);
+
     // The client pointer sent to the callback is only for reference purposes. DO NOT CALL ANY METHOD ON IT !
     void onDisconnect(ArEventHandlerFunction cb) { _disconnectcb = cb; }
     void authorizeConnect(ArAuthorizeConnectHandler cb);
@@ -276,6 +286,7 @@ class AsyncEventSource : public AsyncWebHandler {
     void _handleDisconnect(AsyncEventSourceClient* client);
     bool canHandle(AsyncWebServerRequest* request) const override final;
     void handleRequest(AsyncWebServerRequest* request) override final;
+    bool isInterestingHeader(const AsyncHeadView& name) const override final;
 };
 
 class AsyncEventSourceResponse : public AsyncWebServerResponse {
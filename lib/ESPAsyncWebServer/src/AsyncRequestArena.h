@@ -0,0 +1,109 @@
+#ifndef ASYNCREQUESTARENA_H
+#define ASYNCREQUESTARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Size of the per-request bump arena backing the header and parameter lists.
+// 0 disables it: the lists allocate from the heap as before.
+#ifndef ASYNCWEBSERVER_REQUEST_ARENA_SIZE
+  #define ASYNCWEBSERVER_REQUEST_ARENA_SIZE 0
+#endif
+
+// Bump allocator living inside the request: allocations are carved from a
+// fixed buffer and all released at once when the request is destroyed, so the
+// dozens of small list nodes of a request do not fragment the heap. When the
+// buffer is full it falls back to the heap. Freeing the last block rewinds the
+// arena; any other arena block stays reserved until the request ends.
+// Blocks are aligned at run time: the request itself comes from malloc(), which
+// on the ESP32 does not guarantee alignof(std::max_align_t).
+template <size_t N>
+class AsyncBumpArena {
+  private:
+    uint8_t _buffer[N];
+    size_t _used;
+    size_t _last;
+    size_t _heapAllocations;
+
+  public:
+    AsyncBumpArena() : _used(0), _last(0), _heapAllocations(0) {}
+    AsyncBumpArena(const AsyncBumpArena&) = delete;
+    AsyncBumpArena& operator=(const AsyncBumpArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+      uintptr_t base = (uintptr_t)_buffer;
+      size_t offset = ((base + _used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+      if (offset <= N && size <= N - offset) {
+        _last = offset;
+        _used = offset + size;
+        return _buffer + offset;
+      }
+      ++_heapAllocations;
+      return ::operator new(size);
+    }
+
+    void deallocate(void* p) {
+      if (!owns(p)) {
+        ::operator delete(p);
+      } else if ((uint8_t*)p == _buffer + _last) {
+        _used = _last;
+      }
+    }
+
+    bool owns(const void* p) const { return (const uint8_t*)p >= _buffer && (const uint8_t*)p < _buffer + N; }
+    size_t used() const { return _used; }
+    size_t capacity() const { return N; }
+    size_t heapAllocations() const { return _heapAllocations; }
+};
+
+// Standard allocator over an AsyncBumpArena, for the request containers.
+// Without an arena it is a plain heap allocator.
+template <typename T, size_t N>
+class AsyncArenaAllocator {
+  private:
+    AsyncBumpArena<N>* _arena;
+
+  public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template <typename U>
+    struct rebind {
+        typedef AsyncArenaAllocator<U, N> other;
+    };
+
+    AsyncArenaAllocator(AsyncBumpArena<N>* arena = nullptr) noexcept : _arena(arena) {}
+    template <typename U>
+    AsyncArenaAllocator(const AsyncArenaAllocator<U, N>& other) noexcept : _arena(other.arena()) {}
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(_arena ? _arena->allocate(n * sizeof(T), alignof(T)) : ::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n __attribute__((unused))) {
+      if (_arena)
+        _arena->deallocate(p);
+      else
+        ::operator delete(p);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new ((void*)p) U(std::forward<Args>(args)...); }
+    template <typename U>
+    void destroy(U* p) { p->~U(); }
+    size_t max_size() const noexcept { return SIZE_MAX / sizeof(T); }
+
+    AsyncBumpArena<N>* arena() const noexcept { return _arena; }
+
+    template <typename U>
+    bool operator==(const AsyncArenaAllocator<U, N>& other) const noexcept { return _arena == other.arena(); }
+    template <typename U>
+    bool operator!=(const AsyncArenaAllocator<U, N>& other) const noexcept { return _arena != other.arena(); }
+};
+
+#endif
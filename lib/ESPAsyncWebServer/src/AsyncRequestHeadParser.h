@@ -0,0 +1,342 @@
+#ifndef ASYNCREQUESTHEADPARSER_H
+#define ASYNCREQUESTHEADPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+// Slice of the request head. It points into the received segment, or into the
+// parser carry buffer when the line straddled two segments. Not NUL-terminated.
+struct AsyncHeadView {
+    const char* data;
+    size_t length;
+
+    bool equals(const char* str) const { return strlen(str) == length && memcmp(data, str, length) == 0; }
+    bool equalsIgnoreCase(const char* str) const { return strlen(str) == length && strncasecmp(data, str, length) == 0; }
+    bool startsWith(const char* str) const {
+      size_t n = strlen(str);
+      return n <= length && memcmp(data, str, n) == 0;
+    }
+    bool containsIgnoreCase(const char* str) const {
+      size_t n = strlen(str);
+      for (size_t i = 0; i + n <= length; i++) {
+        if (strncasecmp(data + i, str, n) == 0)
+          return true;
+      }
+      return false;
+    }
+    // position of c at or after from, length if absent
+    size_t indexOf(char c, size_t from = 0) const {
+      for (size_t i = from; i < length; i++) {
+        if (data[i] == c)
+          return i;
+      }
+      return length;
+    }
+    AsyncHeadView substring(size_t from, size_t to) const { return AsyncHeadView{data + from, to - from}; }
+};
+
+// Single-pass tokenizer for the request line and headers. Each byte is looked
+// at once by a small state machine that records where the tokens of the
+// current line start and end; nothing is copied while a line lies inside one
+// segment. The bytes of a line split across segments are gathered in a carry
+// buffer, which is the only copy the parser makes.
+class AsyncRequestHeadParser {
+  public:
+    enum Event {
+      NEED_MORE,    // the segment ended inside a line
+      REQUEST_LINE, // method(), target() and version() are set
+      HEADER,       // name() and value() are set
+      HEAD_END,     // empty line: the body, if any, follows
+      FAILED        // malformed request line or NUL byte
+    };
+
+    AsyncRequestHeadParser() : _state(_METHOD), _carry(nullptr), _carryLength(0), _carryCapacity(0) { _resetLine(); }
+    ~AsyncRequestHeadParser() { free(_carry); }
+    AsyncRequestHeadParser(const AsyncRequestHeadParser&) = delete;
+    AsyncRequestHeadParser& operator=(const AsyncRequestHeadParser&) = delete;
+
+    // Scans data up to the end of the next request line or header and returns
+    // the number of bytes consumed. Header lines without a colon are skipped.
+    // The views of the reported line are only valid until the next call, as
+    // they may point into data.
+    size_t parse(const char* data, size_t length, Event& event) {
+      size_t lineStart = 0;
+      size_t i = 0;
+      while (i < length) {
+        const char* newline = (const char*)memchr(data + i, '\n', length - i);
+        size_t lineEnd = newline ? newline - data : length;
+        // a NUL in the head is rejected, as it would cut the header strings
+        if (_state == _DONE || strnlen(data + i, lineEnd - i) != lineEnd - i) {
+          event = FAILED;
+          return i;
+        }
+        // only the bytes before the last token of the line need the state
+        // machine; that token is trimmed when the line ends
+        for (; i < lineEnd && _state != _VERSION && _state != _VALUE; i++)
+          _step(data[i], _carryLength + i - lineStart);
+        if (!newline)
+          break;
+        const char* line = data + lineStart;
+        size_t lineLength = _carryLength + lineEnd - lineStart;
+        if (_carryLength) {
+          if (!_append(data, lineEnd)) {
+            event = FAILED;
+            return lineEnd;
+          }
+          line = _carry;
+        }
+        event = _endLine(line, lineLength);
+        i = lineEnd + 1;
+        if (event != NEED_MORE)
+          return i;
+        lineStart = i;
+      }
+      event = _append(data + lineStart, length - lineStart) ? NEED_MORE : FAILED;
+      return length;
+    }
+
+    const AsyncHeadView& method() const { return _views[0]; }
+    const AsyncHeadView& target() const { return _views[1]; }
+    const AsyncHeadView& version() const { return _views[2]; }
+    const AsyncHeadView& name() const { return _views[0]; }
+    const AsyncHeadView& value() const { return _views[1]; }
+
+  private:
+    enum State : uint8_t {
+      _METHOD,
+      _TARGET,
+      _VERSION,
+      _NAME,
+      _VALUE_START,
+      _VALUE,
+      _DONE
+    };
+
+    uint8_t _state;
+    // token boundaries as offsets in the current line
+    size_t _start[3];
+    size_t _end[3];
+    AsyncHeadView _views[3];
+    char* _carry;
+    size_t _carryLength;
+    size_t _carryCapacity;
+
+    static bool _isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    void _resetLine() {
+      for (size_t i = 0; i < 3; i++)
+        _start[i] = _end[i] = 0;
+    }
+
+    void _step(char c, size_t position) {
+      switch (_state) {
+        case _METHOD:
+          if (c == ' ') {
+            _end[0] = position;
+            _start[1] = position + 1;
+            _state = _TARGET;
+          }
+          break;
+        case _TARGET:
+          if (c == ' ') {
+            _end[1] = position;
+            _start[2] = position + 1;
+            _state = _VERSION;
+          }
+          break;
+        case _NAME:
+          if (c == ':') {
+            _end[0] = position;
+            _start[1] = position + 1;
+            _state = _VALUE_START;
+          }
+          break;
+        case _VALUE_START:
+          if (_isSpace(c))
+            _start[1] = position + 1;
+          else
+            _state = _VALUE;
+          break;
+        default:
+          break;
+      }
+    }
+
+    Event _endLine(const char* line, size_t length) {
+      while (length && _isSpace(line[length - 1]))
+        length--;
+      Event event = NEED_MORE;
+      if (_state <= _VERSION) {
+        // "METHOD target version", with both spaces and a non-empty target
+        if (_state == _VERSION && _end[0] > 0 && _end[1] > _start[1]) {
+          _end[2] = length > _start[2] ? length : _start[2];
+          event = REQUEST_LINE;
+          _state = _NAME;
+        } else {
+          event = FAILED;
+          _state = _DONE;
+        }
+      } else if (_state == _NAME) {
+        if (!length) {
+          event = HEAD_END;
+          _state = _DONE;
+        }
+      } else {
+        _end[1] = length > _start[1] ? length : _start[1];
+        event = HEADER;
+        _state = _NAME;
+      }
+      for (size_t i = 0; i < 3; i++)
+        _views[i] = AsyncHeadView{line + _start[i], _end[i] - _start[i]};
+      _carryLength = 0;
+      _resetLine();
+      if (_state == _DONE) {
+        free(_carry);
+        _carry = nullptr;
+        _carryCapacity = 0;
+      }
+      return event;
+    }
+
+    bool _append(const char* data, size_t length) {
+      if (!length)
+        return true;
+      if (_carryLength + length > _carryCapacity) {
+        size_t capacity = _carryCapacity ? _carryCapacity * 2 : 64;
+        while (capacity < _carryLength + length)
+          capacity *= 2;
+        char* carry = (char*)realloc(_carry, capacity);
+        if (!carry)
+          return false;
+        _carry = carry;
+        _carryCapacity = capacity;
+      }
+      memcpy(_carry + _carryLength, data, length);
+      _carryLength += length;
+      return true;
+    }
+};
+
+// Request headers as they arrived: name and value back to back in a single
+// buffer, behind a small entry record. T objects (AsyncWebHeader) are built
+// only for the headers someone asks for, so the common request that reads two
+// or three of them no longer pays two Strings for each of the fifteen a
+// browser sends.
+template <typename T>
+class AsyncRawHeaders {
+  public:
+    struct Entry {
+        T* header; // materialized copy, once asked for
+        uint16_t nameLength;
+        uint16_t valueLength;
+        bool removed;
+
+        const char* name() const { return reinterpret_cast<const char*>(this + 1); }
+        const char* value() const { return name() + nameLength + 1; }
+        bool is(const char* other) const { return strcasecmp(name(), other) == 0; }
+    };
+
+    AsyncRawHeaders() : _buffer(nullptr), _length(0), _capacity(0), _count(0) {}
+    ~AsyncRawHeaders() { free(_buffer); }
+    AsyncRawHeaders(const AsyncRawHeaders&) = delete;
+    AsyncRawHeaders& operator=(const AsyncRawHeaders&) = delete;
+
+    bool add(const char* name, size_t nameLength, const char* value, size_t valueLength) {
+      if (nameLength > UINT16_MAX || valueLength > UINT16_MAX)
+        return false;
+      size_t size = _stride(nameLength, valueLength);
+      if (_length + size > _capacity) {
+        size_t capacity = _capacity ? _capacity * 2 : _initialCapacity;
+        while (capacity < _length + size)
+          capacity *= 2;
+        uint8_t* buffer = (uint8_t*)realloc(_buffer, capacity);
+        if (!buffer)
+          return false;
+        _buffer = buffer;
+        _capacity = capacity;
+      }
+      Entry* entry = reinterpret_cast<Entry*>(_buffer + _length);
+      entry->header = nullptr;
+      entry->nameLength = nameLength;
+      entry->valueLength = valueLength;
+      entry->removed = false;
+      char* text = reinterpret_cast<char*>(entry + 1);
+      memcpy(text, name, nameLength);
+      text[nameLength] = 0;
+      memcpy(text + nameLength + 1, value, valueLength);
+      text[nameLength + 1 + valueLength] = 0;
+      _length += size;
+      _count++;
+      return true;
+    }
+
+    // iteration over the entries that were not removed:
+    // for (Entry* e = first(); e; e = next(e))
+    Entry* first() const { return _skipRemoved(0); }
+    Entry* next(const Entry* entry) const {
+      return _skipRemoved((const uint8_t*)entry - _buffer + _stride(entry->nameLength, entry->valueLength));
+    }
+
+    Entry* find(const char* name) const {
+      for (Entry* e = first(); e; e = next(e)) {
+        if (e->is(name))
+          return e;
+      }
+      return nullptr;
+    }
+
+    Entry* at(size_t index) const {
+      for (Entry* e = first(); e; e = next(e)) {
+        if (!index--)
+          return e;
+      }
+      return nullptr;
+    }
+
+    size_t remove(const char* name) {
+      size_t removed = 0;
+      for (Entry* e = first(); e; e = next(e)) {
+        if (e->is(name)) {
+          e->removed = true;
+          removed++;
+        }
+      }
+      _count -= removed;
+      return removed;
+    }
+
+    void clear() {
+      free(_buffer);
+      _buffer = nullptr;
+      _length = _capacity = _count = 0;
+    }
+
+    size_t count() const { return _count; }
+
+  private:
+    static constexpr size_t _initialCapacity = 512;
+    uint8_t* _buffer;
+    size_t _length;
+    size_t _capacity;
+    size_t _count;
+
+    static size_t _stride(size_t nameLength, size_t valueLength) {
+      size_t size = sizeof(Entry) + nameLength + valueLength + 2;
+      return (size + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+    }
+
+    Entry* _skipRemoved(size_t offset) const {
+      while (offset < _length) {
+        Entry* entry = reinterpret_cast<Entry*>(_buffer + offset);
+        if (!entry->removed)
+          return entry;
+        offset += _stride(entry->nameLength, entry->valueLength);
+      }
+      return nullptr;
+    }
+};
+
+#endif
@@ -1135,6 +1135,10 @@ bool AsyncWebSocket::canHandle(AsyncWebServerRequest* request) const {
   return _enabled && request->isWebSocketUpgrade() && request->url().equals(_url);
 }
 
+bool AsyncWebSocket::isInterestingHeader(const AsyncHeadView& name) const {
+  return name.equalsIgnoreCase(__WS_STR_VERSION) || name.equalsIgnoreCase(__WS_STR_KEY) || name.equalsIgnoreCase(__WS_STR_PROTOCOL) || AsyncWebHandler::isInterestingHeader(name);
+}
+
 void AsyncWebSocket::handleRequest(AsyncWebServerRequest* request) {
   if (!request->hasHeader(WS_STR_VERSION) || !request->hasHeader(WS_STR_KEY)) {
     request->send(400);
@@ -353,6 +353,7 @@ class AsyncWebSocket : public AsyncWebHandler {
     void _handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
     bool canHandle(AsyncWebServerRequest* request) const override final;
     void handleRequest(AsyncWebServerRequest* request) override final;
+    bool isInterestingHeader(const AsyncHeadView& name) const override final;
 
     //  messagebuffer functions/objects.
     AsyncWebSocketMessageBuffer* makeBuffer(size_t size = 0);
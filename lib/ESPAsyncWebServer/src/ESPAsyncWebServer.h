@@ -46,6 +46,8 @@
   #error Platform not supported
 #endif
 
+#include "AsyncRequestArena.h"
+#include "AsyncRequestHeadParser.h"
 #include "literals.h"
 
 #define ASYNCWEBSERVER_VERSION          "3.6.0"
@@ -152,6 +154,15 @@ class AsyncWebHeader {
     String toString() const;
 };
 
+#if ASYNCWEBSERVER_REQUEST_ARENA_SIZE > 0
+typedef AsyncBumpArena<ASYNCWEBSERVER_REQUEST_ARENA_SIZE> AsyncRequestArena;
+typedef std::list<AsyncWebHeader, AsyncArenaAllocator<AsyncWebHeader, ASYNCWEBSERVER_REQUEST_ARENA_SIZE>> AsyncWebHeaderList;
+typedef std::list<AsyncWebParameter, AsyncArenaAllocator<AsyncWebParameter, ASYNCWEBSERVER_REQUEST_ARENA_SIZE>> AsyncWebParameterList;
+#else
+typedef std::list<AsyncWebHeader> AsyncWebHeaderList;
+typedef std::list<AsyncWebParameter> AsyncWebParameterList;
+#endif
+
 /*
  * REQUEST :: Each incoming Client is wrapped inside a Request and both live together until disconnect
  * */
@@ -210,8 +221,18 @@ class AsyncWebServerRequest {
     size_t _contentLength;
     size_t _parsedLength;
 
-    std::list<AsyncWebHeader> _headers;
-    std::list<AsyncWebParameter> _params;
+    AsyncRequestHeadParser _head;
+    // headers as received; _headers only holds the ones that were asked for
+    AsyncRawHeaders<AsyncWebHeader> _rawHeaders;
+#if ASYNCWEBSERVER_REQUEST_ARENA_SIZE > 0
+    // backs the list nodes below, declared first so that it outlives them
+    AsyncRequestArena _arena;
+    mutable AsyncWebHeaderList _headers{AsyncWebHeaderList::allocator_type(&_arena)};
+    AsyncWebParameterList _params{AsyncWebParameterList::allocator_type(&_arena)};
+#else
+    mutable AsyncWebHeaderList _headers;
+    AsyncWebParameterList _params;
+#endif
     std::vector<String> _pathParams;
 
     std::unordered_map<const char*, String, std::hash<const char*>, std::equal_to<const char*>> _attributes;
@@ -239,10 +260,13 @@ class AsyncWebServerRequest {
 
     bool _parseReqHead();
     bool _parseReqHeader();
-    void _parseLine();
+    void _parseLine(AsyncRequestHeadParser::Event event);
     void _parsePlainPostChar(uint8_t data);
     void _parseMultipartPostByte(uint8_t data, bool last);
-    void _addGetParams(const String& params);
+    void _addGetParams(const AsyncHeadView& params);
+    void _addGetParams(const String& params) { _addGetParams(AsyncHeadView{params.c_str(), params.length()}); }
+    String _urlDecode(const char* text, size_t len) const;
+    const AsyncWebHeader* _materializeHeader(AsyncRawHeaders<AsyncWebHeader>::Entry* entry) const;
 
     void _handleUploadStart();
     void _handleUploadByte(uint8_t data, bool last);
@@ -285,12 +309,12 @@ class AsyncWebServerRequest {
     void setHandler(AsyncWebHandler* handler) { _handler = handler; }
 
 #ifndef ESP8266
-    [[deprecated("All headers are now collected. Use removeHeader(name) or AsyncHeaderFreeMiddleware if you really need to free some headers.")]]
+    [[deprecated("Declare the header on the handler or the server: AsyncWebHandler::addInterestingHeader(name) or AsyncWebServer::addInterestingHeader(name).")]]
 #endif
     void addInterestingHeader(__unused const char* name) {
     }
 #ifndef ESP8266
-    [[deprecated("All headers are now collected. Use removeHeader(name) or AsyncHeaderFreeMiddleware if you really need to free some headers.")]]
+    [[deprecated("Declare the header on the handler or the server: AsyncWebHandler::addInterestingHeader(name) or AsyncWebServer::addInterestingHeader(name).")]]
 #endif
     void addInterestingHeader(__unused const String& name) {
     }
@@ -462,7 +486,8 @@ class AsyncWebServerRequest {
 
     const AsyncWebHeader* getHeader(size_t num) const;
 
-    const std::list<AsyncWebHeader>& getHeaders() const { return _headers; }
+    // builds every header that was not asked for yet
+    const AsyncWebHeaderList& getHeaders() const;
 
     size_t getHeaderNames(std::vector<const char*>& names) const;
 
@@ -470,7 +495,10 @@ class AsyncWebServerRequest {
     // It will free the memory and prevent the header to be seen during request processing.
     bool removeHeader(const char* name);
     // Remove all request headers.
-    void removeHeaders() { _headers.clear(); }
+    void removeHeaders() {
+      _headers.clear();
+      _rawHeaders.clear();
+    }
 
     size_t params() const; // get arguments count
     bool hasParam(const char* name, bool post = false, bool file = false) const;
@@ -522,6 +550,8 @@ class AsyncMiddleware {
   public:
     virtual ~AsyncMiddleware() {}
     virtual void run(__unused AsyncWebServerRequest* request, __unused ArMiddlewareNext next) { return next(); };
+    // true if run() reads the request header name, so the parser keeps it
+    virtual bool isInterestingHeader(__unused const AsyncHeadView& name) const { return false; }
 
   private:
     friend class AsyncWebHandler;
@@ -555,6 +585,10 @@ class AsyncMiddlewareChain {
 
   protected:
     std::list<AsyncMiddleware*> _middlewares;
+    std::vector<const char*> _interestingHeaders;
+
+    // true if name was declared on this chain or one of its middlewares reads it
+    bool _hasInterestIn(const AsyncHeadView& name) const;
 };
 
 // AsyncAuthenticationMiddleware is a middleware that checks if the request is authenticated
@@ -621,6 +655,7 @@ class AsyncHeaderFreeMiddleware : public AsyncMiddleware {
     void unKeep(const char* name) { _toKeep.erase(std::remove(_toKeep.begin(), _toKeep.end(), name), _toKeep.end()); }
 
     void run(AsyncWebServerRequest* request, ArMiddlewareNext next);
+    bool isInterestingHeader(const AsyncHeadView& name) const override;
 
   private:
     std::vector<const char*> _toKeep;
@@ -646,6 +681,8 @@ class AsyncLoggingMiddleware : public AsyncMiddleware {
     bool isEnabled() const { return _enabled && _out; }
 
     void run(AsyncWebServerRequest* request, ArMiddlewareNext next);
+    // the log prints every header
+    bool isInterestingHeader(__unused const AsyncHeadView& name) const override { return isEnabled(); }
 
   private:
     Print* _out = nullptr;
@@ -664,6 +701,7 @@ class AsyncCorsMiddleware : public AsyncMiddleware {
     void addCORSHeaders(AsyncWebServerResponse* response);
 
     void run(AsyncWebServerRequest* request, ArMiddlewareNext next);
+    bool isInterestingHeader(const AsyncHeadView& name) const override { return name.equalsIgnoreCase(asyncsrv::T_CORS_O); }
 
   private:
     String _origin = "*";
@@ -735,6 +773,10 @@ class AsyncWebHandler : public AsyncMiddlewareChain {
     AsyncWebHandler& setFilter(ArRequestFilterFunction fn);
     AsyncWebHandler& setAuthentication(const char* username, const char* password, AsyncAuthType authMethod = AsyncAuthType::AUTH_DIGEST);
     AsyncWebHandler& setAuthentication(const String& username, const String& password, AsyncAuthType authMethod = AsyncAuthType::AUTH_DIGEST) { return setAuthentication(username.c_str(), password.c_str(), authMethod); };
+    // Request headers the handler reads: when the server does not collect all
+    // headers, the others are dropped while parsing. name must outlive the handler.
+    AsyncWebHandler& addInterestingHeader(const char* name);
+    virtual bool isInterestingHeader(const AsyncHeadView& name) const { return _hasInterestIn(name); }
     bool filter(AsyncWebServerRequest* request) { return _filter == NULL || _filter(request); }
     virtual bool canHandle(AsyncWebServerRequest* request __attribute__((unused))) const { return false; }
     virtual void handleRequest(__unused AsyncWebServerRequest* request) {}
@@ -821,6 +863,7 @@ class AsyncWebServer : public AsyncMiddlewareChain {
     std::list<std::shared_ptr<AsyncWebRewrite>> _rewrites;
     std::list<std::unique_ptr<AsyncWebHandler>> _handlers;
     AsyncCallbackWebHandler* _catchAllHandler;
+    bool _collectAllHeaders = true;
 
   public:
     AsyncWebServer(uint16_t port);
@@ -889,9 +932,21 @@ class AsyncWebServer : public AsyncMiddlewareChain {
 
     void reset(); // remove all writers and handlers, with onNotFound/onFileUpload/onRequestBody
 
+    /**
+     * @brief keep a request header for every handler; name must outlive the server
+     */
+    void addInterestingHeader(const char* name) { _interestingHeaders.push_back(name); }
+
+    /**
+     * @brief collect every request header (the default), or only the ones declared with
+     * addInterestingHeader() on the server or a handler, or read by a middleware
+     */
+    void setCollectAllHeaders(bool collect) { _collectAllHeaders = collect; }
+
     void _handleDisconnect(AsyncWebServerRequest* request);
     void _attachHandler(AsyncWebServerRequest* request);
     void _rewriteRequest(AsyncWebServerRequest* request);
+    bool _isInterestingHeader(const AsyncHeadView& name) const;
 };
 
 class DefaultHeaders {
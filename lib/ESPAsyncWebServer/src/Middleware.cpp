@@ -53,6 +53,18 @@ void AsyncMiddlewareChain::_runChain(AsyncWebServerRequest* request, ArMiddlewar
   return next();
 }
 
+bool AsyncMiddlewareChain::_hasInterestIn(const AsyncHeadView& name) const {
+  for (const char* h : _interestingHeaders) {
+    if (name.equalsIgnoreCase(h))
+      return true;
+  }
+  for (const AsyncMiddleware* m : _middlewares) {
+    if (m->isInterestingHeader(name))
+      return true;
+  }
+  return false;
+}
+
 void AsyncAuthenticationMiddleware::setUsername(const char* username) {
   _username = username;
   _hasCreds = _username.length() && _credentials.length();
@@ -112,6 +124,14 @@ void AsyncAuthenticationMiddleware::run(AsyncWebServerRequest* request, ArMiddle
   return allowed(request) ? next() : request->requestAuthentication(_authMethod, _realm.c_str(), _authFailMsg.c_str());
 }
 
+bool AsyncHeaderFreeMiddleware::isInterestingHeader(const AsyncHeadView& name) const {
+  for (const char* k : _toKeep) {
+    if (name.equalsIgnoreCase(k))
+      return true;
+  }
+  return false;
+}
+
 void AsyncHeaderFreeMiddleware::run(AsyncWebServerRequest* request, ArMiddlewareNext next) {
   std::vector<const char*> reqHeaders;
   request->getHeaderNames(reqHeaders);
@@ -53,6 +53,7 @@ class AsyncStaticWebHandler : public AsyncWebHandler {
     AsyncStaticWebHandler(const char* uri, FS& fs, const char* path, const char* cache_control);
     bool canHandle(AsyncWebServerRequest* request) const override final;
     void handleRequest(AsyncWebServerRequest* request) override final;
+    bool isInterestingHeader(const AsyncHeadView& name) const override final;
     AsyncStaticWebHandler& setTryGzipFirst(bool value);
     AsyncStaticWebHandler& setIsDir(bool isDir);
     AsyncStaticWebHandler& setDefaultFile(const char* filename);
@@ -27,6 +27,10 @@ AsyncWebHandler& AsyncWebHandler::setFilter(ArRequestFilterFunction fn) {
   _filter = fn;
   return *this;
 }
+AsyncWebHandler& AsyncWebHandler::addInterestingHeader(const char* name) {
+  _interestingHeaders.push_back(name);
+  return *this;
+}
 AsyncWebHandler& AsyncWebHandler::setAuthentication(const char* username, const char* password, AsyncAuthType authMethod) {
   if (!_authMiddleware) {
     _authMiddleware = new AsyncAuthenticationMiddleware();
@@ -114,6 +118,11 @@ bool AsyncStaticWebHandler::canHandle(AsyncWebServerRequest* request) const {
   return request->isHTTP() && request->method() == HTTP_GET && request->url().startsWith(_uri) && _getFile(request);
 }
 
+bool AsyncStaticWebHandler::isInterestingHeader(const AsyncHeadView& name) const {
+  // conditional GET against the ETag and Last-Modified sent with the files
+  return name.equalsIgnoreCase(T_INM) || name.equalsIgnoreCase(T_IMS) || AsyncWebHandler::isInterestingHeader(name);
+}
+
 bool AsyncStaticWebHandler::_getFile(AsyncWebServerRequest* request) const {
   // Remove the found uri
   String path = request->url().substring(_uri.length());
@@ -79,40 +79,18 @@ void AsyncWebServerRequest::_onData(void* buf, size_t len) {
   }
 #endif
 
-  size_t i = 0;
   while (true) {
 
     if (_parseState < PARSE_REQ_BODY) {
-      // Find new line in buf
-      char* str = (char*)buf;
-      for (i = 0; i < len; i++) {
-        // Check for null characters in header
-        if (!str[i]) {
-          _parseState = PARSE_REQ_FAIL;
-          _client->abort();
-          return;
-        }
-        if (str[i] == '\n') {
-          break;
-        }
-      }
-      if (i == len) { // No new line, just add the buffer in _temp
-        char ch = str[len - 1];
-        str[len - 1] = 0;
-        _temp.reserve(_temp.length() + len);
-        _temp.concat(str);
-        _temp.concat(ch);
-      } else {      // Found new line - extract it and parse
-        str[i] = 0; // Terminate the string at the end of the line.
-        _temp.concat(str);
-        _temp.trim();
-        _parseLine();
-        if (++i < len) {
-          // Still have more buffer to process
-          buf = str + i;
-          len -= i;
-          continue;
-        }
+      // Tokenize the head in place; the parser copies only lines split across segments
+      AsyncRequestHeadParser::Event event;
+      size_t used = _head.parse((const char*)buf, len, event);
+      _parseLine(event);
+      if (_parseState != PARSE_REQ_FAIL && used < len) {
+        // Still have more buffer to process
+        buf = (uint8_t*)buf + used;
+        len -= used;
+        continue;
       }
     } else if (_parseState == PARSE_REQ_BODY) {
       // A handler should be already attached at this point in _parseLine function.
@@ -228,128 +206,115 @@ void AsyncWebServerRequest::_addPathParam(const char* p) {
   _pathParams.emplace_back(p);
 }
 
-void AsyncWebServerRequest::_addGetParams(const String& params) {
+void AsyncWebServerRequest::_addGetParams(const AsyncHeadView& params) {
   size_t start = 0;
-  while (start < params.length()) {
-    int end = params.indexOf('&', start);
-    if (end < 0)
-      end = params.length();
-    int equal = params.indexOf('=', start);
-    if (equal < 0 || equal > end)
+  while (start < params.length) {
+    size_t end = params.indexOf('&', start);
+    size_t equal = params.indexOf('=', start);
+    if (equal > end)
       equal = end;
-    String name(params.substring(start, equal));
-    String value(equal + 1 < end ? params.substring(equal + 1, end) : String());
-    _params.emplace_back(urlDecode(name), urlDecode(value));
+    String name(_urlDecode(params.data + start, equal - start));
+    String value(equal + 1 < end ? _urlDecode(params.data + equal + 1, end - equal - 1) : String());
+    _params.emplace_back(name, value);
     start = end + 1;
   }
 }
 
 bool AsyncWebServerRequest::_parseReqHead() {
-  // Split the head into method, url and version
-  int index = _temp.indexOf(' ');
-  String m = _temp.substring(0, index);
-  index = _temp.indexOf(' ', index + 1);
-  String u = _temp.substring(m.length() + 1, index);
-  _temp = _temp.substring(index + 1);
-
-  if (m == T_GET) {
+  // Method, url and version were split by the parser
+  const AsyncHeadView& m = _head.method();
+  if (m.equals(T_GET)) {
     _method = HTTP_GET;
-  } else if (m == T_POST) {
+  } else if (m.equals(T_POST)) {
     _method = HTTP_POST;
-  } else if (m == T_DELETE) {
+  } else if (m.equals(T_DELETE)) {
     _method = HTTP_DELETE;
-  } else if (m == T_PUT) {
+  } else if (m.equals(T_PUT)) {
     _method = HTTP_PUT;
-  } else if (m == T_PATCH) {
+  } else if (m.equals(T_PATCH)) {
     _method = HTTP_PATCH;
-  } else if (m == T_HEAD) {
+  } else if (m.equals(T_HEAD)) {
     _method = HTTP_HEAD;
-  } else if (m == T_OPTIONS) {
+  } else if (m.equals(T_OPTIONS)) {
     _method = HTTP_OPTIONS;
   } else {
     return false;
   }
 
-  String g;
-  index = u.indexOf('?');
-  if (index > 0) {
-    g = u.substring(index + 1);
-    u = u.substring(0, index);
-  }
-  _url = urlDecode(u);
-  _addGetParams(g);
+  const AsyncHeadView& u = _head.target();
+  size_t index = u.indexOf('?');
+  if (index == 0)
+    index = u.length;
+  _url = _urlDecode(u.data, index);
+  if (index < u.length)
+    _addGetParams(u.substring(index + 1, u.length));
 
   if (!_url.length())
     return false;
 
-  if (!_temp.startsWith(T_HTTP_1_0))
+  if (!_head.version().startsWith(T_HTTP_1_0))
     _version = 1;
 
-  _temp = emptyString;
   return true;
 }
 
+// Copies a view into a String with a single allocation
+static String viewToString(const AsyncHeadView& view) {
+  String str;
+  str.concat(view.data, view.length);
+  return str;
+}
+
 bool AsyncWebServerRequest::_parseReqHeader() {
-  int index = _temp.indexOf(':');
-  if (index) {
-    String name(_temp.substring(0, index));
-    String value(_temp.substring(index + 2));
-    if (name.equalsIgnoreCase(T_Host)) {
-      _host = value;
-    } else if (name.equalsIgnoreCase(T_Content_Type)) {
-      _contentType = value.substring(0, value.indexOf(';'));
-      if (value.startsWith(T_MULTIPART_)) {
-        _boundary = value.substring(value.indexOf('=') + 1);
-        _boundary.replace(String('"'), String());
-        _isMultipart = true;
-      }
-    } else if (name.equalsIgnoreCase(T_Content_Length)) {
-      _contentLength = atoi(value.c_str());
-    } else if (name.equalsIgnoreCase(T_EXPECT) && value.equalsIgnoreCase(T_100_CONTINUE)) {
-      _expectingContinue = true;
-    } else if (name.equalsIgnoreCase(T_AUTH)) {
-      int space = value.indexOf(' ');
-      if (space == -1) {
-        _authorization = value;
-        _authMethod = AsyncAuthType::AUTH_OTHER;
+  const AsyncHeadView& name = _head.name();
+  const AsyncHeadView& value = _head.value();
+  if (name.equalsIgnoreCase(T_Host)) {
+    _host = viewToString(value);
+  } else if (name.equalsIgnoreCase(T_Content_Type)) {
+    _contentType = viewToString(value.substring(0, value.indexOf(';')));
+    if (value.startsWith(T_MULTIPART_)) {
+      _boundary = viewToString(value.substring(value.indexOf('=') + 1, value.length));
+      _boundary.replace(String('"'), String());
+      _isMultipart = true;
+    }
+  } else if (name.equalsIgnoreCase(T_Content_Length)) {
+    _contentLength = 0;
+    for (size_t i = 0; i < value.length && isdigit((unsigned char)value.data[i]); i++)
+      _contentLength = _contentLength * 10 + (value.data[i] - '0');
+  } else if (name.equalsIgnoreCase(T_EXPECT) && value.equalsIgnoreCase(T_100_CONTINUE)) {
+    _expectingContinue = true;
+  } else if (name.equalsIgnoreCase(T_AUTH)) {
+    size_t space = value.indexOf(' ');
+    if (space == value.length) {
+      _authorization = viewToString(value);
+      _authMethod = AsyncAuthType::AUTH_OTHER;
+    } else {
+      AsyncHeadView method = value.substring(0, space);
+      if (method.equalsIgnoreCase(T_BASIC)) {
+        _authMethod = AsyncAuthType::AUTH_BASIC;
+      } else if (method.equalsIgnoreCase(T_DIGEST)) {
+        _authMethod = AsyncAuthType::AUTH_DIGEST;
+      } else if (method.equalsIgnoreCase(T_BEARER)) {
+        _authMethod = AsyncAuthType::AUTH_BEARER;
       } else {
-        String method = value.substring(0, space);
-        if (method.equalsIgnoreCase(T_BASIC)) {
-          _authMethod = AsyncAuthType::AUTH_BASIC;
-        } else if (method.equalsIgnoreCase(T_DIGEST)) {
-          _authMethod = AsyncAuthType::AUTH_DIGEST;
-        } else if (method.equalsIgnoreCase(T_BEARER)) {
-          _authMethod = AsyncAuthType::AUTH_BEARER;
-        } else {
-          _authMethod = AsyncAuthType::AUTH_OTHER;
-        }
-        _authorization = value.substring(space + 1);
-      }
-    } else if (name.equalsIgnoreCase(T_UPGRADE) && value.equalsIgnoreCase(T_WS)) {
-      // WebSocket request can be uniquely identified by header: [Upgrade: websocket]
-      _reqconntype = RCT_WS;
-    } else if (name.equalsIgnoreCase(T_ACCEPT)) {
-      String lowcase(value);
-      lowcase.toLowerCase();
-#ifndef ESP8266
-      const char* substr = std::strstr(lowcase.c_str(), T_text_event_stream);
-#else
-      const char* substr = std::strstr(lowcase.c_str(), String(T_text_event_stream).c_str());
-#endif
-      if (substr != NULL) {
-        // WebEvent request can be uniquely identified by header:  [Accept: text/event-stream]
-        _reqconntype = RCT_EVENT;
+        _authMethod = AsyncAuthType::AUTH_OTHER;
       }
+      _authorization = viewToString(value.substring(space + 1, value.length));
+    }
+  } else if (name.equalsIgnoreCase(T_UPGRADE) && value.equalsIgnoreCase(T_WS)) {
+    // WebSocket request can be uniquely identified by header: [Upgrade: websocket]
+    _reqconntype = RCT_WS;
+  } else if (name.equalsIgnoreCase(T_ACCEPT)) {
+    if (value.containsIgnoreCase(T_text_event_stream)) {
+      // WebEvent request can be uniquely identified by header:  [Accept: text/event-stream]
+      _reqconntype = RCT_EVENT;
     }
-    _headers.emplace_back(name, value);
   }
-#ifndef TARGET_RP2040
-  _temp.clear();
-#else
-  // Ancient PRI core does not have String::clear() method 8-()
-  _temp = emptyString;
-#endif
-  return true;
+  // Nobody reads it: drop it before it takes any memory
+  if (!_server->_isInterestingHeader(name))
+    return true;
+  // Kept raw; an AsyncWebHeader is built only if a handler asks for it
+  return _rawHeaders.add(name.data, name.length, value.data, value.length);
 }
 
 void AsyncWebServerRequest::_parsePlainPostChar(uint8_t data) {
@@ -585,24 +550,21 @@ void AsyncWebServerRequest::_parseMultipartPostByte(uint8_t data, bool last) {
   }
 }
 
-void AsyncWebServerRequest::_parseLine() {
-  if (_parseState == PARSE_REQ_START) {
-    if (!_temp.length()) {
-      _parseState = PARSE_REQ_FAIL;
-      _client->abort();
-    } else {
-      if (_parseReqHead()) {
+void AsyncWebServerRequest::_parseLine(AsyncRequestHeadParser::Event event) {
+  switch (event) {
+    case AsyncRequestHeadParser::NEED_MORE:
+      return;
+    case AsyncRequestHeadParser::REQUEST_LINE:
+      if (_parseState == PARSE_REQ_START && _parseReqHead()) {
         _parseState = PARSE_REQ_HEADERS;
-      } else {
-        _parseState = PARSE_REQ_FAIL;
-        _client->abort();
+        return;
       }
-    }
-    return;
-  }
-
-  if (_parseState == PARSE_REQ_HEADERS) {
-    if (!_temp.length()) {
+      break;
+    case AsyncRequestHeadParser::HEADER:
+      if (_parseReqHeader())
+        return;
+      break;
+    case AsyncRequestHeadParser::HEAD_END:
       // end of headers
       _server->_rewriteRequest(this);
       _server->_attachHandler(this);
@@ -625,22 +587,20 @@ void AsyncWebServerRequest::_parseLine() {
           _sent = true;
         }
       }
-    } else
-      _parseReqHeader();
+      return;
+    default:
+      break;
   }
+  _parseState = PARSE_REQ_FAIL;
+  _client->abort();
 }
 
 size_t AsyncWebServerRequest::headers() const {
-  return _headers.size();
+  return _rawHeaders.count();
 }
 
 bool AsyncWebServerRequest::hasHeader(const char* name) const {
-  for (const auto& h : _headers) {
-    if (h.name().equalsIgnoreCase(name)) {
-      return true;
-    }
-  }
-  return false;
+  return _rawHeaders.find(name) != nullptr;
 }
 
 #ifdef ESP8266
@@ -649,9 +609,18 @@ bool AsyncWebServerRequest::hasHeader(const __FlashStringHelper* data) const {
 }
 #endif
 
+const AsyncWebHeader* AsyncWebServerRequest::_materializeHeader(AsyncRawHeaders<AsyncWebHeader>::Entry* entry) const {
+  if (!entry)
+    return nullptr;
+  if (!entry->header) {
+    _headers.emplace_back(entry->name(), entry->value());
+    entry->header = &_headers.back();
+  }
+  return entry->header;
+}
+
 const AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const {
-  auto iter = std::find_if(std::begin(_headers), std::end(_headers), [&name](const AsyncWebHeader& header) { return header.name().equalsIgnoreCase(name); });
-  return (iter == std::end(_headers)) ? nullptr : &(*iter);
+  return _materializeHeader(_rawHeaders.find(name));
 }
 
 #ifdef ESP8266
@@ -671,24 +640,27 @@ const AsyncWebHeader* AsyncWebServerRequest::getHeader(const __FlashStringHelper
 #endif
 
 const AsyncWebHeader* AsyncWebServerRequest::getHeader(size_t num) const {
-  if (num >= _headers.size())
-    return nullptr;
-  return &(*std::next(_headers.cbegin(), num));
+  return _materializeHeader(_rawHeaders.at(num));
+}
+
+const AsyncWebHeaderList& AsyncWebServerRequest::getHeaders() const {
+  for (auto* e = _rawHeaders.first(); e; e = _rawHeaders.next(e))
+    _materializeHeader(e);
+  return _headers;
 }
 
 size_t AsyncWebServerRequest::getHeaderNames(std::vector<const char*>& names) const {
-  const size_t size = _headers.size();
+  const size_t size = _rawHeaders.count();
   names.reserve(size);
-  for (const auto& h : _headers) {
-    names.push_back(h.name().c_str());
+  for (auto* e = _rawHeaders.first(); e; e = _rawHeaders.next(e)) {
+    names.push_back(e->name());
   }
   return size;
 }
 
 bool AsyncWebServerRequest::removeHeader(const char* name) {
-  const size_t size = _headers.size();
   _headers.remove_if([name](const AsyncWebHeader& header) { return header.name().equalsIgnoreCase(name); });
-  return size != _headers.size();
+  return _rawHeaders.remove(name) != 0;
 }
 
 size_t AsyncWebServerRequest::params() const {
@@ -941,17 +913,20 @@ const String& AsyncWebServerRequest::headerName(size_t i) const {
 }
 
 String AsyncWebServerRequest::urlDecode(const String& text) const {
+  return _urlDecode(text.c_str(), text.length());
+}
+
+String AsyncWebServerRequest::_urlDecode(const char* text, size_t len) const {
   char temp[] = "0x00";
-  unsigned int len = text.length();
-  unsigned int i = 0;
+  size_t i = 0;
   String decoded;
   decoded.reserve(len); // Allocate the string internal buffer - never longer from source text
   while (i < len) {
     char decodedChar;
-    char encodedChar = text.charAt(i++);
+    char encodedChar = text[i++];
     if ((encodedChar == '%') && (i + 1 < len)) {
-      temp[2] = text.charAt(i++);
-      temp[3] = text.charAt(i++);
+      temp[2] = text[i++];
+      temp[3] = text[i++];
       decodedChar = strtol(temp, NULL, 16);
     } else if (encodedChar == '+') {
       decodedChar = ' ';
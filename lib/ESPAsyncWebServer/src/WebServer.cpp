@@ -157,6 +157,16 @@ void AsyncWebServer::_attachHandler(AsyncWebServerRequest* request) {
   request->setHandler(_catchAllHandler);
 }
 
+bool AsyncWebServer::_isInterestingHeader(const AsyncHeadView& name) const {
+  if (_collectAllHeaders || _hasInterestIn(name) || _catchAllHandler->isInterestingHeader(name))
+    return true;
+  for (auto& h : _handlers) {
+    if (h->isInterestingHeader(name))
+      return true;
+  }
+  return false;
+}
+
 AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody) {
   AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler();
   handler->setUri(uri);
@@ -0,0 +1,59 @@
+# Gera pagina_gz.h a partir de web/index.html antes da compilação.
+#
+# A página vai para a flash já comprimida (gzip) e com um ETag calculado
+# aqui, para que o ESP32 só precise responder 304 quando o navegador já
+# tiver a versão atual em cache.
+
+import gzip
+import hashlib
+import os
+
+Import("env")
+
+origem = os.path.join(env.subst("$PROJECT_DIR"), "web", "index.html")
+destino_dir = os.path.join(env.subst("$BUILD_DIR"), "gerado")
+destino = os.path.join(destino_dir, "pagina_gz.h")
+
+
+def gerar():
+    with open(origem, "rb") as arquivo:
+        html = arquivo.read()
+
+    # mtime=0 deixa a saída determinística: mesmo HTML, mesmo ETag
+    comprimido = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(comprimido).hexdigest()[:16]
+
+    linhas = []
+    for i in range(0, len(comprimido), 16):
+        linhas.append("    " + ", ".join("0x%02x" % b for b in comprimido[i:i + 16]) + ",")
+
+    conteudo = (
+        "// Gerado por scripts/gerar_pagina.py a partir de web/index.html, não editar\n"
+        "#ifndef PAGINA_GZ_H\n"
+        "#define PAGINA_GZ_H\n"
+        "\n"
+        "#include <Arduino.h>\n"
+        "\n"
+        "#define PAGINA_ETAG \"\\\"%s\\\"\"\n"
+        "\n"
+        "static const size_t PAGINA_GZ_TAMANHO = %d;\n"
+        "static const uint8_t PAGINA_GZ[] PROGMEM = {\n"
+        "%s\n"
+        "};\n"
+        "\n"
+        "#endif\n"
+    ) % (etag, len(comprimido), "\n".join(linhas))
+
+    # Só reescreve se mudou, para não forçar a recompilação de main.cpp
+    if os.path.exists(destino):
+        with open(destino, "r") as arquivo:
+            if arquivo.read() == conteudo:
+                return
+    os.makedirs(destino_dir, exist_ok=True)
+    with open(destino, "w") as arquivo:
+        arquivo.write(conteudo)
+    print("Página comprimida: %d -> %d bytes, ETag %s" % (len(html), len(comprimido), etag))
+
+
+gerar()
+env.Append(CPPPATH=[destino_dir])
@@ -0,0 +1,116 @@
+#include "autoajuste.h"
+#include <math.h>
+
+const char *nome_fase_autoajuste(FaseAutoajuste fase) {
+    switch (fase) {
+        case AUTOAJUSTE_OCIOSO: return "ocioso";
+        case AUTOAJUSTE_EM_ANDAMENTO: return "em_andamento";
+        case AUTOAJUSTE_CONCLUIDO: return "concluido";
+        case AUTOAJUSTE_FALHOU: return "falhou";
+        case AUTOAJUSTE_CANCELADO: return "cancelado";
+    }
+    return "?";
+}
+
+AutoajusteRele::AutoajusteRele() : resultado_() {}
+
+void AutoajusteRele::iniciar(float alvo, float histerese, RegraAutoajuste regra, int saida_maxima) {
+    alvo_ = alvo;
+    histerese_ = histerese;
+    saida_maxima_ = saida_maxima;
+    primeira_amostra_ = true;
+    tem_virada_ = false;
+    ciclos_vistos_ = 0;
+    soma_amplitudes_ = 0;
+    soma_periodos_s_ = 0;
+
+    resultado_ = ResultadoAutoajuste();
+    resultado_.fase = AUTOAJUSTE_EM_ANDAMENTO;
+    resultado_.regra = regra;
+}
+
+void AutoajusteRele::cancelar() {
+    if (em_andamento()) {
+        resultado_.fase = AUTOAJUSTE_CANCELADO;
+    }
+}
+
+int AutoajusteRele::passo(float temperatura, unsigned long agora) {
+    if (primeira_amostra_) {
+        primeira_amostra_ = false;
+        inicio_ms_ = agora;
+        resfriando_ = temperatura > alvo_;
+        pico_ = vale_ = temperatura;
+    }
+
+    if (agora - inicio_ms_ > DURACAO_MAXIMA_MS) {
+        resultado_.fase = AUTOAJUSTE_FALHOU; // A oscilação não se estabeleceu
+        return 0;
+    }
+
+    // Os extremos acontecem depois das viradas, pelo atraso da planta, então
+    // são acompanhados no ciclo inteiro
+    pico_ = fmaxf(pico_, temperatura);
+    vale_ = fminf(vale_, temperatura);
+
+    if (resfriando_) {
+        if (temperatura < alvo_ - histerese_) {
+            resfriando_ = false;
+        }
+    } else {
+        if (temperatura > alvo_ + histerese_) {
+            resfriando_ = true;
+
+            // Fecha um ciclo completo: de uma virada para resfriando até esta
+            if (tem_virada_) {
+                ciclos_vistos_++;
+                if (ciclos_vistos_ > CICLOS_DESCARTADOS) {
+                    soma_amplitudes_ += (pico_ - vale_) / 2;
+                    soma_periodos_s_ += (agora - ultima_virada_ms_) / 1000.0f;
+                    resultado_.ciclos = ciclos_vistos_ - CICLOS_DESCARTADOS;
+                }
+            }
+            tem_virada_ = true;
+            ultima_virada_ms_ = agora;
+            pico_ = vale_ = temperatura;
+
+            if (resultado_.ciclos >= CICLOS_MEDIDOS) {
+                concluir();
+                return 0;
+            }
+        }
+    }
+
+    return resfriando_ ? saida_maxima_ : 0;
+}
+
+void AutoajusteRele::concluir() {
+    float amplitude = soma_amplitudes_ / resultado_.ciclos;
+    float periodo = soma_periodos_s_ / resultado_.ciclos;
+
+    // Com histerese, a função descritiva do relé dá Ku = 4d / (π·√(a² − ε²))
+    if (amplitude <= histerese_ || periodo <= 0) {
+        resultado_.fase = AUTOAJUSTE_FALHOU;
+        return;
+    }
+    float d = saida_maxima_ / 2.0f;
+    float ku = 4 * d / (M_PI * sqrtf(amplitude * amplitude - histerese_ * histerese_));
+
+    float kp, ti, td;
+    if (resultado_.regra == REGRA_TYREUS_LUYBEN) {
+        kp = ku / 2.2f;
+        ti = 2.2f * periodo;
+        td = periodo / 6.3f;
+    } else {
+        kp = 0.6f * ku;
+        ti = periodo / 2;
+        td = periodo / 8;
+    }
+
+    resultado_.ku = ku;
+    resultado_.pu_s = periodo;
+    resultado_.kp = kp;
+    resultado_.ki = kp / ti;
+    resultado_.kd = kp * td;
+    resultado_.fase = AUTOAJUSTE_CONCLUIDO;
+}
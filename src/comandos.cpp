@@ -0,0 +1,22 @@
+#include "comandos.h"
+
+static const UBaseType_t TAMANHO_FILA_COMANDOS = 8;
+
+static QueueHandle_t fila_comandos = NULL;
+
+void iniciar_fila_comandos() {
+    fila_comandos = xQueueCreate(TAMANHO_FILA_COMANDOS, sizeof(Comando));
+}
+
+bool enviar_comando(TipoComando tipo, float v0, float v1, float v2, uint8_t canal) {
+    Comando comando = {tipo, {v0, v1, v2}, canal};
+    return enviar_comando(comando);
+}
+
+bool enviar_comando(const Comando &comando) {
+    return xQueueSend(fila_comandos, &comando, 0) == pdTRUE;
+}
+
+bool receber_comando(Comando &comando) {
+    return xQueueReceive(fila_comandos, &comando, 0) == pdTRUE;
+}
@@ -0,0 +1,334 @@
+#include "controlador.h"
+
+Controlador::Controlador(float dt)
+    : alvo_(ALVO_INICIAL), kp_(KP_INICIAL), ki_(KI_INICIAL), kd_(KD_INICIAL),
+      pid_(dt, PWM_MAXIMO, INTEGRAL_MAXIMO), tempo_no_maximo_(0), resfriamento_inicial_(false),
+      limite_atingido_(false), termo_p_(0), termo_i_(0), termo_d_(0), termo_ff_(0),
+      antecipacao_(GANHO_ANTECIPACAO_INICIAL, BASE_ANTECIPACAO_INICIAL, APRENDER_ANTECIPACAO_INICIAL),
+      ligado_(false), periodo_s_(dt), temperatura_(0), recebeu_leitura_(false), temperatura_quente_(NAN), saida_(0), pwm_(0), estado_(ESTADO_DESLIGADO),
+      resolucao_(RESOLUCAO_PADRAO),
+      filtro_(FILTRO_INICIAL, MEDIANA_INICIAL, parametro_padrao_filtro(FILTRO_INICIAL), dt) {
+    pid_.definir_ganhos(kp_, ki_, kd_);
+    pid_.definir_estrutura(PESO_ALVO_P_INICIAL, PESO_ALVO_D_INICIAL, FILTRO_DERIVADA_INICIAL);
+}
+
+void Controlador::resetar() {
+    pid_.reiniciar();
+    tempo_no_maximo_ = 0;
+    limite_atingido_ = false;
+    resfriamento_inicial_ = false;
+    Serial.println("Controlador resetado");
+}
+
+void Controlador::iniciar_resfriamento() {
+    resfriamento_inicial_ = true;
+    pid_.reiniciar();
+    Serial.println("Iniciando resfriamento inicial...");
+}
+
+// Só registra no Serial quando o estado realmente muda
+void Controlador::definir_estado(EstadoControlador novo_estado) {
+    if (novo_estado == estado_) {
+        return;
+    }
+    Serial.printf("Estado: %s -> %s\n", nome_estado(estado_), nome_estado(novo_estado));
+    estado_ = novo_estado;
+}
+
+float Controlador::executar_autoajuste(float temperatura, unsigned long agora) {
+    definir_estado(ESTADO_AUTOAJUSTE);
+    termo_p_ = termo_i_ = termo_d_ = termo_ff_ = 0;
+    int saida = autoajuste_.passo(temperatura, agora);
+    if (autoajuste_.em_andamento()) {
+        return saida;
+    }
+
+    const ResultadoAutoajuste &resultado = autoajuste_.resultado();
+    if (resultado.fase == AUTOAJUSTE_CONCLUIDO) {
+        kp_ = resultado.kp;
+        ki_ = resultado.ki;
+        kd_ = resultado.kd;
+        pid_.definir_ganhos(kp_, ki_, kd_);
+        Serial.printf("Autoajuste concluído: Ku=%.1f Pu=%.0fs -> Kp:%.2f Ki:%.3f Kd:%.1f\n",
+                      resultado.ku, resultado.pu_s, kp_, ki_, kd_);
+    } else {
+        Serial.println("Autoajuste falhou: a oscilação não se estabeleceu");
+    }
+    resetar();
+    return calcular_pid(temperatura, agora);
+}
+
+void Controlador::cancelar_autoajuste(const char *motivo) {
+    if (autoajuste_.em_andamento()) {
+        autoajuste_.cancelar();
+        Serial.printf("Autoajuste cancelado: %s\n", motivo);
+    }
+}
+
+float Controlador::calcular_pid(float temperatura, unsigned long agora) {
+    // CORREÇÃO CRÍTICA: erro = temperatura_atual - setpoint
+    // Positivo = precisa resfriar, Negativo = não precisa resfriar
+    float erro = temperatura - alvo_;
+    termo_p_ = termo_i_ = termo_d_ = termo_ff_ = 0;
+
+    // Se não precisa resfriar (temperatura abaixo do setpoint)
+    if (erro <= 0) {
+        pid_.zerar_integral(); // Evita windup quando não há necessidade de resfriamento
+        resfriamento_inicial_ = false;
+        limite_atingido_ = false;
+        tempo_no_maximo_ = 0;
+        definir_estado(ESTADO_SEM_RESFRIAMENTO);
+        return 0;
+    }
+
+    // Resfriamento inicial
+    if (resfriamento_inicial_) {
+        definir_estado(ESTADO_RESFRIAMENTO_INICIAL);
+        if (erro <= LIMITE_INICIAL) {
+            // Transição suave para PID
+            resfriamento_inicial_ = false;
+            pid_.zerar_integral(); // Bumpless transfer
+        }
+        return PWM_MAXIMO;
+    }
+
+    // Ação antecipatória pelo lado quente, somada antes da saturação
+    bool com_quente = temperatura_quente_ >= TEMPERATURA_MINIMA_VALIDA;
+    if (com_quente) {
+        termo_ff_ = fminf(fmaxf(antecipacao_.calcular(temperatura_quente_, alvo_), 0), PWM_MAXIMO);
+    }
+
+    // Controle PID (dt garantido pela tarefa de controle)
+    NumeroPID saida_pid = pid_.calcular(numero_de_float<NumeroPID>(temperatura), numero_de_float<NumeroPID>(alvo_),
+                                        numero_de_float<NumeroPID>(termo_ff_));
+    float saida = numero_para_float(saida_pid);
+
+    // Deadband para estabilidade
+    EstadoControlador novo_estado = ESTADO_CONTROLE_PID;
+    if (fabsf(erro) <= BANDA_MORTA) {
+        novo_estado = ESTADO_BANDA_MORTA;
+        // Mantém a saída calculada pelo PID, não força zero!
+    }
+
+    // Detectar saturação prolongada
+    if (saida >= PWM_MAXIMO - 1) {
+        if (tempo_no_maximo_ == 0) {
+            tempo_no_maximo_ = agora;
+        } else if (agora - tempo_no_maximo_ > TIMEOUT_LIMITE_MS) {
+            if (!limite_atingido_) {
+                Serial.println("⚠️ LIMITE DO SISTEMA - Setpoint pode ser inatingível!");
+            }
+            limite_atingido_ = true;
+            novo_estado = ESTADO_LIMITE_ATINGIDO;
+        }
+    } else {
+        tempo_no_maximo_ = 0;
+        if (limite_atingido_ && erro > LIMITE_INICIAL) {
+            limite_atingido_ = false; // Reset se saiu da saturação
+        }
+    }
+
+    definir_estado(novo_estado);
+    termo_p_ = numero_para_float(pid_.termo_p());
+    termo_i_ = numero_para_float(pid_.termo_i());
+    termo_d_ = numero_para_float(pid_.termo_d());
+
+    return saida;
+}
+
+void Controlador::aplicar_comando(const Comando &comando) {
+    switch (comando.tipo) {
+        case CMD_DEFINIR_ALVO: {
+            float novo_alvo = comando.valores[0];
+
+            // Bumpless transfer ao mudar setpoint
+            if (ligado_) {
+                float erro_atual = temperatura_ - alvo_;
+                float novo_erro = temperatura_ - novo_alvo;
+
+                // Se mudou de precisar resfriar para não precisar, ou vice-versa
+                if ((erro_atual > 0) != (novo_erro > 0)) {
+                    resetar();
+                }
+
+                // Se o novo setpoint requer resfriamento inicial
+                if (novo_erro > LIMITE_INICIAL) {
+                    iniciar_resfriamento();
+                }
+            }
+
+            cancelar_autoajuste("alvo alterado");
+            alvo_ = novo_alvo;
+            Serial.printf("Nova temperatura alvo: %.2f°C\n", novo_alvo);
+            break;
+        }
+
+        case CMD_ALTERNAR:
+            ligado_ = !ligado_;
+            if (!ligado_) {
+                cancelar_autoajuste("sistema desligado");
+                saida_ = 0;
+                pwm_ = 0;
+                definir_estado(ESTADO_DESLIGADO);
+            } else {
+                resetar();
+                if (temperatura_ - alvo_ > LIMITE_INICIAL) {
+                    iniciar_resfriamento();
+                }
+            }
+            Serial.printf("Sistema %s\n", ligado_ ? "LIGADO" : "DESLIGADO");
+            break;
+
+        case CMD_RESETAR_LIMITE:
+            limite_atingido_ = false;
+            tempo_no_maximo_ = 0;
+            Serial.println("Limite resetado pelo usuário");
+            break;
+
+        case CMD_DEFINIR_PID:
+            kp_ = comando.valores[0];
+            ki_ = comando.valores[1];
+            kd_ = comando.valores[2];
+            pid_.definir_ganhos(kp_, ki_, kd_);
+            pid_.zerar_integral(); // Reset integral quando muda parâmetros
+            Serial.printf("PID atualizado - Kp:%.2f Ki:%.2f Kd:%.2f\n", kp_, ki_, kd_);
+            break;
+
+        case CMD_AUTOAJUSTAR: {
+            if (!ligado_) {
+                Serial.println("Autoajuste: ligue o sistema antes");
+                break;
+            }
+            RegraAutoajuste regra = comando.valores[0] == REGRA_TYREUS_LUYBEN ? REGRA_TYREUS_LUYBEN : REGRA_ZIEGLER_NICHOLS;
+            float histerese = comando.valores[1] > 0 ? comando.valores[1] : HISTERESE_AUTOAJUSTE;
+            autoajuste_.iniciar(alvo_, histerese, regra, PWM_MAXIMO);
+            Serial.printf("Autoajuste iniciado em %.2f°C (histerese %.2f°C)\n", alvo_, histerese);
+            break;
+        }
+
+        case CMD_CANCELAR_AUTOAJUSTE:
+            cancelar_autoajuste("pedido do usuário");
+            resetar();
+            break;
+
+        case CMD_DEFINIR_ANTECIPACAO:
+            antecipacao_.configurar(comando.valores[0], comando.valores[1], comando.valores[2] != 0);
+            Serial.printf("Antecipação - ganho:%.2f base:%.1f %s\n", comando.valores[0], comando.valores[1],
+                          comando.valores[2] != 0 ? "aprendendo" : "fixa");
+            break;
+
+        case CMD_DEFINIR_ESTRUTURA_PID:
+            pid_.definir_estrutura(comando.valores[0], comando.valores[1], comando.valores[2]);
+            Serial.printf("Estrutura do PID - b:%.2f c:%.2f N:%.1f\n",
+                          comando.valores[0], comando.valores[1], comando.valores[2]);
+            break;
+
+        case CMD_DEFINIR_FILTRO:
+            if (filtro_.configurar((TipoFiltro)comando.valores[0], comando.valores[1] != 0, comando.valores[2])) {
+                Serial.printf("Filtro: %s%s (%.3f)\n", filtro_.mediana() ? "mediana + " : "",
+                              nome_filtro(filtro_.tipo()), filtro_.parametro());
+            }
+            break;
+
+        default:
+            break; // Comandos que não são do controlador
+    }
+    atualizar_resolucao();
+}
+
+int Controlador::processar_leitura(float temperatura, unsigned long agora, float quente) {
+    temperatura_quente_ = quente;
+    recebeu_leitura_ = true;
+
+    // Verificar sensor
+    if (temperatura < TEMPERATURA_MINIMA_VALIDA) {
+        temperatura_ = temperatura;
+        saida_ = 0;
+        pwm_ = 0;
+        termo_p_ = termo_i_ = termo_d_ = termo_ff_ = 0;
+        definir_estado(ESTADO_ERRO_SENSOR);
+        filtro_.reiniciar(); // A volta do sensor não se mistura com leituras antigas
+        antecipacao_.interromper();
+        atualizar_resolucao();
+        return 0;
+    }
+
+    temperatura_ = filtro_.filtrar(temperatura);
+
+    if (ligado_ && autoajuste_.em_andamento()) {
+        saida_ = executar_autoajuste(temperatura_, agora);
+    } else if (ligado_) {
+        saida_ = calcular_pid(temperatura_, agora);
+    } else {
+        saida_ = 0;
+        termo_p_ = termo_i_ = termo_d_ = termo_ff_ = 0;
+        definir_estado(ESTADO_DESLIGADO);
+    }
+    pwm_ = (int)saida_;
+
+    // Com a malha acomodada, a média da saída é o PWM de regime para o lado quente
+    bool acomodado = ligado_ && estado_ != ESTADO_AUTOAJUSTE && !resfriamento_inicial_ &&
+                     fabsf(temperatura_ - alvo_) <= FAIXA_APRENDIZADO_ANTECIPACAO;
+    if (acomodado && temperatura_quente_ >= TEMPERATURA_MINIMA_VALIDA) {
+        antecipacao_.aprender(temperatura_quente_, alvo_, saida_, periodo_s_);
+    } else {
+        antecipacao_.interromper();
+    }
+    atualizar_resolucao();
+    return pwm_;
+}
+
+void Controlador::atualizar_resolucao() {
+    float erro = fabsf(temperatura_ - alvo_);
+    bool fina = resolucao_ == RESOLUCAO_FINA && erro <= BANDA_MORTA + HISTERESE_RESOLUCAO;
+    switch (estado_) {
+        case ESTADO_RESFRIAMENTO_INICIAL:
+            resolucao_ = RESOLUCAO_RAPIDA;
+            break;
+        case ESTADO_BANDA_MORTA:
+            resolucao_ = RESOLUCAO_FINA;
+            break;
+        case ESTADO_CONTROLE_PID:
+            if (fina) {
+                break;
+            }
+            if (erro > ERRO_RESOLUCAO_RAPIDA ||
+                (resolucao_ == RESOLUCAO_RAPIDA && erro > ERRO_RESOLUCAO_RAPIDA - HISTERESE_RESOLUCAO)) {
+                resolucao_ = RESOLUCAO_RAPIDA;
+            } else {
+                resolucao_ = RESOLUCAO_PADRAO;
+            }
+            break;
+        case ESTADO_SEM_RESFRIAMENTO:
+            // Logo abaixo do alvo a malha ainda está na banda morta
+            resolucao_ = fina ? RESOLUCAO_FINA : RESOLUCAO_PADRAO;
+            break;
+        default:
+            // O autoajuste mede o período da oscilação: melhor não mudar a amostragem no meio
+            resolucao_ = RESOLUCAO_PADRAO;
+            break;
+    }
+}
+
+void Controlador::preencher_snapshot(SnapshotControlador &snapshot) const {
+    snapshot.temperatura = temperatura_;
+    snapshot.alvo = alvo_;
+    snapshot.erro = temperatura_ - alvo_;
+    snapshot.termo_p = termo_p_;
+    snapshot.termo_i = termo_i_;
+    snapshot.termo_d = termo_d_;
+    snapshot.termo_ff = termo_ff_;
+    snapshot.temperatura_quente = temperatura_quente_;
+    snapshot.ganho_antecipacao = antecipacao_.ganho();
+    snapshot.base_antecipacao = antecipacao_.base();
+    snapshot.aprender_antecipacao = antecipacao_.aprendendo();
+    snapshot.blocos_antecipacao = antecipacao_.blocos();
+    snapshot.pwm = pwm_;
+    snapshot.ligado = ligado_;
+    snapshot.limite_atingido = limite_atingido_;
+    snapshot.estado = estado_;
+    snapshot.filtro = filtro_.tipo();
+    snapshot.mediana = filtro_.mediana();
+    snapshot.parametro_filtro = filtro_.parametro();
+    snapshot.autoajuste = autoajuste_.resultado();
+}
@@ -0,0 +1,58 @@
+#include "estatisticas_periodo.h"
+
+EstatisticasPeriodo::EstatisticasPeriodo(uint32_t periodo_nominal_us)
+    : periodo_nominal_us_(periodo_nominal_us) {
+    zerar();
+}
+
+uint32_t EstatisticasPeriodo::inicio_janela_us() const {
+    const uint32_t meia_janela = LARGURA_FAIXA_US * NUM_FAIXAS / 2;
+    return periodo_nominal_us_ > meia_janela ? periodo_nominal_us_ - meia_janela : 0;
+}
+
+void EstatisticasPeriodo::registrar(uint32_t periodo_us) {
+    // Amostras fora da janela caem na primeira ou na última faixa
+    const uint32_t inicio = inicio_janela_us();
+    size_t faixa = periodo_us > inicio ? (periodo_us - inicio) / LARGURA_FAIXA_US : 0;
+    if (faixa >= NUM_FAIXAS) {
+        faixa = NUM_FAIXAS - 1;
+    }
+    faixas_[faixa].fetch_add(1, std::memory_order_relaxed);
+
+    if (periodo_us < minimo_us_.load(std::memory_order_relaxed)) {
+        minimo_us_.store(periodo_us, std::memory_order_relaxed);
+    }
+    if (periodo_us > maximo_us_.load(std::memory_order_relaxed)) {
+        maximo_us_.store(periodo_us, std::memory_order_relaxed);
+    }
+    amostras_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EstatisticasPeriodo::zerar() {
+    for (size_t i = 0; i < NUM_FAIXAS; i++) {
+        faixas_[i].store(0, std::memory_order_relaxed);
+    }
+    minimo_us_.store(UINT32_MAX, std::memory_order_relaxed);
+    maximo_us_.store(0, std::memory_order_relaxed);
+    amostras_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t EstatisticasPeriodo::percentil_us(float percentil) const {
+    uint32_t total = 0;
+    for (size_t i = 0; i < NUM_FAIXAS; i++) {
+        total += faixas_[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const uint32_t alvo = (uint32_t)(total * percentil / 100.0f + 0.5f);
+    uint32_t acumulado = 0;
+    for (size_t i = 0; i < NUM_FAIXAS; i++) {
+        acumulado += faixas_[i].load(std::memory_order_relaxed);
+        if (acumulado >= alvo) {
+            return inicio_janela_us() + (i + 1) * LARGURA_FAIXA_US;
+        }
+    }
+    return maximo_us();
+}
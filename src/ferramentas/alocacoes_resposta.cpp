@@ -0,0 +1,135 @@
+// Alocações no heap por requisição de /dados (ver resposta_json.h e
+// conteudo_resposta_json.h). O servidor web não compila no ambiente nativo;
+// a ferramenta faz o que /dados faz com o conteúdo da resposta: tira um
+// bloco do pool, serializa o snapshot com ConteudoRespostaJson e monta o
+// cabeçalho. Na placa o bloco guarda a RespostaJson inteira, que só soma ao
+// conteúdo a base AsyncWebServerResponse (que não aloca sem DefaultHeaders)
+// e escreve os dois buffers direto no cliente TCP.
+// Quem conta é um malloc interposto (glibc), não a própria ferramenta: tudo
+// o que passar pelo heap durante a medida entra, inclusive o operator new
+// do pool quando os blocos acabam. O caminho "heap" só troca o documento
+// pelo JsonDocument com o alocador padrão, como era antes do AlocadorJson.
+// Cada rodada abre `simultaneas` requisições e as encerra juntas; a
+// primeira é o aquecimento.
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include "ferramentas.h"
+#include "alocador_json.h"
+#include "conteudo_resposta_json.h"
+#include "pool_blocos.h"
+
+#if defined(__GLIBC__) && !defined(PIO_UNIT_TESTING)
+#define CONTADOR_HEAP
+
+extern "C" void *__libc_malloc(size_t tamanho);
+extern "C" void *__libc_calloc(size_t quantidade, size_t tamanho);
+extern "C" void *__libc_realloc(void *memoria, size_t tamanho);
+
+static bool contando = false;
+static unsigned long alocacoes_contadas = 0;
+
+extern "C" void *malloc(size_t tamanho) {
+    alocacoes_contadas += contando;
+    return __libc_malloc(tamanho);
+}
+
+extern "C" void *calloc(size_t quantidade, size_t tamanho) {
+    alocacoes_contadas += contando;
+    return __libc_calloc(quantidade, tamanho);
+}
+
+extern "C" void *realloc(void *memoria, size_t tamanho) {
+    alocacoes_contadas += contando;
+    return __libc_realloc(memoria, tamanho);
+}
+#endif
+
+static const unsigned long RODADAS_PADRAO = 1000;
+static const size_t SIMULTANEAS_PADRAO = 2;
+static const size_t MAXIMO_SIMULTANEAS = 16;
+
+typedef PoolBlocos<sizeof(ConteudoRespostaJson), ConteudoRespostaJson::RESPOSTAS_SIMULTANEAS> PoolConteudos;
+
+// Repassa ao heap como o alocador padrão do ArduinoJson
+class AlocadorHeap : public ArduinoJson::Allocator {
+public:
+    void *allocate(size_t tamanho) override { return malloc(tamanho); }
+    void deallocate(void *memoria) override { free(memoria); }
+    void *reallocate(void *memoria, size_t tamanho) override { return realloc(memoria, tamanho); }
+};
+
+struct ResultadoAlocacoes {
+    unsigned long aquecimento;
+    unsigned long depois;
+};
+
+static SnapshotControlador snapshot_exemplo(unsigned long ciclo) {
+    SnapshotControlador snapshot{};
+    snapshot.ciclo = ciclo;
+    snapshot.temperatura = 4.0625f + (ciclo % 16) / 16.0f;
+    snapshot.alvo = 4;
+    snapshot.erro = snapshot.temperatura - snapshot.alvo;
+    snapshot.pwm = 731;
+    snapshot.ligado = true;
+    snapshot.resolucao = 11;
+    snapshot.periodo_ms = 500;
+    snapshot.termo_ff = 102.4f;
+    snapshot.temperatura_quente = 31.5f;
+    return snapshot;
+}
+
+static ResultadoAlocacoes medir(ArduinoJson::Allocator &documento, unsigned long rodadas, size_t simultaneas) {
+    ResultadoAlocacoes resultado = {0, 0};
+    PoolConteudos pool;
+    ConteudoRespostaJson *conteudos[MAXIMO_SIMULTANEAS];
+#ifdef CONTADOR_HEAP
+    for (unsigned long rodada = 0; rodada < rodadas; rodada++) {
+        alocacoes_contadas = 0;
+        contando = true;
+        for (size_t i = 0; i < simultaneas; i++) {
+            conteudos[i] = new (pool.obter()) ConteudoRespostaJson();
+            conteudos[i]->serializar_snapshot(snapshot_exemplo(rodada), documento);
+            conteudos[i]->iniciar_cabecalho(1, 200, "OK");
+            conteudos[i]->fechar_cabecalho();
+        }
+        for (size_t i = 0; i < simultaneas; i++) {
+            conteudos[i]->~ConteudoRespostaJson();
+            pool.devolver(conteudos[i]);
+        }
+        contando = false;
+        if (rodada == 0) {
+            resultado.aquecimento = alocacoes_contadas;
+        } else {
+            resultado.depois += alocacoes_contadas;
+        }
+    }
+#endif
+    return resultado;
+}
+
+static void imprimir(const char *caminho, const ResultadoAlocacoes &resultado, unsigned long rodadas,
+                     size_t simultaneas) {
+    printf("%s,%lu,%.3f\n", caminho, resultado.aquecimento,
+           rodadas > 1 ? (double)resultado.depois / ((rodadas - 1) * simultaneas) : 0.0);
+}
+
+int medir_alocacoes(int argc, char **argv) {
+#ifndef CONTADOR_HEAP
+    fprintf(stderr, "o contador interpõe o malloc da glibc; indisponível nesta plataforma\n");
+    return 2;
+#endif
+    unsigned long rodadas = argc >= 1 ? strtoul(argv[0], NULL, 10) : RODADAS_PADRAO;
+    size_t simultaneas = argc >= 2 ? strtoul(argv[1], NULL, 10) : SIMULTANEAS_PADRAO;
+    if (rodadas == 0 || simultaneas == 0 || simultaneas > MAXIMO_SIMULTANEAS) {
+        fprintf(stderr, "rodadas > 0 e simultaneas entre 1 e %u\n", (unsigned)MAXIMO_SIMULTANEAS);
+        return 2;
+    }
+
+    AlocadorHeap heap;
+    AlocadorJson reutilizado;
+    printf("caminho,alocacoes_aquecimento,alocacoes_por_requisicao\n");
+    imprimir("heap", medir(heap, rodadas, simultaneas), rodadas, simultaneas);
+    imprimir("pool", medir(reutilizado, rodadas, simultaneas), rodadas, simultaneas);
+    return 0;
+}
@@ -0,0 +1,504 @@
+// Custo de analisar a cabeça de uma requisição HTTP, antes e depois do
+// AsyncRequestHeadParser da biblioteca do servidor web. O caminho antigo
+// copiava cada linha para _temp e a partia com indexOf/substring, gerando
+// uma String para o nome e outra para o valor de cada cabeçalho e mais duas
+// no AsyncWebHeader. O novo percorre o segmento uma vez, guarda os
+// cabeçalhos crus num buffer só e monta o AsyncWebHeader apenas do que o
+// tratador pede. O servidor não compila no ambiente nativo, então o caminho
+// antigo está reproduzido aqui sobre uma String com o SSO de 11 bytes e a
+// realocação exata da String do ESP32. Mede-se a requisição inteira num
+// segmento e picada em segmentos de 64 bytes, que passam pelo buffer de
+// linhas partidas do analisador novo. O caminho "interesse" é o novo com
+// setCollectAllHeaders(false): só guarda o cabeçalho que a rota declarou com
+// addInterestingHeader. Os ciclos são os do contador de tempo
+// (rdtsc) e só saem em x86.
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <chrono>
+#include <list>
+#include "ferramentas.h"
+#include <AsyncRequestHeadParser.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CICLOS_DISPONIVEIS 1
+#endif
+
+static const unsigned long REPETICOES_PADRAO = 20000;
+static const size_t SSO_STRING = 11;
+static const size_t SEGMENTO_PICADO = 64;
+
+// O que um Chrome manda num GET de /dados
+static const char REQUISICAO[] =
+    "GET /dados?canal=0 HTTP/1.1\r\n"
+    "Host: 192.168.4.1\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (Linux; Android 14; Pixel 7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0.0.0 "
+    "Mobile Safari/537.36\r\n"
+    "Accept: */*\r\n"
+    "Referer: http://192.168.4.1/\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Pragma: no-cache\r\n"
+    "DNT: 1\r\n"
+    "Sec-GPC: 1\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\"\r\n"
+    "sec-ch-ua-mobile: ?1\r\n"
+    "sec-ch-ua-platform: \"Android\"\r\n"
+    "If-None-Match: \"pagina-3f2a9c1e\"\r\n"
+    "\r\n";
+static const size_t TAMANHO_REQUISICAO = sizeof(REQUISICAO) - 1;
+
+// Só a rota "/" registra interesse nele, mas o interesse vale para o
+// servidor todo (a união de todos os tratadores): ele é guardado em toda
+// requisição, inclusive nas de /dados, que não lê cabeçalho nenhum
+static const char CABECALHO_INTERESSE[] = "If-None-Match";
+
+// String do Arduino: SSO de 11 bytes e realloc no tamanho exato pedido
+class TextoArduino {
+public:
+    TextoArduino() : tamanho_(0), capacidade_(SSO_STRING), externo_(NULL) { interno_[0] = 0; }
+    TextoArduino(const char *texto) : TextoArduino() { concat(texto); }
+    TextoArduino(const TextoArduino &outro) : TextoArduino() { concat(outro.c_str(), outro.tamanho_); }
+    ~TextoArduino() { free(externo_); }
+
+    TextoArduino &operator=(const TextoArduino &outro) {
+        if (this != &outro) {
+            tamanho_ = 0;
+            concat(outro.c_str(), outro.tamanho_);
+        }
+        return *this;
+    }
+
+    size_t length() const { return tamanho_; }
+    const char *c_str() const { return externo_ ? externo_ : interno_; }
+    char charAt(size_t i) const { return i < tamanho_ ? c_str()[i] : 0; }
+
+    bool reserve(size_t tamanho) {
+        if (tamanho <= capacidade_) {
+            return true;
+        }
+        char *memoria = (char *)realloc(externo_, tamanho + 1);
+        if (!memoria) {
+            return false;
+        }
+        if (!externo_) {
+            memcpy(memoria, interno_, tamanho_ + 1);
+        }
+        externo_ = memoria;
+        capacidade_ = tamanho;
+        return true;
+    }
+
+    void concat(const char *texto, size_t tamanho) {
+        if (!reserve(tamanho_ + tamanho)) {
+            return;
+        }
+        char *destino = externo_ ? externo_ : interno_;
+        memcpy(destino + tamanho_, texto, tamanho);
+        tamanho_ += tamanho;
+        destino[tamanho_] = 0;
+    }
+    void concat(const char *texto) { concat(texto, strlen(texto)); }
+    void concat(char caractere) { concat(&caractere, 1); }
+
+    void clear() {
+        tamanho_ = 0;
+        (externo_ ? externo_ : interno_)[0] = 0;
+    }
+
+    void trim() {
+        const char *texto = c_str();
+        size_t inicio = 0, fim = tamanho_;
+        while (inicio < fim && strchr(" \t\r\n", texto[inicio])) {
+            inicio++;
+        }
+        while (fim > inicio && strchr(" \t\r\n", texto[fim - 1])) {
+            fim--;
+        }
+        char *destino = externo_ ? externo_ : interno_;
+        memmove(destino, destino + inicio, fim - inicio);
+        tamanho_ = fim - inicio;
+        destino[tamanho_] = 0;
+    }
+
+    void toLowerCase() {
+        char *texto = externo_ ? externo_ : interno_;
+        for (size_t i = 0; i < tamanho_; i++) {
+            texto[i] = tolower((unsigned char)texto[i]);
+        }
+    }
+
+    int indexOf(char caractere, size_t de = 0) const {
+        const char *achado = de < tamanho_ ? strchr(c_str() + de, caractere) : NULL;
+        return achado ? (int)(achado - c_str()) : -1;
+    }
+
+    // Como a String: índices trocados se invertidos, -1 vira o fim
+    TextoArduino substring(size_t de, size_t ate = (size_t)-1) const {
+        if (ate > tamanho_) {
+            ate = tamanho_;
+        }
+        if (de > ate) {
+            size_t troca = de;
+            de = ate;
+            ate = troca;
+        }
+        TextoArduino resultado;
+        resultado.concat(c_str() + de, ate - de);
+        return resultado;
+    }
+
+    bool equals(const char *texto) const { return strcmp(c_str(), texto) == 0; }
+    bool equalsIgnoreCase(const char *texto) const { return strcasecmp(c_str(), texto) == 0; }
+    bool startsWith(const char *texto) const { return strncmp(c_str(), texto, strlen(texto)) == 0; }
+
+private:
+    size_t tamanho_;
+    size_t capacidade_;
+    char *externo_;
+    char interno_[SSO_STRING + 1];
+};
+
+struct CabecalhoWeb {
+    TextoArduino nome, valor;
+    CabecalhoWeb(const TextoArduino &n, const TextoArduino &v) : nome(n), valor(v) {}
+    CabecalhoWeb(const char *n, const char *v) : nome(n), valor(v) {}
+};
+
+struct ParametroWeb {
+    TextoArduino nome, valor;
+    ParametroWeb(const TextoArduino &n, const TextoArduino &v) : nome(n), valor(v) {}
+};
+
+static TextoArduino decodificar_url(const char *texto, size_t tamanho) {
+    char temp[] = "0x00";
+    size_t i = 0;
+    TextoArduino decodificado;
+    decodificado.reserve(tamanho);
+    while (i < tamanho) {
+        char caractere = texto[i++];
+        if (caractere == '%' && i + 1 < tamanho) {
+            temp[2] = texto[i++];
+            temp[3] = texto[i++];
+            caractere = strtol(temp, NULL, 16);
+        } else if (caractere == '+') {
+            caractere = ' ';
+        }
+        decodificado.concat(caractere);
+    }
+    return decodificado;
+}
+
+enum { CABECA_INICIO, CABECA_CABECALHOS, CABECA_FIM, CABECA_FALHA };
+
+// O que a requisição guarda da cabeça, nos dois caminhos
+struct CabecaRequisicao {
+    int estado = CABECA_INICIO;
+    int metodo = 0;
+    int versao = 0;
+    TextoArduino url, host, tipo, autorizacao;
+    size_t tamanho_conteudo = 0;
+    bool evento = false;
+    std::list<ParametroWeb> parametros;
+    std::list<CabecalhoWeb> cabecalhos;
+
+    void parametros_get(const char *texto, size_t tamanho) {
+        size_t inicio = 0;
+        while (inicio < tamanho) {
+            const char *fim = (const char *)memchr(texto + inicio, '&', tamanho - inicio);
+            size_t final = fim ? fim - texto : tamanho;
+            const char *igual = (const char *)memchr(texto + inicio, '=', final - inicio);
+            size_t separador = igual ? igual - texto : final;
+            TextoArduino nome(decodificar_url(texto + inicio, separador - inicio));
+            TextoArduino valor(separador + 1 < final ? decodificar_url(texto + separador + 1, final - separador - 1)
+                                                     : TextoArduino());
+            parametros.emplace_back(nome, valor);
+            inicio = final + 1;
+        }
+    }
+};
+
+// _onData, _parseLine, _parseReqHead e _parseReqHeader de antes
+struct RequisicaoAntiga : CabecaRequisicao {
+    TextoArduino temp;
+
+    size_t guardados() const { return cabecalhos.size(); }
+
+    void receber(char *buf, size_t len) {
+        while (estado < CABECA_FIM) {
+            char *str = buf;
+            size_t i;
+            for (i = 0; i < len; i++) {
+                if (!str[i]) {
+                    estado = CABECA_FALHA;
+                    return;
+                }
+                if (str[i] == '\n') {
+                    break;
+                }
+            }
+            if (i == len) {
+                char ch = str[len - 1];
+                str[len - 1] = 0;
+                temp.reserve(temp.length() + len);
+                temp.concat(str);
+                temp.concat(ch);
+                return;
+            }
+            str[i] = 0;
+            temp.concat(str);
+            temp.trim();
+            linha();
+            if (++i >= len) {
+                return;
+            }
+            buf = str + i;
+            len -= i;
+        }
+    }
+
+    void linha() {
+        if (estado == CABECA_INICIO) {
+            estado = temp.length() && cabeca() ? CABECA_CABECALHOS : CABECA_FALHA;
+        } else if (!temp.length()) {
+            estado = CABECA_FIM;
+        } else {
+            cabecalho();
+        }
+    }
+
+    bool cabeca() {
+        int index = temp.indexOf(' ');
+        TextoArduino m = temp.substring(0, index);
+        index = temp.indexOf(' ', index + 1);
+        TextoArduino u = temp.substring(m.length() + 1, index);
+        temp = temp.substring(index + 1);
+        if (m.equals("GET")) {
+            metodo = 1;
+        } else if (m.equals("POST")) {
+            metodo = 2;
+        } else {
+            return false;
+        }
+        TextoArduino g;
+        index = u.indexOf('?');
+        if (index > 0) {
+            g = u.substring(index + 1);
+            u = u.substring(0, index);
+        }
+        url = decodificar_url(u.c_str(), u.length());
+        parametros_get(g.c_str(), g.length());
+        if (!temp.startsWith("HTTP/1.0")) {
+            versao = 1;
+        }
+        temp = "";
+        return url.length() > 0;
+    }
+
+    void cabecalho() {
+        int index = temp.indexOf(':');
+        TextoArduino name(temp.substring(0, index));
+        TextoArduino value(temp.substring(index + 2));
+        if (name.equalsIgnoreCase("host")) {
+            host = value;
+        } else if (name.equalsIgnoreCase("content-type")) {
+            tipo = value.substring(0, value.indexOf(';'));
+        } else if (name.equalsIgnoreCase("content-length")) {
+            tamanho_conteudo = atoi(value.c_str());
+        } else if (name.equalsIgnoreCase("authorization")) {
+            autorizacao = value;
+        } else if (name.equalsIgnoreCase("accept")) {
+            TextoArduino minusculo(value);
+            minusculo.toLowerCase();
+            evento = strstr(minusculo.c_str(), "text/event-stream") != NULL;
+        }
+        cabecalhos.emplace_back(name, value);
+        temp.clear();
+    }
+
+    const CabecalhoWeb *obter_cabecalho(const char *nome) {
+        for (const CabecalhoWeb &cabecalho : cabecalhos) {
+            if (cabecalho.nome.equalsIgnoreCase(nome)) {
+                return &cabecalho;
+            }
+        }
+        return NULL;
+    }
+};
+
+// O mesmo sobre AsyncRequestHeadParser e AsyncRawHeaders
+struct RequisicaoNova : CabecaRequisicao {
+    AsyncRequestHeadParser analisador;
+    AsyncRawHeaders<CabecalhoWeb> crus;
+    const char *interesse = NULL;   // NULL guarda todos
+
+    size_t guardados() const { return crus.count(); }
+
+    static TextoArduino texto(const AsyncHeadView &trecho) {
+        TextoArduino resultado;
+        resultado.concat(trecho.data, trecho.length);
+        return resultado;
+    }
+
+    void receber(char *buf, size_t len) {
+        while (len && estado < CABECA_FIM) {
+            AsyncRequestHeadParser::Event evento_analise;
+            size_t usados = analisador.parse(buf, len, evento_analise);
+            switch (evento_analise) {
+            case AsyncRequestHeadParser::REQUEST_LINE:
+                estado = cabeca() ? CABECA_CABECALHOS : CABECA_FALHA;
+                break;
+            case AsyncRequestHeadParser::HEADER:
+                cabecalho();
+                break;
+            case AsyncRequestHeadParser::HEAD_END:
+                estado = CABECA_FIM;
+                break;
+            case AsyncRequestHeadParser::FAILED:
+                estado = CABECA_FALHA;
+                break;
+            default:
+                break;
+            }
+            buf += usados;
+            len -= usados;
+        }
+    }
+
+    bool cabeca() {
+        const AsyncHeadView &m = analisador.method();
+        if (m.equals("GET")) {
+            metodo = 1;
+        } else if (m.equals("POST")) {
+            metodo = 2;
+        } else {
+            return false;
+        }
+        const AsyncHeadView &u = analisador.target();
+        size_t index = u.indexOf('?');
+        if (index == 0) {
+            index = u.length;
+        }
+        url = decodificar_url(u.data, index);
+        if (index < u.length) {
+            parametros_get(u.data + index + 1, u.length - index - 1);
+        }
+        if (!analisador.version().startsWith("HTTP/1.0")) {
+            versao = 1;
+        }
+        return url.length() > 0;
+    }
+
+    void cabecalho() {
+        const AsyncHeadView &name = analisador.name();
+        const AsyncHeadView &value = analisador.value();
+        if (name.equalsIgnoreCase("host")) {
+            host = texto(value);
+        } else if (name.equalsIgnoreCase("content-type")) {
+            tipo = texto(value.substring(0, value.indexOf(';')));
+        } else if (name.equalsIgnoreCase("content-length")) {
+            tamanho_conteudo = 0;
+            for (size_t i = 0; i < value.length && isdigit((unsigned char)value.data[i]); i++) {
+                tamanho_conteudo = tamanho_conteudo * 10 + (value.data[i] - '0');
+            }
+        } else if (name.equalsIgnoreCase("authorization")) {
+            autorizacao = texto(value);
+        } else if (name.equalsIgnoreCase("accept")) {
+            evento = value.containsIgnoreCase("text/event-stream");
+        }
+        if (interesse && !name.equalsIgnoreCase(interesse)) {
+            return;
+        }
+        crus.add(name.data, name.length, value.data, value.length);
+    }
+
+    const CabecalhoWeb *obter_cabecalho(const char *nome) {
+        AsyncRawHeaders<CabecalhoWeb>::Entry *entrada = crus.find(nome);
+        if (!entrada) {
+            return NULL;
+        }
+        if (!entrada->header) {
+            cabecalhos.emplace_back(entrada->name(), entrada->value());
+            entrada->header = &cabecalhos.back();
+        }
+        return entrada->header;
+    }
+};
+
+// AsyncWebServer::_isInterestingHeader com só a rota "/" declarando o seu
+struct RequisicaoInteresse : RequisicaoNova {
+    RequisicaoInteresse() { interesse = CABECALHO_INTERESSE; }
+};
+
+static inline uint64_t ler_ciclos() {
+#ifdef CICLOS_DISPONIVEIS
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// O caminho antigo escreve no buffer recebido, então cada repetição parte de
+// uma cópia nova, nos dois caminhos
+template <typename Requisicao>
+static bool medir(const char *caminho, size_t segmento, unsigned long repeticoes) {
+    char recebido[sizeof(REQUISICAO)];
+    volatile size_t consultados = 0;
+    size_t guardados = 0;
+    bool correta = true;
+    auto inicio = std::chrono::steady_clock::now();
+    uint64_t ciclos_inicio = ler_ciclos();
+    for (unsigned long r = 0; r < repeticoes; r++) {
+        memcpy(recebido, REQUISICAO, TAMANHO_REQUISICAO);
+        Requisicao requisicao;
+        for (size_t posicao = 0; posicao < TAMANHO_REQUISICAO; posicao += segmento) {
+            size_t tamanho = TAMANHO_REQUISICAO - posicao < segmento ? TAMANHO_REQUISICAO - posicao : segmento;
+            requisicao.receber(recebido + posicao, tamanho);
+        }
+        const CabecalhoWeb *cabecalho = requisicao.obter_cabecalho(CABECALHO_INTERESSE);
+        consultados += cabecalho ? cabecalho->valor.length() : 0;
+        guardados = requisicao.guardados();
+        correta = correta && requisicao.estado == CABECA_FIM && cabecalho && requisicao.url.equals("/dados") &&
+                  requisicao.parametros.size() == 1 && requisicao.host.equals("192.168.4.1");
+    }
+    uint64_t ciclos = ler_ciclos() - ciclos_inicio;
+    auto fim = std::chrono::steady_clock::now();
+
+    double bytes = (double)repeticoes * TAMANHO_REQUISICAO;
+    double ns = std::chrono::duration<double, std::nano>(fim - inicio).count();
+    printf("%s,%zu,%.2f,", caminho, segmento, ns / bytes);
+#ifdef CICLOS_DISPONIVEIS
+    printf("%.2f,", ciclos / bytes);
+#else
+    (void)ciclos;
+    printf("-,");
+#endif
+    printf("%zu\n", guardados);
+    return correta;
+}
+
+int medir_analisador(int argc, char **argv) {
+    unsigned long repeticoes = argc >= 1 ? strtoul(argv[0], NULL, 10) : REPETICOES_PADRAO;
+    if (repeticoes == 0) {
+        fprintf(stderr, "repeticoes > 0\n");
+        return 2;
+    }
+
+    printf("caminho,segmento,ns_por_byte,ciclos_por_byte,cabecalhos_guardados\n");
+    bool correta = true;
+    for (size_t segmento : {TAMANHO_REQUISICAO, SEGMENTO_PICADO}) {
+        correta = medir<RequisicaoAntiga>("antigo", segmento, repeticoes) && correta;
+        correta = medir<RequisicaoNova>("novo", segmento, repeticoes) && correta;
+        correta = medir<RequisicaoInteresse>("interesse", segmento, repeticoes) && correta;
+    }
+    if (!correta) {
+        fprintf(stderr, "analise divergiu da requisicao esperada\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Roda o autoajuste por relé contra a planta de dois nós, partindo do
+// ambiente, e depois a mesma malha por mais uma hora com os ganhos obtidos.
+#include <math.h>
+#include "ferramentas.h"
+#include "malha_simulada.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+
+int autoajuste_simulado(int argc, char **argv) {
+    float ambiente = argc >= 1 ? atof(argv[0]) : 25;
+    float alvo = argc >= 2 ? atof(argv[1]) : 4;
+    RegraAutoajuste regra = argc >= 3 && strcmp(argv[2], "tl") == 0 ? REGRA_TYREUS_LUYBEN : REGRA_ZIEGLER_NICHOLS;
+
+    Serial.silenciar(true);
+    PlantaDoisNos planta;
+    planta.reiniciar(ambiente);
+    MalhaSimulada malha(planta, TEMPO_AMOSTRA_SEG, RESOLUCAO_SENSOR);
+    malha.aplicar(CMD_DEFINIR_ALVO, alvo);
+
+    // Liga na primeira leitura e começa o experimento direto do ambiente:
+    // o relé resfria em potência máxima até cruzar o alvo, e esse primeiro
+    // ciclo é descartado
+    while (!malha.ciclo()) {
+    }
+    malha.aplicar(CMD_ALTERNAR);
+    unsigned long inicio_ms = malha.agora_ms();
+    malha.aplicar(CMD_AUTOAJUSTAR, regra);
+
+    SnapshotControlador snapshot;
+    do {
+        malha.ciclo();
+        malha.controlador().preencher_snapshot(snapshot);
+    } while (snapshot.autoajuste.fase == AUTOAJUSTE_EM_ANDAMENTO);
+
+    const ResultadoAutoajuste &r = snapshot.autoajuste;
+    printf("autoajuste %s em %lu s (%s)\n", nome_fase_autoajuste((FaseAutoajuste)r.fase),
+           (malha.agora_ms() - inicio_ms) / 1000, regra == REGRA_TYREUS_LUYBEN ? "Tyreus-Luyben" : "Ziegler-Nichols");
+    if (r.fase != AUTOAJUSTE_CONCLUIDO) {
+        return 1;
+    }
+    printf("Ku=%.2f Pu=%.1fs -> kp=%.3f ki=%.4f kd=%.2f\n", r.ku, r.pu_s, r.kp, r.ki, r.kd);
+
+    // Uma hora com os ganhos novos: erro máximo e médio na última meia hora
+    float maior_erro = 0, soma_erro = 0;
+    unsigned long amostras = 0;
+    unsigned long fim_ms = malha.agora_ms() + 3600000UL;
+    while (malha.agora_ms() < fim_ms) {
+        malha.ciclo();
+        if (fim_ms - malha.agora_ms() < 1800000UL) {
+            float erro = fabsf(planta.temperatura() - alvo);
+            maior_erro = fmaxf(maior_erro, erro);
+            soma_erro += erro;
+            amostras++;
+        }
+    }
+    printf("última meia hora com os ganhos novos: erro máximo %.3f°C, médio %.3f°C\n",
+           maior_erro, soma_erro / amostras);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Bancada de malha fechada: roda o controlador contra as plantas simuladas
+// numa matriz de temperaturas ambiente e setpoints, partindo do equilíbrio
+// com o ambiente, e imprime uma linha CSV de métricas por combinação.
+#include <math.h>
+#include "ferramentas.h"
+#include "malha_simulada.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+static const float FAIXA_ACOMODACAO = 0.5;      // °C em torno do alvo
+
+static const float AMBIENTES[] = {20, 25, 30, 35};
+static const float ALVOS[] = {2, 4, 8};
+
+struct ResultadoBancada {
+    float acomodacao_s;     // Último instante fora da faixa; NAN se terminou fora
+    float sobressinal;      // Quanto passou abaixo do alvo, °C
+    float iae;              // ∫|e| dt, °C·s
+    float ise;              // ∫e² dt, °C²·s
+    float energia_wh;
+    float limite_s;         // Primeira detecção de LIMITE_ATINGIDO; NAN se nunca
+};
+
+static ResultadoBancada executar(PlantaTermica &planta, float ambiente, float alvo, float duracao_s,
+                                 const float *ganhos) {
+    planta.reiniciar(ambiente);
+    MalhaSimulada malha(planta, TEMPO_AMOSTRA_SEG, RESOLUCAO_SENSOR);
+    malha.aplicar(CMD_DEFINIR_ALVO, alvo);
+    if (ganhos) {
+        malha.aplicar(CMD_DEFINIR_PID, ganhos[0], ganhos[1], ganhos[2]);
+    }
+
+    ResultadoBancada resultado = {0, 0, 0, 0, 0, NAN};
+    float ultimo_fora = 0;
+    bool ligado = false;
+
+    for (float t = 0; t < duracao_s; t += TEMPO_AMOSTRA_SEG) {
+        float potencia = planta.potencia_eletrica(malha.duty());
+        bool leitura = malha.ciclo();
+
+        // Liga na primeira leitura, como o operador faria pela página
+        if (leitura && !ligado) {
+            malha.aplicar(CMD_ALTERNAR);
+            ligado = true;
+        }
+
+        float erro = planta.temperatura() - alvo;
+        resultado.iae += fabsf(erro) * TEMPO_AMOSTRA_SEG;
+        resultado.ise += erro * erro * TEMPO_AMOSTRA_SEG;
+        resultado.energia_wh += potencia * TEMPO_AMOSTRA_SEG / 3600;
+        if (-erro > resultado.sobressinal) {
+            resultado.sobressinal = -erro;
+        }
+        if (fabsf(erro) > FAIXA_ACOMODACAO) {
+            ultimo_fora = t;
+        }
+        if (isnan(resultado.limite_s) && malha.controlador().estado() == ESTADO_LIMITE_ATINGIDO) {
+            resultado.limite_s = t;
+        }
+    }
+
+    float final_erro = planta.temperatura() - alvo;
+    resultado.acomodacao_s = fabsf(final_erro) <= FAIXA_ACOMODACAO ? ultimo_fora : NAN;
+    return resultado;
+}
+
+static void imprimir_tempo(float segundos) {
+    if (isnan(segundos)) {
+        printf(",-");
+    } else {
+        printf(",%.0f", segundos);
+    }
+}
+
+int bancada(int argc, char **argv) {
+    float duracao_s = (argc >= 1 ? atof(argv[0]) : 60) * 60;
+    float ganhos[3];
+    bool ganhos_definidos = argc >= 4;
+    if (ganhos_definidos) {
+        for (int i = 0; i < 3; i++) {
+            ganhos[i] = atof(argv[i + 1]);
+        }
+    }
+
+    Serial.silenciar(true);
+
+    PlantaPrimeiraOrdem primeira_ordem;
+    PlantaDoisNos dois_nos;
+    PlantaTermica *plantas[] = {&primeira_ordem, &dois_nos};
+
+    printf("planta,ambiente,alvo,acomodacao_s,sobressinal_c,iae,ise,energia_wh,limite_s\n");
+    for (PlantaTermica *planta : plantas) {
+        for (float ambiente : AMBIENTES) {
+            for (float alvo : ALVOS) {
+                ResultadoBancada r = executar(*planta, ambiente, alvo, duracao_s,
+                                              ganhos_definidos ? ganhos : NULL);
+                printf("%s,%.0f,%.0f", planta->nome(), ambiente, alvo);
+                imprimir_tempo(r.acomodacao_s);
+                printf(",%.2f,%.0f,%.0f,%.2f", r.sobressinal, r.iae, r.ise, r.energia_wh);
+                imprimir_tempo(r.limite_s);
+                printf("\n");
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Ação antecipatória (ver antecipacao.h) na planta de dois nós com o
+// ambiente oscilando (ciclo de dia comprimido em 2 h, ±6°C): o dissipador
+// acompanha o ambiente e, sem antecipação, a câmara deriva até o integrador
+// alcançar. Com ganhos ajustados (os do autoajuste nessa planta, ou os da
+// linha de comando), compara a malha sem o sensor do lado quente, com o
+// modelo aprendido desde zero e com o modelo fixo nos coeficientes que o
+// aprendizado encontrou. Com os ganhos padrão a malha não acomoda (o
+// integrador limitado não cobre o PWM de regime), então não há o que
+// aprender; aí compara só sem e com o modelo fixo. Mede, na segunda metade,
+// o IAE e o maior erro.
+#include <math.h>
+#include "ferramentas.h"
+#include "malha_simulada.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+static const float AMBIENTE_MEDIO = 25;
+static const float AMPLITUDE_AMBIENTE = 6;
+static const float PERIODO_AMBIENTE_S = 7200;
+static const float ALVO = 4;
+static const float DURACAO_S = 4 * PERIODO_AMBIENTE_S;
+static const float INICIO_MEDIDA_S = DURACAO_S / 2;
+static const float GANHOS_AJUSTADOS[3] = {150, 2, 2000};
+
+struct ResultadoAntecipacao {
+    float iae, erro_maximo;
+    float ganho, base;
+    unsigned long blocos;
+};
+
+enum ModoAntecipacao { SEM_LADO_QUENTE, APRENDIDA, FIXA };
+
+// ganhos == NULL: os padrão do controlador
+static ResultadoAntecipacao executar(ModoAntecipacao modo, float ganho, float base, const float *ganhos) {
+    PlantaDoisNos planta;
+    planta.reiniciar(AMBIENTE_MEDIO);
+    MalhaSimulada malha(planta, TEMPO_AMOSTRA_SEG, RESOLUCAO_SENSOR);
+    if (modo != SEM_LADO_QUENTE) {
+        malha.usar_sensor_quente();
+        malha.aplicar(CMD_DEFINIR_ANTECIPACAO, ganho, base, modo == APRENDIDA ? 1 : 0);
+    }
+    malha.aplicar(CMD_DEFINIR_ALVO, ALVO);
+    if (ganhos) {
+        malha.aplicar(CMD_DEFINIR_PID, ganhos[0], ganhos[1], ganhos[2]);
+    }
+    malha.aplicar(CMD_ALTERNAR);
+
+    ResultadoAntecipacao resultado = {0, 0, 0, 0, 0};
+    for (float t = 0; t < DURACAO_S; t += TEMPO_AMOSTRA_SEG) {
+        planta.definir_ambiente(AMBIENTE_MEDIO + AMPLITUDE_AMBIENTE * sinf(2 * (float)M_PI * t / PERIODO_AMBIENTE_S));
+        malha.ciclo();
+        if (t >= INICIO_MEDIDA_S) {
+            float erro = fabsf(planta.temperatura() - ALVO);
+            resultado.iae += erro * TEMPO_AMOSTRA_SEG;
+            resultado.erro_maximo = fmaxf(resultado.erro_maximo, erro);
+        }
+    }
+
+    const Antecipacao &antecipacao = malha.controlador().antecipacao();
+    resultado.ganho = antecipacao.ganho();
+    resultado.base = antecipacao.base();
+    resultado.blocos = antecipacao.blocos();
+    return resultado;
+}
+
+static void imprimir(const char *ganhos, const char *nome, const ResultadoAntecipacao &resultado) {
+    printf("%s,%s,%.0f,%.3f,%.2f,%.1f,%lu\n", ganhos, nome, resultado.iae, resultado.erro_maximo, resultado.ganho,
+           resultado.base, resultado.blocos);
+}
+
+int comparar_antecipacao(int argc, char **argv) {
+    const float *ajustados = GANHOS_AJUSTADOS;
+    float ganhos_lidos[3];
+    if (argc >= 3) {
+        for (int i = 0; i < 3; i++) {
+            ganhos_lidos[i] = atof(argv[i]);
+        }
+        ajustados = ganhos_lidos;
+    }
+
+    Serial.silenciar(true);
+    printf("ganhos,antecipacao,iae,erro_maximo_c,ganho,base,blocos_aprendidos\n");
+
+    imprimir("ajustados", "sem_lado_quente", executar(SEM_LADO_QUENTE, 0, 0, ajustados));
+    ResultadoAntecipacao aprendida = executar(APRENDIDA, 0, 0, ajustados);
+    imprimir("ajustados", "aprendida", aprendida);
+    imprimir("ajustados", "fixa", executar(FIXA, aprendida.ganho, aprendida.base, ajustados));
+    imprimir("padrao", "sem_lado_quente", executar(SEM_LADO_QUENTE, 0, 0, NULL));
+    imprimir("padrao", "fixa", executar(FIXA, aprendida.ganho, aprendida.base, NULL));
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Compara as configurações do FiltroTemperatura em um traço de temperatura:
+// o CSV de /historico?res=0 (ou "t_ms,temperatura" por linha) em stdin, ou
+// um sinal sintético com ruído, quantização e picos de 85°C ("sintetico").
+// A referência é a temperatura verdadeira no sintético e, no traço gravado,
+// a mediana centrada da própria leitura (sem atraso, mas só possível offline).
+// Para cada filtro: atraso (deslocamento que melhor alinha a saída com a
+// referência) e ruído RMS nesse alinhamento, medidos sem os picos; maior
+// erro sem alinhar com os picos; maior erro nas primeiras amostras
+// (aquecimento); e tempo médio por amostra.
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "controlador.h"
+#include "ferramentas.h"
+#include "filtros.h"
+
+static const float ATRASO_MAXIMO_S = 20;
+static const float JANELA_REFERENCIA_S = 2;     // Meia janela da mediana centrada
+static const size_t AMOSTRAS_TEMPO = 1000000;
+static const size_t AMOSTRAS_AQUECIMENTO = 5;
+
+struct ConfiguracaoComparada {
+    const char *nome;
+    TipoFiltro tipo;
+    bool mediana;
+    float parametro;
+};
+
+static const ConfiguracaoComparada CONFIGURACOES[] = {
+    {"nenhum", FILTRO_NENHUM, false, 1},
+    {"media3", FILTRO_MEDIA_MOVEL, false, 1},
+    {"mediana3", FILTRO_NENHUM, true, 1},
+    {"exponencial_1s", FILTRO_EXPONENCIAL, false, 1},
+    {"exponencial_2s", FILTRO_EXPONENCIAL, false, 2},
+    {"biquad_0.2hz", FILTRO_BIQUAD, false, 0.2f},
+    {"biquad_0.1hz", FILTRO_BIQUAD, false, 0.1f},
+    {"kalman_q0.01", FILTRO_KALMAN, false, 0.01f},
+    {"kalman_q0.002", FILTRO_KALMAN, false, 0.002f},
+    {"mediana3+media3", FILTRO_MEDIA_MOVEL, true, 1},
+    {"mediana3+exponencial_1s", FILTRO_EXPONENCIAL, true, 1},
+    {"mediana3+biquad_0.2hz", FILTRO_BIQUAD, true, 0.2f},
+    {"mediana3+kalman_q0.01", FILTRO_KALMAN, true, 0.01f},
+};
+
+struct Traco {
+    float dt;
+    std::vector<float> leituras;
+    std::vector<float> leituras_sem_picos;  // Iguais às leituras no traço gravado
+    std::vector<float> referencia;
+};
+
+// Resfriamento de 25°C a 4°C e depois uma perturbação senoidal de 0.3°C,
+// lidos com ruído de 0.05°C, quantização de 11 bits e um pico de 85°C de
+// vez em quando; gerador congruencial para repetir a mesma sequência
+static Traco gerar_sintetico() {
+    Traco traco;
+    traco.dt = 0.5;
+    uint32_t estado = 12345;
+    for (float t = 0; t < 900; t += traco.dt) {
+        float verdadeira = t < 300 ? 4 + 21 * expf(-t / 120) : 4 + 21 * expf(-300.0f / 120) + 0.3f * sinf(2 * (float)M_PI * t / 60);
+
+        estado = estado * 1103515245u + 12345u;
+        float u1 = ((estado >> 8) + 1.0f) / 16777217.0f;
+        estado = estado * 1103515245u + 12345u;
+        float u2 = (estado >> 8) / 16777216.0f;
+        float ruido = 0.05f * sqrtf(-2 * logf(u1)) * cosf(2 * (float)M_PI * u2);
+
+        float lida = floorf((verdadeira + ruido) / 0.125f) * 0.125f;
+        traco.leituras_sem_picos.push_back(lida);
+        traco.leituras.push_back((estado >> 24) < 2 ? 85 : lida);
+        traco.referencia.push_back(verdadeira);
+    }
+    return traco;
+}
+
+static bool ler_traco(Traco &traco) {
+    std::vector<unsigned long> tempos;
+    char linha[128];
+    while (fgets(linha, sizeof(linha), stdin)) {
+        unsigned long t_ms;
+        float temperatura;
+        if (sscanf(linha, "%lu,%f", &t_ms, &temperatura) == 2) {
+            tempos.push_back(t_ms);
+            traco.leituras.push_back(temperatura);
+        }
+    }
+    if (tempos.size() < 2) {
+        return false;
+    }
+    traco.dt = (tempos.back() - tempos.front()) / 1000.0f / (tempos.size() - 1);
+
+    traco.leituras_sem_picos = traco.leituras;
+
+    // Mediana centrada: acompanha a temperatura sem atraso e ignora picos.
+    // Nas pontas a janela encolhe para continuar centrada.
+    long meia_janela = lroundf(JANELA_REFERENCIA_S / traco.dt);
+    long quantidade = traco.leituras.size();
+    for (long i = 0; i < quantidade; i++) {
+        long meia = std::min(meia_janela, std::min(i, quantidade - 1 - i));
+        std::vector<float> janela;
+        for (long j = i - meia; j <= i + meia; j++) {
+            janela.push_back(traco.leituras[j]);
+        }
+        std::sort(janela.begin(), janela.end());
+        traco.referencia.push_back(janela[janela.size() / 2]);
+    }
+    return true;
+}
+
+static double medir_ns(const ConfiguracaoComparada &configuracao, const Traco &traco) {
+    FiltroTemperatura filtro(configuracao.tipo, configuracao.mediana, configuracao.parametro, traco.dt);
+    volatile float acumulado = 0;
+    size_t quantidade = traco.leituras.size();
+    auto inicio = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOSTRAS_TEMPO; i++) {
+        acumulado += filtro.filtrar(traco.leituras[i % quantidade]);
+    }
+    auto fim = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / AMOSTRAS_TEMPO;
+}
+
+int comparar_filtros(int argc, char **argv) {
+    Traco traco;
+    if (argc >= 1 && strcmp(argv[0], "sintetico") == 0) {
+        traco = gerar_sintetico();
+    } else if (!ler_traco(traco)) {
+        fprintf(stderr, "Traço vazio: esperado t_ms,temperatura por linha em stdin\n");
+        return 1;
+    }
+
+    const size_t quantidade = traco.leituras.size();
+    const size_t atraso_maximo = std::min((size_t)lroundf(ATRASO_MAXIMO_S / traco.dt), quantidade / 2);
+    printf("filtro,atraso_s,ruido_rms_c,erro_max_c,erro_aquecimento_c,ns_por_amostra\n");
+
+    for (const ConfiguracaoComparada &configuracao : CONFIGURACOES) {
+        FiltroTemperatura filtro(configuracao.tipo, configuracao.mediana, configuracao.parametro, traco.dt);
+        float erro_max = 0;
+        float erro_aquecimento = 0;
+        for (size_t i = 0; i < quantidade; i++) {
+            float erro = fabsf(filtro.filtrar(traco.leituras[i]) - traco.referencia[i]);
+            erro_max = fmaxf(erro_max, erro);
+            if (i < AMOSTRAS_AQUECIMENTO) {
+                erro_aquecimento = fmaxf(erro_aquecimento, erro);
+            }
+        }
+
+        filtro.reiniciar();
+        std::vector<float> saida(quantidade);
+        for (size_t i = 0; i < quantidade; i++) {
+            saida[i] = filtro.filtrar(traco.leituras_sem_picos[i]);
+        }
+
+        // Atraso: o deslocamento que minimiza o erro RMS contra a referência
+        double melhor_rms = INFINITY;
+        size_t melhor_atraso = 0;
+        for (size_t atraso = 0; atraso <= atraso_maximo; atraso++) {
+            double soma = 0;
+            for (size_t i = atraso_maximo; i < quantidade; i++) {
+                double erro = saida[i] - traco.referencia[i - atraso];
+                soma += erro * erro;
+            }
+            double rms = sqrt(soma / (quantidade - atraso_maximo));
+            if (rms < melhor_rms) {
+                melhor_rms = rms;
+                melhor_atraso = atraso;
+            }
+        }
+
+        printf("%s,%.1f,%.4f,%.2f,%.3f,%.1f\n", configuracao.nome, melhor_atraso * traco.dt, melhor_rms,
+               erro_max, erro_aquecimento, medir_ns(configuracao, traco));
+    }
+    return 0;
+}
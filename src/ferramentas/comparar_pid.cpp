@@ -0,0 +1,139 @@
+// Compara o núcleo do PID em ponto fixo (Q16.16) com a referência em float.
+// Erro de um passo: os dois partem do mesmo estado, então a diferença é só
+// de arredondamento e tem limite. Trajetória: a sequência inteira passa
+// pelos dois; perto da saturação o anti-windup pode decidir diferente e o
+// integrador diverge de vez em quando, então ali se mede quantos PWMs
+// inteiros divergem. Por fim, o tempo médio por chamada de cada versão.
+#include <chrono>
+#include <math.h>
+#include "controlador.h"
+#include "ferramentas.h"
+#include "nucleo_pid.h"
+
+static const float DT = 0.5;
+static const float ERRO_PERMITIDO_PASSO = 0.01;   // Bem abaixo de 1 LSB do PWM, com os ganhos de sempre
+static const float DIVERGENCIA_PERMITIDA = 0.001; // Fração de PWMs diferentes na trajetória
+
+// Passeio aleatório de erro com degraus ocasionais, como mudanças de alvo;
+// gerador congruencial para a sequência ser a mesma em toda execução
+class GeradorErro {
+public:
+    GeradorErro() : estado_(12345), erro_(10) {}
+
+    float proximo() {
+        estado_ = estado_ * 1103515245u + 12345u;
+        float aleatorio = (float)((estado_ >> 8) & 0xFFFF) / 0xFFFF - 0.5f;
+        if ((estado_ >> 24) == 0) {
+            erro_ = aleatorio * 40 + 10;    // Degrau
+        } else {
+            erro_ += aleatorio * 0.25f;
+        }
+        erro_ = constrain(erro_, -10.0f, 30.0f);
+        return erro_;
+    }
+
+private:
+    uint32_t estado_;
+    float erro_;
+};
+
+template <typename N>
+static double medir_ns(const float *erros, size_t quantidade, float kp, float ki, float kd) {
+    NucleoPID<N> pid(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+    pid.definir_ganhos(kp, ki, kd);
+
+    // Conversão fora do tempo medido: no firmware o erro já chega no formato do núcleo
+    N *entradas = new N[quantidade];
+    for (size_t i = 0; i < quantidade; i++) {
+        entradas[i] = numero_de_float<N>(erros[i]);
+    }
+
+    // Alvo zero: a medida é o próprio erro
+    const N alvo = numero_de_float<N>(0);
+    volatile int acumulado = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < quantidade; i++) {
+        acumulado += numero_para_int(pid.calcular(entradas[i], alvo));
+    }
+    auto fim = std::chrono::steady_clock::now();
+
+    delete[] entradas;
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / quantidade;
+}
+
+// O arredondamento da medida e dos ganhos cresce com eles: com ganhos
+// grandes o limite vira 2 LSB do Q16.16 por unidade de ganho
+static float erro_permitido_passo(float kp, float ki, float kd) {
+    return fmaxf(ERRO_PERMITIDO_PASSO, (kp + ki * DT + kd / DT) * 2.0f / Q16::UM);
+}
+
+int comparar_pid(int argc, char **argv) {
+    size_t quantidade = argc >= 1 ? strtoul(argv[0], NULL, 10) : 1000000;
+    float kp = argc >= 4 ? atof(argv[1]) : KP_INICIAL;
+    float ki = argc >= 4 ? atof(argv[2]) : KI_INICIAL;
+    float kd = argc >= 4 ? atof(argv[3]) : KD_INICIAL;
+
+    float *erros = new float[quantidade];
+    GeradorErro gerador;
+    for (size_t i = 0; i < quantidade; i++) {
+        erros[i] = gerador.proximo();
+    }
+
+    // Alvo zero em tudo: a medida é o próprio erro
+    const Q16 alvo_fixo = Q16::de_float(0);
+
+    // Um passo a partir do mesmo estado (mesmo erro anterior, integral zerada)
+    float maior_passo = 0;
+    for (size_t i = 1; i < quantidade; i++) {
+        NucleoPID<float> referencia(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+        NucleoPID<Q16> fixo(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+        referencia.definir_ganhos(kp, ki, kd);
+        fixo.definir_ganhos(kp, ki, kd);
+        referencia.calcular(erros[i - 1], 0);
+        fixo.calcular(Q16::de_float(erros[i - 1]), alvo_fixo);
+        referencia.zerar_integral();
+        fixo.zerar_integral();
+
+        float saida_float = referencia.calcular(erros[i], 0);
+        float saida_fixo = fixo.calcular(Q16::de_float(erros[i]), alvo_fixo).para_float();
+        maior_passo = fmaxf(maior_passo, fabsf(saida_float - saida_fixo));
+    }
+
+    // Trajetória completa
+    NucleoPID<float> referencia(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+    NucleoPID<Q16> fixo(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+    referencia.definir_ganhos(kp, ki, kd);
+    fixo.definir_ganhos(kp, ki, kd);
+
+    float maior_saida = 0, maior_p = 0, maior_i = 0, maior_d = 0;
+    size_t pwm_divergente = 0;
+    for (size_t i = 0; i < quantidade; i++) {
+        float saida_float = referencia.calcular(erros[i], 0);
+        Q16 saida_fixo = fixo.calcular(Q16::de_float(erros[i]), alvo_fixo);
+
+        maior_saida = fmaxf(maior_saida, fabsf(saida_float - saida_fixo.para_float()));
+        maior_p = fmaxf(maior_p, fabsf(referencia.termo_p() - fixo.termo_p().para_float()));
+        maior_i = fmaxf(maior_i, fabsf(referencia.termo_i() - fixo.termo_i().para_float()));
+        maior_d = fmaxf(maior_d, fabsf(referencia.termo_d() - fixo.termo_d().para_float()));
+        if ((int)saida_float != saida_fixo.para_int()) {
+            pwm_divergente++;
+        }
+    }
+    float divergencia = (float)pwm_divergente / quantidade;
+
+    printf("amostras: %lu  kp=%.3f ki=%.3f kd=%.3f\n", (unsigned long)quantidade, kp, ki, kd);
+    float limite_passo = erro_permitido_passo(kp, ki, kd);
+    printf("erro de um passo: %.5f (limite %.3f)\n", maior_passo, limite_passo);
+    printf("trajetória, maior diferença: saída %.5f  P %.5f  I %.5f  D %.5f\n",
+           maior_saida, maior_p, maior_i, maior_d);
+    printf("trajetória, PWM inteiro divergente: %lu (%.3f%%, limite %.1f%%)\n",
+           (unsigned long)pwm_divergente, 100 * divergencia, 100 * DIVERGENCIA_PERMITIDA);
+    printf("ns por chamada: float %.2f  Q16.16 %.2f\n",
+           medir_ns<float>(erros, quantidade, kp, ki, kd), medir_ns<Q16>(erros, quantidade, kp, ki, kd));
+
+    delete[] erros;
+
+    bool dentro_do_limite = maior_passo <= limite_passo && divergencia <= DIVERGENCIA_PERMITIDA;
+    printf("%s\n", dentro_do_limite ? "OK" : "FALHOU");
+    return dentro_do_limite ? 0 : 1;
+}
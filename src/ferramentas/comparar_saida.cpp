@@ -0,0 +1,80 @@
+// Compara configurações do driver de PWM (ver saida_pwm.h) na planta de dois
+// nós: o ledc antigo de 8 bits, 11 bits, 11 bits com dithering e o padrão
+// (com rampa). Depois da puxada inicial, com a câmara perto do alvo, mede o
+// viés médio do duty aplicado em relação à saída pedida (o que a resolução
+// perde), a oscilação da temperatura verdadeira, o quanto o duty se mexe por
+// tick, o maior degrau de duty e a energia; em seguida mede o maior degrau
+// numa troca de alvo, que é o que a rampa limita.
+#include <math.h>
+#include "ferramentas.h"
+#include "malha_simulada.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+static const float AMBIENTE = 25;
+static const float ALVO = 4;
+static const float DEGRAU = -1;
+static const float INICIO_MEDIDA_S = 1800;
+static const float INICIO_DEGRAU_S = 3600;
+static const float DURACAO_S = 4200;
+
+struct ConfiguracaoSaida {
+    const char *nome;
+    uint8_t bits;
+    float taxa;
+    bool dithering;
+};
+
+static const ConfiguracaoSaida CONFIGURACOES[] = {
+    {"8bits", 8, 0, false},
+    {"11bits", 11, 0, false},
+    {"11bits_dithering", 11, 0, true},
+    {"padrao", RESOLUCAO_PWM_BITS, TAXA_MAXIMA_PWM, DITHERING_PWM},
+};
+
+int comparar_saida(int argc, char **argv) {
+    Serial.silenciar(true);
+    printf("saida,vies_duty,oscilacao_c,variacao_duty_por_tick,maior_degrau,energia_wh,maior_degrau_troca\n");
+
+    for (const ConfiguracaoSaida &configuracao : CONFIGURACOES) {
+        PlantaDoisNos planta;
+        planta.reiniciar(AMBIENTE);
+        SaidaPWM saida(configuracao.bits, configuracao.taxa, configuracao.dithering);
+        MalhaSimulada malha(planta, TEMPO_AMOSTRA_SEG, RESOLUCAO_SENSOR, saida);
+        malha.aplicar(CMD_DEFINIR_ALVO, ALVO);
+        if (argc >= 3) {
+            malha.aplicar(CMD_DEFINIR_PID, atof(argv[0]), atof(argv[1]), atof(argv[2]));
+        }
+        malha.aplicar(CMD_ALTERNAR);
+
+        double soma = 0, soma_quadrados = 0, energia_j = 0;
+        unsigned amostras = 0;
+        float variacao = 0, maior_degrau = 0, erro = 0;
+        for (float t = 0; t < DURACAO_S; t += TEMPO_AMOSTRA_SEG) {
+            if (t == INICIO_MEDIDA_S) {
+                malha.zerar_variacao();
+            } else if (t == INICIO_DEGRAU_S) {
+                variacao = malha.variacao_duty();
+                maior_degrau = malha.maior_degrau_duty();
+                erro = malha.erro_duty();
+                malha.zerar_variacao();
+                malha.aplicar(CMD_DEFINIR_ALVO, ALVO + DEGRAU);
+            }
+            malha.ciclo();
+            if (t >= INICIO_MEDIDA_S && t < INICIO_DEGRAU_S) {
+                float temperatura = planta.temperatura();
+                soma += temperatura;
+                soma_quadrados += temperatura * temperatura;
+                energia_j += planta.potencia_eletrica(malha.duty()) * TEMPO_AMOSTRA_SEG;
+                amostras++;
+            }
+        }
+
+        double media = soma / amostras;
+        float ticks = (INICIO_DEGRAU_S - INICIO_MEDIDA_S) / TICK_SAIDA_SEG;
+        printf("%s,%.6f,%.4f,%.5f,%.4f,%.2f,%.3f\n", configuracao.nome, fabsf(erro) / ticks,
+               sqrt(fmax(soma_quadrados / amostras - media * media, 0.0)), variacao / ticks, maior_degrau,
+               energia_j / 3600, malha.maior_degrau_duty());
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Compara estruturas do PID (ver nucleo_pid.h) na planta de dois nós:
+// derivada sobre o erro ou sobre a medida, com e sem filtro, e com peso do
+// alvo no termo P. As duas primeiras só diferem em c (1 contra 0), para
+// isolar o pico da derivada. A malha puxa a câmara do ambiente até o alvo,
+// que depois sobe 0.25°C e volta. A partir do primeiro degrau, mede o erro
+// (IAE), o quanto o PWM se mexe por amostra, o maior salto do PWM logo
+// depois de cada degrau e os ciclos térmicos da pastilha: oscilações do PWM
+// com mais de 20% da escala, contadas com histerese.
+// Cada degrau espera a leitura ficar do mesmo lado dos dois alvos. Se o
+// erro trocasse de sinal, Controlador::aplicar_comando reiniciaria o PID
+// (transferência sem solavanco) e apagaria a história da derivada, e as
+// estruturas dariam o mesmo salto.
+#include <math.h>
+#include "ferramentas.h"
+#include "malha_simulada.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+static const float AMBIENTE = 25;
+static const float ALVO = 4;
+static const float DEGRAU = 0.25;
+static const float INICIO_DEGRAU_S = 2400;
+static const float FIM_DEGRAU_S = 3600;
+static const float DURACAO_S = 4800;
+static const int AMPLITUDE_CICLO = PWM_MAXIMO / 5;
+
+// Ganhos padrão: a ordem de grandeza que o autoajuste obtém nessa planta,
+// onde o ruído de quantização na derivada aparece
+static const float GANHOS_PADRAO[3] = {150, 2, 2000};
+
+struct EstruturaComparada {
+    const char *nome;
+    float b, c, n;
+};
+
+static const EstruturaComparada ESTRUTURAS[] = {
+    {"classico", 1, 1, 0},
+    {"derivada_medida", 1, 0, 0},
+    {"derivada_medida_n10", 1, 0, 10},
+    {"derivada_medida_n5", 1, 0, 5},
+    {"derivada_medida_n5_b0.7", 0.7f, 0, 5},
+};
+
+// Conta meias oscilações do PWM: uma inversão só vale depois de o PWM se
+// afastar AMPLITUDE_CICLO do último extremo
+class ContadorCiclos {
+public:
+    ContadorCiclos() : extremo_(0), subindo_(true), meios_ciclos_(0) {}
+
+    void registrar(int pwm) {
+        if (subindo_ ? pwm > extremo_ : pwm < extremo_) {
+            extremo_ = pwm;
+        } else if (abs(pwm - extremo_) >= AMPLITUDE_CICLO) {
+            meios_ciclos_++;
+            subindo_ = !subindo_;
+            extremo_ = pwm;
+        }
+    }
+
+    float ciclos() const { return meios_ciclos_ / 2.0f; }
+
+private:
+    int extremo_;
+    bool subindo_;
+    unsigned meios_ciclos_;
+};
+
+int comparar_derivada(int argc, char **argv) {
+    const float *ganhos = GANHOS_PADRAO;
+    float ganhos_lidos[3];
+    if (argc >= 3) {
+        for (int i = 0; i < 3; i++) {
+            ganhos_lidos[i] = atof(argv[i]);
+        }
+        ganhos = ganhos_lidos;
+    }
+
+    Serial.silenciar(true);
+    printf("estrutura,iae,variacao_pwm,salto_degrau,ciclos_termicos,sobressinal_c\n");
+
+    for (const EstruturaComparada &estrutura : ESTRUTURAS) {
+        PlantaDoisNos planta;
+        planta.reiniciar(AMBIENTE);
+        MalhaSimulada malha(planta, TEMPO_AMOSTRA_SEG, RESOLUCAO_SENSOR);
+        malha.aplicar(CMD_DEFINIR_ALVO, ALVO);
+        malha.aplicar(CMD_DEFINIR_PID, ganhos[0], ganhos[1], ganhos[2]);
+        malha.aplicar(CMD_DEFINIR_ESTRUTURA_PID, estrutura.b, estrutura.c, estrutura.n);
+
+        float iae = 0, variacao = 0, salto = 0, sobressinal = 0;
+        unsigned amostras = 0;
+        ContadorCiclos ciclos;
+        int ultimo_pwm = 0;
+        bool ligado = false;
+        bool depois_degrau = false;
+        bool degrau_pendente = false;
+        float alvo = ALVO;
+        float proximo_alvo = ALVO;
+
+        for (float t = 0; t < DURACAO_S; t += TEMPO_AMOSTRA_SEG) {
+            if (t == INICIO_DEGRAU_S || t == FIM_DEGRAU_S) {
+                proximo_alvo = t == INICIO_DEGRAU_S ? ALVO + DEGRAU : ALVO;
+                degrau_pendente = true;
+            }
+            float medida = malha.controlador().temperatura();
+            if (degrau_pendente && (medida - alvo > 0) == (medida - proximo_alvo > 0)) {
+                alvo = proximo_alvo;
+                malha.aplicar(CMD_DEFINIR_ALVO, alvo);
+                degrau_pendente = false;
+                depois_degrau = true;
+            }
+
+            bool leitura = malha.ciclo();
+            if (leitura && !ligado) {
+                malha.aplicar(CMD_ALTERNAR);
+                ligado = true;
+            }
+            if (!leitura || t < INICIO_DEGRAU_S) {
+                ultimo_pwm = malha.controlador().pwm();
+                continue;
+            }
+
+            int pwm = malha.controlador().pwm();
+            float erro = planta.temperatura() - alvo;
+            iae += fabsf(erro) * TEMPO_AMOSTRA_SEG;
+            variacao += abs(pwm - ultimo_pwm);
+            sobressinal = fmaxf(sobressinal, -erro);
+            if (depois_degrau) {
+                salto = fmaxf(salto, abs(pwm - ultimo_pwm));
+                depois_degrau = false;
+            }
+            ciclos.registrar(pwm);
+            ultimo_pwm = pwm;
+            amostras++;
+        }
+
+        printf("%s,%.0f,%.2f,%.0f,%.1f,%.2f\n", estrutura.nome, iae, variacao / amostras, salto,
+               ciclos.ciclos(), sobressinal);
+    }
+    return 0;
+}
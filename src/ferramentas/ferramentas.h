@@ -0,0 +1,40 @@
+#ifndef FERRAMENTAS_H
+#define FERRAMENTAS_H
+
+// Ferramentas do ambiente nativo (env:native), escolhidas pelo primeiro
+// argumento da linha de comando. Retornam o código de saída do processo.
+
+// Reproduz um traço de temperatura pelo controlador real e imprime o PWM
+int reproduzir(int argc, char **argv);
+
+// Malha fechada contra as plantas simuladas, com métricas por ambiente e alvo
+int bancada(int argc, char **argv);
+
+// Núcleo do PID em Q16.16 contra a referência em float: erro e tempo por chamada
+int comparar_pid(int argc, char **argv);
+
+// Autoajuste por relé contra a planta simulada, e a malha com os ganhos obtidos
+int autoajuste_simulado(int argc, char **argv);
+
+// Filtros da leitura em um traço gravado ou sintético: atraso, ruído e custo
+int comparar_filtros(int argc, char **argv);
+
+// Estruturas do PID (derivada sobre a medida, filtro, peso do alvo) na planta simulada
+int comparar_derivada(int argc, char **argv);
+
+// Resolução, dithering e rampa do driver de PWM na planta simulada
+int comparar_saida(int argc, char **argv);
+
+// Ação antecipatória pelo lado quente com o ambiente oscilando
+int comparar_antecipacao(int argc, char **argv);
+
+// Alocações no heap por requisição de /dados, caminho com String contra o com pool
+int medir_alocacoes(int argc, char **argv);
+
+// Fragmentação do heap por requisições HTTP, listas no heap contra a arena por requisição
+int medir_fragmentacao(int argc, char **argv);
+
+// Custo por byte da análise da cabeça HTTP, linhas em String contra o analisador de passada única
+int medir_analisador(int argc, char **argv);
+
+#endif
@@ -0,0 +1,247 @@
+// Fragmentação do heap pelas requisições HTTP, com e sem a arena por
+// requisição do servidor web (AsyncRequestArena.h na biblioteca). O servidor
+// não compila no ambiente nativo; a ferramenta reproduz o que uma requisição
+// de navegador deixa no heap: o objeto da requisição, as Strings da URL e
+// de cada cabeçalho (com o SSO de 11 bytes da String do ESP32) e os nós das
+// listas de cabeçalhos e parâmetros, que são os que a arena absorve.
+// Entre as requisições ficam vivos quadros de telemetria de tamanho
+// variável, como os do SSE, que prendem os buracos deixados por elas.
+// Tudo sai de um heap simulado de primeira escolha (first-fit) do tamanho
+// do que sobra no ESP32 com o WiFi ligado.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <list>
+#include <new>
+#include "ferramentas.h"
+#include <AsyncRequestArena.h>
+
+static const size_t TAMANHO_HEAP = 48 * 1024;
+static const size_t TAMANHO_ARENA = 1024;
+static const unsigned long REQUISICOES_PADRAO = 5000;
+static const size_t QUADROS_VIVOS = 6;
+static const size_t SSO_STRING = 11;
+
+// Heap com lista implícita de blocos, cabeçalho de 8 bytes e junção dos
+// livres vizinhos durante a busca, como o multi_heap do ESP-IDF sem TLSF
+class HeapSimulado {
+public:
+    static const size_t CABECALHO = 8;
+
+    void reiniciar() {
+        Bloco *primeiro = bloco(0);
+        primeiro->tamanho = TAMANHO_HEAP;
+        primeiro->livre = 1;
+        alocacoes_ = 0;
+    }
+
+    bool contem(const void *memoria) const {
+        return (const unsigned char *)memoria >= memoria_ && (const unsigned char *)memoria < memoria_ + TAMANHO_HEAP;
+    }
+
+    void *alocar(size_t tamanho) {
+        size_t necessario = ((tamanho + 7) & ~(size_t)7) + CABECALHO;
+        for (size_t posicao = 0; posicao < TAMANHO_HEAP; posicao += bloco(posicao)->tamanho) {
+            Bloco *atual = bloco(posicao);
+            if (!atual->livre) {
+                continue;
+            }
+            juntar(posicao);
+            if (atual->tamanho < necessario) {
+                continue;
+            }
+            if (atual->tamanho - necessario >= 2 * CABECALHO) {
+                Bloco *resto = bloco(posicao + necessario);
+                resto->tamanho = atual->tamanho - necessario;
+                resto->livre = 1;
+                atual->tamanho = necessario;
+            }
+            atual->livre = 0;
+            alocacoes_++;
+            return (unsigned char *)atual + CABECALHO;
+        }
+        return NULL;
+    }
+
+    void liberar(void *memoria) { bloco((unsigned char *)memoria - memoria_ - CABECALHO)->livre = 1; }
+
+    // Junta tudo o que está livre e mede
+    void medir(size_t &livre, size_t &maior, size_t &blocos_livres) {
+        livre = maior = blocos_livres = 0;
+        for (size_t posicao = 0; posicao < TAMANHO_HEAP; posicao += bloco(posicao)->tamanho) {
+            Bloco *atual = bloco(posicao);
+            if (atual->livre) {
+                juntar(posicao);
+                livre += atual->tamanho - CABECALHO;
+                maior = atual->tamanho - CABECALHO > maior ? atual->tamanho - CABECALHO : maior;
+                blocos_livres++;
+            }
+        }
+    }
+
+    unsigned long alocacoes() const { return alocacoes_; }
+
+private:
+    struct Bloco {
+        uint32_t tamanho;   // Com o cabeçalho
+        uint32_t livre;
+    };
+
+    Bloco *bloco(size_t posicao) { return (Bloco *)(memoria_ + posicao); }
+
+    void juntar(size_t posicao) {
+        Bloco *atual = bloco(posicao);
+        while (posicao + atual->tamanho < TAMANHO_HEAP && bloco(posicao + atual->tamanho)->livre) {
+            atual->tamanho += bloco(posicao + atual->tamanho)->tamanho;
+        }
+    }
+
+    alignas(8) unsigned char memoria_[TAMANHO_HEAP];
+    unsigned long alocacoes_;
+};
+
+static HeapSimulado heap;
+
+// Alocador das listas no caminho sem arena, direto no heap simulado
+template <typename T>
+struct AlocadorHeap {
+    typedef T value_type;
+
+    AlocadorHeap() {}
+    template <typename U>
+    AlocadorHeap(const AlocadorHeap<U> &) {}
+
+    T *allocate(size_t n) { return (T *)heap.alocar(n * sizeof(T)); }
+    void deallocate(T *memoria, size_t) { heap.liberar(memoria); }
+
+    template <typename U>
+    bool operator==(const AlocadorHeap<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const AlocadorHeap<U> &) const { return false; }
+};
+
+// String do Arduino: até SSO_STRING caracteres no próprio objeto
+class TextoArduino {
+public:
+    explicit TextoArduino(const char *texto) : tamanho_(strlen(texto)), externo_(NULL) {
+        if (tamanho_ > SSO_STRING) {
+            externo_ = (char *)heap.alocar(tamanho_ + 1);
+            memcpy(externo_, texto, tamanho_ + 1);
+        }
+    }
+    TextoArduino(const TextoArduino &) = delete;
+    ~TextoArduino() {
+        if (externo_) {
+            heap.liberar(externo_);
+        }
+    }
+
+private:
+    size_t tamanho_;
+    char *externo_;
+};
+
+struct Cabecalho {
+    TextoArduino nome, valor;
+    Cabecalho(const char *n, const char *v) : nome(n), valor(v) {}
+};
+
+struct Parametro {
+    TextoArduino nome, valor;
+    Parametro(const char *n, const char *v) : nome(n), valor(v) {}
+};
+
+// O que um Chrome manda num GET de /dados
+static const char *const CABECALHOS[][2] = {
+    {"Host", "192.168.4.1"},
+    {"Connection", "keep-alive"},
+    {"User-Agent", "Mozilla/5.0 (Linux; Android 14; Pixel 7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0.0.0 Mobile Safari/537.36"},
+    {"Accept", "*/*"},
+    {"Referer", "http://192.168.4.1/"},
+    {"Accept-Encoding", "gzip, deflate"},
+    {"Accept-Language", "pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7"},
+    {"Cache-Control", "no-cache"},
+    {"Pragma", "no-cache"},
+    {"DNT", "1"},
+    {"Sec-GPC", "1"},
+    {"sec-ch-ua", "\"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\""},
+    {"sec-ch-ua-mobile", "?1"},
+    {"sec-ch-ua-platform", "\"Android\""},
+    {"If-None-Match", "\"pagina-3f2a9c1e\""},
+};
+
+struct RequisicaoHeap {
+    TextoArduino url{"/dados"};
+    TextoArduino host{"192.168.4.1"};
+    std::list<Cabecalho, AlocadorHeap<Cabecalho>> cabecalhos;
+    std::list<Parametro, AlocadorHeap<Parametro>> parametros;
+
+    size_t alocacoes_fora() const { return 0; }
+};
+
+struct RequisicaoArena {
+    TextoArduino url{"/dados"};
+    TextoArduino host{"192.168.4.1"};
+    AsyncBumpArena<TAMANHO_ARENA> arena;
+    std::list<Cabecalho, AsyncArenaAllocator<Cabecalho, TAMANHO_ARENA>> cabecalhos{
+        AsyncArenaAllocator<Cabecalho, TAMANHO_ARENA>(&arena)};
+    std::list<Parametro, AsyncArenaAllocator<Parametro, TAMANHO_ARENA>> parametros{
+        AsyncArenaAllocator<Parametro, TAMANHO_ARENA>(&arena)};
+
+    // Estouro da arena, que vai para o heap de verdade
+    size_t alocacoes_fora() const { return arena.heapAllocations(); }
+};
+
+template <typename Requisicao>
+static void simular(const char *nome, unsigned long requisicoes) {
+    heap.reiniciar();
+
+    char *quadros[QUADROS_VIVOS] = {NULL};
+    unsigned long alocacoes_inicio = 0;
+    unsigned long alocacoes_fora = 0;
+    for (unsigned long i = 0; i < requisicoes; i++) {
+        if (i == requisicoes / 10) {
+            alocacoes_inicio = heap.alocacoes();
+        }
+        Requisicao *requisicao = new (heap.alocar(sizeof(Requisicao))) Requisicao();
+        for (const auto &cabecalho : CABECALHOS) {
+            requisicao->cabecalhos.emplace_back(cabecalho[0], cabecalho[1]);
+        }
+        requisicao->parametros.emplace_back("canal", "0");
+
+        // Um quadro de telemetria nasce durante a requisição e vive mais que ela
+        size_t vaga = i % QUADROS_VIVOS;
+        if (quadros[vaga]) {
+            heap.liberar(quadros[vaga]);
+        }
+        quadros[vaga] = (char *)heap.alocar(200 + (i * 37) % 120);
+
+        if (i >= requisicoes / 10) {
+            alocacoes_fora += requisicao->alocacoes_fora();
+        }
+        requisicao->~Requisicao();
+        heap.liberar(requisicao);
+    }
+
+    size_t livre, maior, blocos_livres;
+    heap.medir(livre, maior, blocos_livres);
+    unsigned long medidas = requisicoes - requisicoes / 10;
+
+    // Descontado o quadro de telemetria, sobra o que é da requisição
+    printf("%s,%.1f,%zu,%zu,%zu,%.1f\n", nome, (double)(heap.alocacoes() - alocacoes_inicio + alocacoes_fora) / medidas - 1, livre,
+           maior, blocos_livres, 100.0 * (1 - (double)maior / livre));
+}
+
+int medir_fragmentacao(int argc, char **argv) {
+    unsigned long requisicoes = argc >= 1 ? strtoul(argv[0], NULL, 10) : REQUISICOES_PADRAO;
+    if (requisicoes < 10) {
+        fprintf(stderr, "requisicoes >= 10\n");
+        return 2;
+    }
+
+    printf("listas,alocacoes_por_requisicao,bytes_livres,maior_bloco_livre,blocos_livres,fragmentacao_pct\n");
+    simular<RequisicaoHeap>("heap", requisicoes);
+    simular<RequisicaoArena>("arena", requisicoes);
+    return 0;
+}
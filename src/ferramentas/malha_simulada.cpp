@@ -0,0 +1,61 @@
+#include "malha_simulada.h"
+
+MalhaSimulada::MalhaSimulada(PlantaTermica &planta, float tempo_amostra_seg, uint8_t resolucao,
+                             const SaidaPWM &saida)
+    : planta_(planta), tempo_amostra_seg_(tempo_amostra_seg), agora_ms_(0),
+      barramento_(0), sensores_(&barramento_), leitor_(barramento_, sensores_), controlador_(tempo_amostra_seg),
+      saida_(saida), sensor_quente_(false), variacao_duty_(0), maior_degrau_duty_(0), erro_duty_(0) {
+    saida_.desligar();
+    ledcWrite(0, 0);
+    definir_millis_nativo(0);
+    sensores_.definir_temperatura(planta_.temperatura());
+    static const ConfiguracaoCanal CANAL = {0, {0}};
+    leitor_.iniciar(resolucao, &CANAL, 1);
+}
+
+void MalhaSimulada::usar_sensor_quente() {
+    static const ConfiguracaoCanal CANAL = {0, {0}, {0x28, 2}};
+    sensores_.definir_quantidade(2);
+    sensores_.definir_temperatura(planta_.dissipador(), 1);
+    leitor_.iniciar(leitor_.resolucao(), &CANAL, 1);
+    sensor_quente_ = true;
+}
+
+void MalhaSimulada::aplicar(TipoComando tipo, float v0, float v1, float v2) {
+    Comando comando = {tipo, {v0, v1, v2}};
+    controlador_.aplicar_comando(comando);
+    if (!controlador_.ligado()) {
+        saida_.desligar();
+        ledcWrite(0, 0);
+    }
+}
+
+bool MalhaSimulada::ciclo() {
+    // A planta evolui com a saída do ciclo anterior, em rampa e com dithering
+    int ticks = lroundf(tempo_amostra_seg_ / TICK_SAIDA_SEG);
+    if (ticks < 1) {
+        ticks = 1;
+    }
+    float dt = tempo_amostra_seg_ / ticks;
+    for (int i = 0; i < ticks; i++) {
+        float anterior = duty();
+        ledcWrite(0, saida_.atualizar(dt));
+        float degrau = fabsf(duty() - anterior);
+        variacao_duty_ += degrau;
+        maior_degrau_duty_ = fmaxf(maior_degrau_duty_, degrau);
+        erro_duty_ += duty() - saida_.fracao();
+        planta_.avancar(duty(), dt);
+    }
+    agora_ms_ += (unsigned long)(tempo_amostra_seg_ * 1000);
+    definir_millis_nativo(agora_ms_);
+    sensores_.definir_temperatura(planta_.temperatura());
+    sensores_.definir_temperatura(planta_.dissipador(), 1);
+
+    float temperatura, quente;
+    if (!leitor_.amostrar(agora_ms_, &temperatura, &quente)) {
+        return false;
+    }
+    controlador_.processar_leitura(temperatura, agora_ms_, sensor_quente_ ? quente : NAN);
+    saida_.definir_alvo(controlador_.saida() / PWM_MAXIMO);
+    return true;
+}
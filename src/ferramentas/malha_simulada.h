@@ -0,0 +1,55 @@
+#ifndef MALHA_SIMULADA_H
+#define MALHA_SIMULADA_H
+
+#include <DallasTemperature.h>
+#include "controlador.h"
+#include "leitor_ds18b20.h"
+#include "planta_termica.h"
+#include "saida_pwm.h"
+
+const float TICK_SAIDA_SEG = 0.125;    // Tick da tarefa de controle no firmware
+
+// Malha fechada em tempo simulado, pelo mesmo caminho do firmware:
+// planta -> DS18B20 simulado -> LeitorDS18B20 -> Controlador -> SaidaPWM -> ledc -> planta
+// A planta avança de tick em tick, como a saída no firmware.
+class MalhaSimulada {
+public:
+    MalhaSimulada(PlantaTermica &planta, float tempo_amostra_seg, uint8_t resolucao,
+                  const SaidaPWM &saida = SaidaPWM());
+
+    Controlador &controlador() { return controlador_; }
+
+    // Acrescenta um segundo DS18B20 no dissipador da planta, lido como o
+    // lado quente do canal (ação antecipatória)
+    void usar_sensor_quente();
+    void aplicar(TipoComando tipo, float v0 = 0, float v1 = 0, float v2 = 0);
+
+    // Avança um período de amostra; retorna true se houve leitura nova
+    bool ciclo();
+
+    unsigned long agora_ms() const { return agora_ms_; }
+    float duty() const { return (float)ledc_duty_nativo(0) / saida_.duty_maximo(); }
+
+    // Duty tick a tick desde zerar_variacao(), em fração do fundo de escala:
+    // soma dos movimentos, maior degrau e soma da diferença para a saída
+    // pedida (a parte da saída que a resolução do ledc perde)
+    void zerar_variacao() { variacao_duty_ = maior_degrau_duty_ = erro_duty_ = 0; }
+    float variacao_duty() const { return variacao_duty_; }
+    float maior_degrau_duty() const { return maior_degrau_duty_; }
+    float erro_duty() const { return erro_duty_; }
+
+private:
+    PlantaTermica &planta_;
+    const float tempo_amostra_seg_;
+    unsigned long agora_ms_;
+
+    OneWire barramento_;
+    DallasTemperature sensores_;
+    LeitorDS18B20 leitor_;
+    Controlador controlador_;
+    SaidaPWM saida_;
+    bool sensor_quente_;
+    float variacao_duty_, maior_degrau_duty_, erro_duty_;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "planta_termica.h"
+#include <math.h>
+
+static const float PASSO_INTEGRACAO = 0.05;   // s; Euler explícito é estável bem abaixo de tau
+static const float ZERO_ABSOLUTO = 273.15;
+
+// Passos de no máximo PASSO_INTEGRACAO que somam exatamente dt (o tick de
+// 125 ms não é múltiplo do passo)
+static int numero_passos(float dt) {
+    int passos = (int)ceilf(dt / PASSO_INTEGRACAO - 1e-4f);
+    return passos < 1 ? 1 : passos;
+}
+
+PlantaPrimeiraOrdem::PlantaPrimeiraOrdem(float ganho, float tau, float atraso)
+    : ganho_(ganho), tau_(tau), atraso_(atraso), ambiente_(25), temperatura_(25), posicao_(0), passo_atraso_(0) {
+    reiniciar(25);
+}
+
+void PlantaPrimeiraOrdem::reiniciar(float ambiente) {
+    ambiente_ = ambiente;
+    temperatura_ = ambiente;
+    posicao_ = 0;
+    for (int i = 0; i < MAXIMO_ATRASO; i++) {
+        entradas_[i] = 0;
+    }
+}
+
+void PlantaPrimeiraOrdem::avancar(float duty, float dt) {
+    int passos = numero_passos(dt);
+    float h = dt / passos;
+    int atraso_passos = (int)lroundf(atraso_ / h);
+    if (atraso_passos >= MAXIMO_ATRASO) {
+        atraso_passos = MAXIMO_ATRASO - 1;
+    }
+    for (int passo = 0; passo < passos; passo++) {
+        // Fila circular com a entrada de atraso_ segundos atrás
+        entradas_[posicao_] = duty;
+        float atrasada = entradas_[(posicao_ - atraso_passos + MAXIMO_ATRASO) % MAXIMO_ATRASO];
+        posicao_ = (posicao_ + 1) % MAXIMO_ATRASO;
+
+        temperatura_ += h * ((ambiente_ - temperatura_) - ganho_ * atrasada) / tau_;
+    }
+}
+
+void PlantaDoisNos::reiniciar(float ambiente) {
+    ambiente_ = ambiente;
+    fria_ = ambiente;
+    quente_ = ambiente;
+    sensor_ = ambiente;
+}
+
+void PlantaDoisNos::avancar(float duty, float dt) {
+    int passos = numero_passos(dt);
+    float h = dt / passos;
+    for (int passo = 0; passo < passos; passo++) {
+        float tc = fria_ + ZERO_ABSOLUTO;
+        float th = quente_ + ZERO_ABSOLUTO;
+        float conducao = CONDUTANCIA * (th - tc);
+
+        // Média no período do PWM: bombeamento e Joule só com a corrente ligada
+        float calor_frio = duty * (SEEBECK * CORRENTE * tc - 0.5f * CORRENTE * CORRENTE * RESISTENCIA) - conducao;
+        float calor_quente = duty * (SEEBECK * CORRENTE * th + 0.5f * CORRENTE * CORRENTE * RESISTENCIA) - conducao;
+
+        fria_ += h * (-calor_frio + (ambiente_ - fria_) / ISOLAMENTO) / CAPACIDADE_FRIA;
+        quente_ += h * (calor_quente - (quente_ - ambiente_) / DISSIPACAO) / CAPACIDADE_QUENTE;
+        sensor_ += h * (fria_ - sensor_) / TAU_SENSOR;
+    }
+}
+
+float PlantaDoisNos::potencia_eletrica(float duty) const {
+    float delta_t = quente_ - fria_;
+    return duty * (CORRENTE * CORRENTE * RESISTENCIA + SEEBECK * CORRENTE * delta_t);
+}
@@ -0,0 +1,74 @@
+#ifndef PLANTA_TERMICA_H
+#define PLANTA_TERMICA_H
+
+// Modelos térmicos da câmara resfriada pela Peltier, para rodar o controlador
+// em tempo simulado. A entrada é o duty do PWM (0 a 1); a saída é a
+// temperatura da câmara em °C, onde fica o DS18B20.
+class PlantaTermica {
+public:
+    virtual ~PlantaTermica() {}
+    virtual const char *nome() const = 0;
+    virtual void reiniciar(float ambiente) = 0;
+    virtual void avancar(float duty, float dt) = 0;
+    virtual float temperatura() const = 0;
+    virtual float potencia_eletrica(float duty) const = 0; // W
+    virtual float dissipador() const = 0;   // Lado quente da pastilha, °C
+
+    // Muda o ambiente sem reiniciar o estado (dia quente, ventilador parado)
+    virtual void definir_ambiente(float ambiente) = 0;
+};
+
+// Primeira ordem com tempo morto: tau·dT/dt = (ambiente - T) - ganho·u(t - atraso)
+class PlantaPrimeiraOrdem : public PlantaTermica {
+public:
+    PlantaPrimeiraOrdem(float ganho = 27, float tau = 900, float atraso = 15);
+
+    const char *nome() const override { return "fopdt"; }
+    void reiniciar(float ambiente) override;
+    void avancar(float duty, float dt) override;
+    float temperatura() const override { return temperatura_; }
+    float potencia_eletrica(float duty) const override { return duty * POTENCIA_MAXIMA; }
+    float dissipador() const override { return ambiente_; }     // Sem nó quente: o ambiente
+    void definir_ambiente(float ambiente) override { ambiente_ = ambiente; }
+
+private:
+    static const int MAXIMO_ATRASO = 4096;  // Amostras de passo de integração
+    static constexpr float POTENCIA_MAXIMA = 60;
+
+    const float ganho_, tau_, atraso_;
+    float ambiente_, temperatura_;
+    float entradas_[MAXIMO_ATRASO];
+    int posicao_;
+    float passo_atraso_;
+};
+
+// Dois nós: câmara (lado frio) e dissipador (lado quente), ligados pela
+// pastilha. O calor bombeado segue o modelo de Peltier (Seebeck, Joule e
+// condução entre as faces), com a corrente plena durante o tempo ligado.
+// O DS18B20, dentro da sonda, segue a câmara com atraso de primeira ordem.
+class PlantaDoisNos : public PlantaTermica {
+public:
+    const char *nome() const override { return "dois_nos"; }
+    void reiniciar(float ambiente) override;
+    void avancar(float duty, float dt) override;
+    float temperatura() const override { return sensor_; }
+    float potencia_eletrica(float duty) const override;
+
+    float dissipador() const override { return quente_; }
+    void definir_ambiente(float ambiente) override { ambiente_ = ambiente; }
+
+private:
+    static constexpr float SEEBECK = 0.05;          // V/K
+    static constexpr float RESISTENCIA = 2.0;       // Ω
+    static constexpr float CONDUTANCIA = 0.5;       // W/K entre as faces
+    static constexpr float CORRENTE = 5.0;          // A com o MOSFET conduzindo
+    static constexpr float CAPACIDADE_FRIA = 800;   // J/K, câmara e amostra
+    static constexpr float ISOLAMENTO = 1.5;        // K/W, câmara -> ambiente
+    static constexpr float CAPACIDADE_QUENTE = 300; // J/K, dissipador
+    static constexpr float DISSIPACAO = 0.25;       // K/W, dissipador -> ambiente
+    static constexpr float TAU_SENSOR = 20;         // s, sonda inox com o DS18B20
+
+    float ambiente_, fria_, quente_, sensor_;
+};
+
+#endif
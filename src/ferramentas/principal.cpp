@@ -0,0 +1,44 @@
+// Ponto de entrada do ambiente nativo:
+//   pio run -e native && .pio/build/native/program <ferramenta> [argumentos]
+#include <stdio.h>
+#include <string.h>
+#include "ferramentas.h"
+
+struct Ferramenta {
+    const char *nome;
+    int (*executar)(int argc, char **argv);
+    const char *uso;
+};
+
+static const Ferramenta FERRAMENTAS[] = {
+    {"reproduzir", reproduzir, "reproduzir [alvo] [kp ki kd] < traco.csv"},
+    {"bancada", bancada, "bancada [minutos] [kp ki kd]"},
+    {"pid", comparar_pid, "pid [amostras] [kp ki kd]"},
+    {"autoajuste", autoajuste_simulado, "autoajuste [ambiente] [alvo] [zn|tl]"},
+    {"filtros", comparar_filtros, "filtros [sintetico] < traco.csv"},
+    {"derivada", comparar_derivada, "derivada [kp ki kd]"},
+    {"saida", comparar_saida, "saida [kp ki kd]"},
+    {"antecipacao", comparar_antecipacao, "antecipacao [kp ki kd]"},
+    {"alocacoes", medir_alocacoes, "alocacoes [rodadas] [simultaneas]"},
+    {"fragmentacao", medir_fragmentacao, "fragmentacao [requisicoes]"},
+    {"analisador", medir_analisador, "analisador [repeticoes]"},
+};
+
+// Nos testes (pio test) cada suíte de test/ traz o seu main
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char **argv) {
+    if (argc >= 2) {
+        for (const Ferramenta &ferramenta : FERRAMENTAS) {
+            if (strcmp(argv[1], ferramenta.nome) == 0) {
+                return ferramenta.executar(argc - 2, argv + 2);
+            }
+        }
+    }
+
+    fprintf(stderr, "Uso:\n");
+    for (const Ferramenta &ferramenta : FERRAMENTAS) {
+        fprintf(stderr, "  %s %s\n", argv[0], ferramenta.uso);
+    }
+    return 2;
+}
+#endif
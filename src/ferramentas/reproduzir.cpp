@@ -0,0 +1,71 @@
+// Reproduz um traço de temperatura (o CSV de /historico?res=0, ou apenas
+// "t_ms,temperatura" por linha) pelo mesmo caminho do firmware: sensor
+// simulado, LeitorDS18B20 e Controlador, um ciclo por período de amostra.
+// Imprime t_ms,temperatura,pwm,estado em stdout; os logs vão para stderr.
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include "controlador.h"
+#include "ferramentas.h"
+#include "leitor_ds18b20.h"
+
+static const float TEMPO_AMOSTRA_SEG = 0.5;
+static const uint8_t RESOLUCAO_SENSOR = 11;
+
+int reproduzir(int argc, char **argv) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    LeitorDS18B20 leitor(barramento, sensores);
+    Controlador controlador(TEMPO_AMOSTRA_SEG);
+
+    static const ConfiguracaoCanal CANAL = {0, {0}};
+    leitor.iniciar(RESOLUCAO_SENSOR, &CANAL, 1);
+    if (argc >= 1) {
+        Comando comando = {CMD_DEFINIR_ALVO, {(float)atof(argv[0]), 0, 0}};
+        controlador.aplicar_comando(comando);
+    }
+    if (argc >= 4) {
+        Comando comando = {CMD_DEFINIR_PID, {(float)atof(argv[1]), (float)atof(argv[2]), (float)atof(argv[3])}};
+        controlador.aplicar_comando(comando);
+    }
+
+    printf("t_ms,temperatura,pwm,estado\n");
+
+    const unsigned long periodo_ms = TEMPO_AMOSTRA_SEG * 1000;
+    unsigned long agora = 0;
+    bool primeira = true;
+    bool ligar = true;
+    char linha[128];
+    while (fgets(linha, sizeof(linha), stdin)) {
+        unsigned long t_ms;
+        float temperatura;
+        if (sscanf(linha, "%lu,%f", &t_ms, &temperatura) != 2) {
+            continue; // Cabeçalho ou linha vazia
+        }
+        if (primeira) {
+            agora = t_ms;
+            primeira = false;
+        }
+
+        // Avança um ciclo de cada vez até alcançar o instante da leitura
+        while (agora <= t_ms) {
+            definir_millis_nativo(agora);
+            sensores.definir_temperatura(temperatura);
+
+            float lida;
+            if (leitor.amostrar(agora, &lida)) {
+                int pwm = controlador.processar_leitura(lida, agora);
+                ledcWrite(0, pwm);
+                printf("%lu,%.2f,%d,%u\n", agora, controlador.temperatura(), pwm, (unsigned)controlador.estado());
+
+                // Liga depois da primeira leitura, como o operador faria pela página
+                if (ligar) {
+                    Comando alternar = {CMD_ALTERNAR, {0, 0, 0}};
+                    controlador.aplicar_comando(alternar);
+                    ligar = false;
+                }
+            }
+            agora += periodo_ms;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "formato_registro.h"
+#include <stddef.h>
+
+uint32_t calcular_crc32(const void *dados, size_t tamanho, uint32_t crc) {
+    const uint8_t *bytes = (const uint8_t *)dados;
+    crc = ~crc;
+    while (tamanho--) {
+        crc ^= *bytes++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void selar_segmento(CabecalhoSegmento &cabecalho) {
+    cabecalho.assinatura = ASSINATURA_SEGMENTO;
+    cabecalho.versao = VERSAO_REGISTRO;
+    cabecalho.crc = calcular_crc32(&cabecalho, offsetof(CabecalhoSegmento, crc));
+}
+
+bool segmento_valido(const CabecalhoSegmento &cabecalho) {
+    return cabecalho.assinatura == ASSINATURA_SEGMENTO &&
+           cabecalho.versao == VERSAO_REGISTRO &&
+           cabecalho.crc == calcular_crc32(&cabecalho, offsetof(CabecalhoSegmento, crc));
+}
+
+static uint32_t calcular_crc_bloco(const CabecalhoBloco &cabecalho, const AmostraBruta *amostras) {
+    uint32_t crc = calcular_crc32(&cabecalho, offsetof(CabecalhoBloco, crc));
+    return calcular_crc32(amostras, cabecalho.quantidade * sizeof(AmostraBruta), crc);
+}
+
+void selar_bloco(CabecalhoBloco &cabecalho, const AmostraBruta *amostras) {
+    cabecalho.marcador = MARCADOR_BLOCO;
+    cabecalho.crc = calcular_crc_bloco(cabecalho, amostras);
+}
+
+bool bloco_valido(const CabecalhoBloco &cabecalho, const AmostraBruta *amostras) {
+    return cabecalho.marcador == MARCADOR_BLOCO && cabecalho.crc == calcular_crc_bloco(cabecalho, amostras);
+}
@@ -0,0 +1,208 @@
+#include "historico.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const uint16_t REGISTROS_10S_POR_5MIN = Historico::PERIODO_5MIN_MS / Historico::PERIODO_10S_MS;
+
+static int16_t para_centesimos(float temperatura) {
+    // Fora da faixa do DS18B20 (inclui DEVICE_DISCONNECTED_C) não é leitura válida
+    if (isnan(temperatura) || temperatura < -55 || temperatura > 125) {
+        return SEM_LEITURA;
+    }
+    return (int16_t)lroundf(temperatura * 100);
+}
+
+void Historico::Acumulador::zerar() {
+    minimo = INT16_MAX;
+    maximo = INT16_MIN;
+    soma = 0;
+    soma_pwm = 0;
+    validas = 0;
+    amostras = 0;
+    estado = 0;
+}
+
+void Historico::Acumulador::somar(int16_t min, int16_t max, int16_t media, uint8_t pwm, uint8_t novo_estado) {
+    if (media != SEM_LEITURA) {
+        if (min < minimo) {
+            minimo = min;
+        }
+        if (max > maximo) {
+            maximo = max;
+        }
+        soma += media;
+        validas++;
+    }
+    soma_pwm += pwm;
+    amostras++;
+    estado = novo_estado;
+}
+
+AmostraAgregada Historico::Acumulador::resultado() const {
+    AmostraAgregada agregada;
+    if (validas > 0) {
+        agregada.minimo = minimo;
+        agregada.maximo = maximo;
+        agregada.media = (int16_t)(soma / validas);
+    } else {
+        agregada.minimo = agregada.maximo = agregada.media = SEM_LEITURA;
+    }
+    agregada.pwm_medio = amostras ? (uint8_t)(soma_pwm / amostras) : 0;
+    agregada.estado = estado;
+    return agregada;
+}
+
+Historico::Historico(uint32_t periodo_bruto_ms)
+    : periodo_bruto_ms_(periodo_bruto_ms),
+      brutos_por_10s_(PERIODO_10S_MS / periodo_bruto_ms) {
+    acc_10s_.zerar();
+    acc_5min_.zerar();
+}
+
+void Historico::registrar(uint32_t tempo_ms, float temperatura, int pwm, uint8_t estado) {
+    if (bruto_.total() == 0) {
+        tempo_inicial_ms_.store(tempo_ms, std::memory_order_release);
+    }
+
+    AmostraBruta amostra;
+    amostra.temperatura = para_centesimos(temperatura);
+    amostra.pwm = (uint8_t)pwm;
+    amostra.estado = estado;
+    bruto_.adicionar(amostra);
+
+    acc_10s_.somar(amostra.temperatura, amostra.temperatura, amostra.temperatura, amostra.pwm, estado);
+    if (acc_10s_.amostras < brutos_por_10s_) {
+        return;
+    }
+    AmostraAgregada agregada = acc_10s_.resultado();
+    n10s_.adicionar(agregada);
+    acc_10s_.zerar();
+
+    acc_5min_.somar(agregada.minimo, agregada.maximo, agregada.media, agregada.pwm_medio, agregada.estado);
+    if (acc_5min_.amostras < REGISTROS_10S_POR_5MIN) {
+        return;
+    }
+    n5min_.adicionar(acc_5min_.resultado());
+    acc_5min_.zerar();
+}
+
+uint32_t Historico::periodo_ms(NivelHistorico nivel) const {
+    switch (nivel) {
+        case NIVEL_10S:
+            return PERIODO_10S_MS;
+        case NIVEL_5MIN:
+            return PERIODO_5MIN_MS;
+        default:
+            return periodo_bruto_ms_;
+    }
+}
+
+void Historico::faixa(NivelHistorico nivel, uint32_t de_ms, uint32_t ate_ms, uint32_t &primeiro, uint32_t &fim) const {
+    uint32_t total, mais_antigo;
+    switch (nivel) {
+        case NIVEL_10S:
+            total = n10s_.total();
+            mais_antigo = n10s_.mais_antigo();
+            break;
+        case NIVEL_5MIN:
+            total = n5min_.total();
+            mais_antigo = n5min_.mais_antigo();
+            break;
+        default:
+            total = bruto_.total();
+            mais_antigo = bruto_.mais_antigo();
+            break;
+    }
+
+    // O registro k do nível começa em tempo_inicial + k * período
+    const uint32_t periodo = periodo_ms(nivel);
+    const uint32_t inicio = tempo_inicial_ms();
+    primeiro = de_ms <= inicio ? 0 : (de_ms - inicio + periodo - 1) / periodo;
+    fim = ate_ms < inicio ? 0 : (ate_ms - inicio) / periodo + 1;
+
+    if (primeiro < mais_antigo) {
+        primeiro = mais_antigo;
+    }
+    if (fim > total) {
+        fim = total;
+    }
+    if (primeiro > fim) {
+        primeiro = fim;
+    }
+}
+
+// Escreve centésimos de grau como decimal ("-1.25"); campo vazio se inválido
+static int formatar_centesimos(char *destino, size_t tamanho, int16_t valor) {
+    if (valor == SEM_LEITURA) {
+        return snprintf(destino, tamanho, "%s", "");
+    }
+    int absoluto = valor < 0 ? -valor : valor;
+    return snprintf(destino, tamanho, "%s%d.%02d", valor < 0 ? "-" : "", absoluto / 100, absoluto % 100);
+}
+
+void CursorHistorico::iniciar(const Historico &origem, NivelHistorico nivel_pedido, uint32_t de_ms, uint32_t ate_ms) {
+    historico = &origem;
+    nivel = nivel_pedido;
+    cabecalho_enviado = false;
+    origem.faixa(nivel, de_ms, ate_ms, proximo, fim);
+}
+
+size_t CursorHistorico::ler_csv(char *destino, size_t tamanho) {
+    size_t escrito = 0;
+
+    if (!cabecalho_enviado) {
+        const char *cabecalho = nivel == NIVEL_BRUTO ? "t_ms,temperatura,pwm,estado\n"
+                                                     : "t_ms,min,max,media,pwm,estado\n";
+        size_t comprimento = strlen(cabecalho);
+        if (comprimento > tamanho) {
+            return 0;
+        }
+        memcpy(destino, cabecalho, comprimento);
+        escrito = comprimento;
+        cabecalho_enviado = true;
+    }
+
+    const uint32_t periodo = historico->periodo_ms(nivel);
+    const uint32_t inicio = historico->tempo_inicial_ms();
+    char linha[80];
+
+    while (proximo < fim) {
+        int n = snprintf(linha, sizeof(linha), "%lu,", (unsigned long)(inicio + proximo * periodo));
+        bool valido;
+
+        if (nivel == NIVEL_BRUTO) {
+            AmostraBruta amostra;
+            valido = historico->bruto().ler(proximo, amostra);
+            if (valido) {
+                n += formatar_centesimos(linha + n, sizeof(linha) - n, amostra.temperatura);
+                n += snprintf(linha + n, sizeof(linha) - n, ",%u,%u\n", amostra.pwm, amostra.estado);
+            }
+        } else {
+            AmostraAgregada amostra;
+            valido = nivel == NIVEL_10S ? historico->nivel_10s().ler(proximo, amostra)
+                                        : historico->nivel_5min().ler(proximo, amostra);
+            if (valido) {
+                n += formatar_centesimos(linha + n, sizeof(linha) - n, amostra.minimo);
+                linha[n++] = ',';
+                n += formatar_centesimos(linha + n, sizeof(linha) - n, amostra.maximo);
+                linha[n++] = ',';
+                n += formatar_centesimos(linha + n, sizeof(linha) - n, amostra.media);
+                n += snprintf(linha + n, sizeof(linha) - n, ",%u,%u\n", amostra.pwm_medio, amostra.estado);
+            }
+        }
+
+        if (!valido) {
+            proximo++; // Sobrescrito durante a leitura: o escritor já passou por aqui
+            continue;
+        }
+        if (escrito + n > tamanho) {
+            break; // Linha fica para a próxima chamada
+        }
+        memcpy(destino + escrito, linha, n);
+        escrito += n;
+        proximo++;
+    }
+
+    return escrito;
+}
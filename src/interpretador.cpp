@@ -0,0 +1,201 @@
+#include "interpretador.h"
+#include <ArduinoJson.h>
+#include <math.h>
+#include <string.h>
+#include "controlador.h"
+#include "filtros.h"
+#include "protocolo_ws.h"
+
+static size_t serializar_snapshot(JsonDocument &doc, const SnapshotControlador &snapshot, char *destino,
+                                  size_t tamanho) {
+    doc["temperatura"] = snapshot.temperatura;
+    doc["alvo"] = snapshot.alvo;
+    doc["erro"] = snapshot.erro;
+    doc["pwm"] = snapshot.pwm;
+    doc["ligado"] = snapshot.ligado;
+    doc["estado"] = snapshot.estado;
+    doc["limitReached"] = snapshot.limite_atingido;
+    doc["canal"] = snapshot.canal;
+    doc["resolucao"] = snapshot.resolucao;
+    doc["periodo_ms"] = snapshot.periodo_ms;
+    doc["termo_ff"] = snapshot.termo_ff;
+    if (isnan(snapshot.temperatura_quente)) {
+        doc["quente"] = nullptr;
+    } else {
+        doc["quente"] = snapshot.temperatura_quente;
+    }
+    return serializeJson(doc, destino, tamanho);
+}
+
+size_t serializar_snapshot_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho) {
+    JsonDocument doc;
+    return serializar_snapshot(doc, snapshot, destino, tamanho);
+}
+
+size_t serializar_snapshot_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho,
+                                ArduinoJson::Allocator &alocador) {
+    JsonDocument doc(&alocador);
+    return serializar_snapshot(doc, snapshot, destino, tamanho);
+}
+
+size_t serializar_antecipacao_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho) {
+    JsonDocument doc;
+    doc["ganho"] = snapshot.ganho_antecipacao;
+    doc["base"] = snapshot.base_antecipacao;
+    doc["aprender"] = snapshot.aprender_antecipacao;
+    doc["blocos"] = snapshot.blocos_antecipacao;
+    return serializeJson(doc, destino, tamanho);
+}
+
+size_t serializar_filtro_json(const SnapshotControlador &snapshot, char *destino, size_t tamanho) {
+    JsonDocument doc;
+    doc["filtro"] = nome_filtro((TipoFiltro)snapshot.filtro);
+    doc["mediana"] = snapshot.mediana;
+    doc["parametro"] = snapshot.parametro_filtro;
+    return serializeJson(doc, destino, tamanho);
+}
+
+size_t serializar_autoajuste_json(const ResultadoAutoajuste &resultado, char *destino, size_t tamanho) {
+    JsonDocument doc;
+    doc["fase"] = nome_fase_autoajuste((FaseAutoajuste)resultado.fase);
+    doc["regra"] = resultado.regra == REGRA_TYREUS_LUYBEN ? "tl" : "zn";
+    doc["ciclos"] = resultado.ciclos;
+    doc["ciclos_necessarios"] = (int)AutoajusteRele::CICLOS_MEDIDOS;   // Por valor: a constante não tem definição fora da classe
+    if (resultado.fase == AUTOAJUSTE_CONCLUIDO) {
+        doc["ku"] = resultado.ku;
+        doc["pu_s"] = resultado.pu_s;
+        doc["kp"] = resultado.kp;
+        doc["ki"] = resultado.ki;
+        doc["kd"] = resultado.kd;
+    }
+    return serializeJson(doc, destino, tamanho);
+}
+
+// Valores que chegam da rede nunca podem levar NaN ou infinito ao controlador
+// (a conversão para o PWM seria indefinida); alvo e ganhos têm faixa própria
+static bool valores_validos(const Comando &comando) {
+    for (size_t i = 0; i < 3; i++) {
+        if (!isfinite(comando.valores[i])) {
+            return false;
+        }
+    }
+    switch (comando.tipo) {
+        case CMD_DEFINIR_ALVO:
+            return comando.valores[0] >= ALVO_MINIMO && comando.valores[0] <= ALVO_MAXIMO;
+        case CMD_DEFINIR_PID:
+            return comando.valores[0] >= 0 && comando.valores[1] >= 0 && comando.valores[2] >= 0;
+        default:
+            return true;
+    }
+}
+
+bool interpretar_comando_json(TipoComando tipo, const uint8_t *corpo, size_t tamanho, Comando &comando) {
+    JsonDocument doc;
+    if (deserializeJson(doc, (const char *)corpo, tamanho)) {
+        return false;
+    }
+
+    comando.tipo = tipo;
+    comando.canal = 0;
+    comando.valores[0] = comando.valores[1] = comando.valores[2] = 0;
+    switch (tipo) {
+        case CMD_DEFINIR_ALVO:
+            if (!doc["alvo"].is<float>()) {
+                return false;
+            }
+            comando.valores[0] = doc["alvo"].as<float>();
+            return valores_validos(comando);
+
+        case CMD_DEFINIR_PID:
+            if (!doc["kp"].is<float>() || !doc["ki"].is<float>() || !doc["kd"].is<float>()) {
+                return false;
+            }
+            comando.valores[0] = doc["kp"].as<float>();
+            comando.valores[1] = doc["ki"].as<float>();
+            comando.valores[2] = doc["kd"].as<float>();
+            return valores_validos(comando);
+
+        case CMD_AUTOAJUSTAR: {
+            const char *regra = doc["regra"] | "zn";
+            if (strcmp(regra, "zn") == 0) {
+                comando.valores[0] = REGRA_ZIEGLER_NICHOLS;
+            } else if (strcmp(regra, "tl") == 0) {
+                comando.valores[0] = REGRA_TYREUS_LUYBEN;
+            } else {
+                return false;
+            }
+            comando.valores[1] = doc["histerese"] | 0.0f;
+            return comando.valores[1] >= 0 && valores_validos(comando);
+        }
+
+        case CMD_DEFINIR_FILTRO: {
+            const char *nome = doc["filtro"] | "";
+            int tipo = 0;
+            while (tipo < NUM_TIPOS_FILTRO && strcmp(nome, nome_filtro((TipoFiltro)tipo)) != 0) {
+                tipo++;
+            }
+            if (tipo == NUM_TIPOS_FILTRO) {
+                return false;
+            }
+            comando.valores[0] = tipo;
+            comando.valores[1] = (doc["mediana"] | false) ? 1 : 0;
+            comando.valores[2] = doc["parametro"] | parametro_padrao_filtro((TipoFiltro)tipo);
+            return comando.valores[2] > 0 && valores_validos(comando);
+        }
+
+        case CMD_DEFINIR_ANTECIPACAO:
+            if (!doc["ganho"].is<float>() || !doc["base"].is<float>()) {
+                return false;
+            }
+            comando.valores[0] = doc["ganho"].as<float>();
+            comando.valores[1] = doc["base"].as<float>();
+            comando.valores[2] = (doc["aprender"] | false) ? 1 : 0;
+            return valores_validos(comando);
+
+        case CMD_DEFINIR_ESTRUTURA_PID:
+            if (!doc["b"].is<float>() || !doc["c"].is<float>() || !doc["n"].is<float>()) {
+                return false;
+            }
+            comando.valores[0] = doc["b"].as<float>();
+            comando.valores[1] = doc["c"].as<float>();
+            comando.valores[2] = doc["n"].as<float>();
+            return comando.valores[0] >= 0 && comando.valores[0] <= 1 &&
+                   comando.valores[1] >= 0 && comando.valores[1] <= 1 && comando.valores[2] >= 0 &&
+                   valores_validos(comando);
+
+        default:
+            return false; // Comando sem corpo
+    }
+}
+
+bool interpretar_quadro_comando(const uint8_t *dados, size_t tamanho, Comando &comando) {
+    size_t num_valores = 0;
+
+    switch (dados[0]) {
+        case QUADRO_DEFINIR_ALVO:
+            comando.tipo = CMD_DEFINIR_ALVO;
+            num_valores = 1;
+            break;
+        case QUADRO_DEFINIR_PID:
+            comando.tipo = CMD_DEFINIR_PID;
+            num_valores = 3;
+            break;
+        case QUADRO_ALTERNAR:
+            comando.tipo = CMD_ALTERNAR;
+            break;
+        case QUADRO_RESETAR_LIMITE:
+            comando.tipo = CMD_RESETAR_LIMITE;
+            break;
+        default:
+            return false;
+    }
+    size_t tamanho_valores = 1 + num_valores * sizeof(float);
+    if (tamanho != tamanho_valores && tamanho != tamanho_valores + 1) {
+        return false;
+    }
+
+    comando.valores[0] = comando.valores[1] = comando.valores[2] = 0;
+    memcpy(comando.valores, dados + 1, num_valores * sizeof(float));
+    comando.canal = tamanho > tamanho_valores ? dados[tamanho_valores] : 0;
+    return valores_validos(comando);
+}
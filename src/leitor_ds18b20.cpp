@@ -0,0 +1,221 @@
+#include "leitor_ds18b20.h"
+#include <string.h>
+
+static bool endereco_vazio(const uint8_t *endereco) {
+    for (uint8_t i = 0; i < sizeof(DeviceAddress); i++) {
+        if (endereco[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Comando e posições do scratchpad do DS18B20 (a biblioteca não os exporta)
+static const uint8_t GRAVAR_SCRATCHPAD = 0x4E;
+static const uint8_t TAMANHO_SCRATCHPAD = 9;
+static const uint8_t POSICAO_TH = 2;
+static const uint8_t POSICAO_TL = 3;
+static const uint8_t POSICAO_CONFIGURACAO = 4;
+
+// Bits 5 e 6 do byte de configuração; os demais são lidos sempre como 1
+static uint8_t configuracao_da_resolucao(uint8_t resolucao) {
+    return ((resolucao - 9) & 3) << 5 | 0x1F;
+}
+
+LeitorDS18B20::LeitorDS18B20(OneWire &barramento, DallasTemperature &sensores)
+    : barramento_(barramento), sensores_(sensores) {}
+
+void LeitorDS18B20::iniciar(uint8_t resolucao, const ConfiguracaoCanal *canais, size_t num_canais) {
+    resolucao_ = resolucao;
+    resolucao_pendente_ = resolucao;
+    resolucao_leitura_ = resolucao;
+    canais_ = canais;
+    num_canais_ = num_canais < MAXIMO_CANAIS ? num_canais : MAXIMO_CANAIS;
+    tempo_conversao_ms_ = sensores_.millisToWaitForConversion(resolucao);
+    estado_ = OCIOSO;
+    buscar_sensores(millis());
+}
+
+// Índice do endereço entre os encontrados, marcando-o como usado; -1 se o
+// endereço é vazio ou o sensor não está no barramento
+int8_t LeitorDS18B20::procurar_endereco(const uint8_t *endereco, bool *usado) const {
+    if (endereco_vazio(endereco)) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < num_encontrados_; i++) {
+        if (memcmp(encontrados_[i], endereco, sizeof(DeviceAddress)) == 0) {
+            usado[i] = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// A busca no barramento acontece só aqui; as leituras usam o endereço
+void LeitorDS18B20::buscar_sensores(unsigned long agora) {
+    unsigned long inicio_us = micros();
+    uint8_t anteriores = num_encontrados_;
+
+    // begin() refaz a enumeração
+    sensores_.begin();
+    sensores_.setWaitForConversion(false);
+
+    num_encontrados_ = 0;
+    uint8_t quantidade = sensores_.getDeviceCount();
+    for (uint8_t i = 0; i < quantidade && num_encontrados_ < MAXIMO_SENSORES; i++) {
+        uint8_t *endereco = encontrados_[num_encontrados_];
+        if (!sensores_.getAddress(endereco, i)) {
+            continue;
+        }
+        uint8_t scratchpad[TAMANHO_SCRATCHPAD];
+        bool lido = sensores_.readScratchPad(endereco, scratchpad);
+        alarmes_[num_encontrados_][0] = lido ? scratchpad[POSICAO_TH] : 0;
+        alarmes_[num_encontrados_][1] = lido ? scratchpad[POSICAO_TL] : 0;
+        configuracao_[num_encontrados_] = lido ? scratchpad[POSICAO_CONFIGURACAO] : 0;
+        num_encontrados_++;
+    }
+    // A resolução vale também para sensores novos
+    gravar_resolucao(resolucao_);
+
+    bool usado[MAXIMO_SENSORES] = {false};
+
+    // Primeiro os endereços configurados (câmara e lado quente)...
+    for (size_t canal = 0; canal < num_canais_; canal++) {
+        sensor_do_canal_[canal] = procurar_endereco(canais_[canal].sensor, usado);
+        sensor_quente_do_canal_[canal] = procurar_endereco(canais_[canal].sensor_quente, usado);
+    }
+
+    // ...depois os demais, na ordem da busca, com os sensores que sobraram
+    uint8_t proximo = 0;
+    for (size_t canal = 0; canal < num_canais_; canal++) {
+        if (sensor_do_canal_[canal] >= 0 || !endereco_vazio(canais_[canal].sensor)) {
+            continue;
+        }
+        while (proximo < num_encontrados_ && usado[proximo]) {
+            proximo++;
+        }
+        if (proximo < num_encontrados_) {
+            sensor_do_canal_[canal] = proximo;
+            usado[proximo] = true;
+        }
+    }
+
+    ultima_busca_ = agora;
+    tempo_busca_us_ = micros() - inicio_us;
+    buscas_++;
+
+    if (buscas_ == 1 || num_encontrados_ != anteriores) {
+        Serial.printf("DS18B20: %u sensores no barramento (busca em %lu us)\n",
+                      num_encontrados_, (unsigned long)tempo_busca_us_);
+        for (size_t canal = 0; canal < num_canais_; canal++) {
+            if (sensor_do_canal_[canal] < 0) {
+                Serial.printf("ERRO: canal %u sem sensor\n", (unsigned)canal);
+            }
+            if (sensor_quente_do_canal_[canal] < 0 && !endereco_vazio(canais_[canal].sensor_quente)) {
+                Serial.printf("ERRO: canal %u sem o sensor do lado quente\n", (unsigned)canal);
+            }
+        }
+    }
+}
+
+// Só o WRITE SCRATCHPAD, sem COPY SCRATCHPAD: nada vai para a EEPROM
+void LeitorDS18B20::gravar_resolucao(uint8_t resolucao) {
+    uint8_t configuracao = configuracao_da_resolucao(resolucao);
+    for (uint8_t i = 0; i < num_encontrados_; i++) {
+        if (configuracao_[i] == configuracao) {
+            continue;
+        }
+        barramento_.reset();
+        barramento_.select(encontrados_[i]);
+        barramento_.write(GRAVAR_SCRATCHPAD);
+        barramento_.write(alarmes_[i][0]);
+        barramento_.write(alarmes_[i][1]);
+        barramento_.write(configuracao);
+        configuracao_[i] = configuracao;
+        gravacoes_resolucao_++;
+    }
+}
+
+bool LeitorDS18B20::precisa_busca(const float *temperaturas, const float *quentes) const {
+    for (size_t canal = 0; canal < num_canais_; canal++) {
+        if (sensor_do_canal_[canal] < 0 || temperaturas[canal] == DEVICE_DISCONNECTED_C) {
+            return true;
+        }
+        if (!endereco_vazio(canais_[canal].sensor_quente) &&
+            (sensor_quente_do_canal_[canal] < 0 || (quentes && quentes[canal] == DEVICE_DISCONNECTED_C))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const uint8_t *LeitorDS18B20::endereco_canal(size_t canal) const {
+    if (canal >= num_canais_ || sensor_do_canal_[canal] < 0) {
+        return NULL;
+    }
+    return encontrados_[sensor_do_canal_[canal]];
+}
+
+const uint8_t *LeitorDS18B20::endereco_quente(size_t canal) const {
+    if (canal >= num_canais_ || sensor_quente_do_canal_[canal] < 0) {
+        return NULL;
+    }
+    return encontrados_[sensor_quente_do_canal_[canal]];
+}
+
+bool LeitorDS18B20::conversao_concluida(unsigned long agora) {
+    if (agora - inicio_conversao_ >= tempo_conversao_ms_) {
+        return true;
+    }
+    // Lê um único bit do barramento: o sensor responde 1 ao terminar
+    return sensores_.isConversionComplete();
+}
+
+bool LeitorDS18B20::amostrar(unsigned long agora, float *temperaturas, float *quentes) {
+    bool nova_leitura = false;
+    unsigned long inicio_us = micros();
+    uint32_t busca_us = 0;
+
+    if (estado_ == CONVERTENDO) {
+        if (!conversao_concluida(agora)) {
+            return false; // Conversão ainda em andamento, tenta na próxima amostra
+        }
+        for (size_t canal = 0; canal < num_canais_; canal++) {
+            const uint8_t *endereco = endereco_canal(canal);
+            temperaturas[canal] = endereco ? sensores_.getTempC(endereco) : DEVICE_DISCONNECTED_C;
+            if (quentes) {
+                endereco = endereco_quente(canal);
+                quentes[canal] = endereco ? sensores_.getTempC(endereco) : DEVICE_DISCONNECTED_C;
+            }
+        }
+        estado_ = OCIOSO;
+        resolucao_leitura_ = resolucao_;
+        nova_leitura = true;
+
+        // Sensor ausente ou que parou de responder: procura de novo o barramento
+        if (precisa_busca(temperaturas, quentes) && agora - ultima_busca_ >= INTERVALO_BUSCA_MS) {
+            buscar_sensores(agora);
+            busca_us = tempo_busca_us_;
+        }
+    }
+
+    // Trocar a resolução grava o scratchpad de cada sensor: só quando muda
+    if (resolucao_pendente_ != resolucao_) {
+        gravar_resolucao(resolucao_pendente_);
+        resolucao_ = resolucao_pendente_;
+        tempo_conversao_ms_ = sensores_.millisToWaitForConversion(resolucao_);
+    }
+
+    // Dispara a próxima conversão, de todos os sensores, sem esperar o resultado
+    sensores_.requestTemperatures();
+    inicio_conversao_ = agora;
+    estado_ = CONVERTENDO;
+
+    // A busca é contabilizada à parte, para o tempo por leitura ficar comparável
+    tempo_barramento_us_ = micros() - inicio_us - busca_us;
+    if (tempo_barramento_us_ > tempo_barramento_max_us_) {
+        tempo_barramento_max_us_ = tempo_barramento_us_;
+    }
+
+    return nova_leitura;
+}
@@ -3,704 +3,588 @@
 #include <WiFi.h>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include "leitor_ds18b20.h"
+#include "estatisticas_periodo.h"
+#include "snapshot_controlador.h"
+#include "estado_controlador.h"
+#include "controlador.h"
+#include "canais.h"
+#include "saida_pwm.h"
+#include "interpretador.h"
+#include "alocador_json.h"
+#include "resposta_json.h"
+#include "rota_corpo.h"
+#include "telemetria.h"
+#include "comandos.h"
+#include "historico.h"
+#include "registro_flash.h"
+#include "pagina_gz.h"
+#include <LittleFS.h>
 
 // Configuração dos pinos
 #define PINO_DS18B20 4
-#define pino_peltier 5
+
+// Canais de controle: pino PWM da Peltier, ROM do sensor (zerado = n-ésimo
+// DS18B20 encontrado no barramento) e ROM opcional do sensor no dissipador
+// para a ação antecipatória (zerado = sem ele). Para mais malhas basta
+// acrescentar linhas aqui e um Controlador em `controladores`.
+const ConfiguracaoCanal CANAIS[] = {
+    {5, {0}, {0}},
+};
+const size_t NUM_CANAIS = sizeof(CANAIS) / sizeof(CANAIS[0]);
 
 // Configurações WiFi
 const char *nome_rede = "ESP32";
 const char *senha_rede = "12345678";
 
-// Configurações de temperatura e controle
-float TEMPERATURA_ALVO = 4.0;
-const float BANDA_MORTA = 0.2;              // Banda morta para evitar oscilação
-const float LIMITE_INICIAL = 2.0;           // Threshold para sair do resfriamento inicial
-const float TEMPO_AMOSTRA_SEG = 0.5;        // Tempo de amostragem fixo
-const int PWM_MAXIMO = 255;
-const int PWM_MINIMO = 0;
-
-// Parâmetros PID
-float kp = 30.0;
-float ki = 0.1;   
-float kd = 10.0;  
-const float INTEGRAL_MAXIMO = 100.0;        // Limite do integrador
-const unsigned long TIMEOUT_LIMITE_MS = 30000; // 30s para detectar setpoint inatingível
-
-// Variáveis do controlador PID
-float integral = 0;
-float ultimo_erro = 0;
-float ultima_temperatura = 0;
-unsigned long ultimo_tempo = 0;
-unsigned long tempo_no_maximo = 0;
-bool resfriamento_inicial = false;
-bool limite_sistema_atingido = false;
-
-// Variáveis do sistema
-bool sistema_ligado = false;
-float temperatura_atual = 0;
-int saida_pwm_atual = 0;
-String status_atual = "DESLIGADO";
+// Configurações de temperatura e controle (parâmetros do PID em controlador.h)
+// A resolução do sensor e o período de amostragem mudam com o estado dos
+// controladores (Controlador::resolucao_desejada); a tarefa acorda em ticks
+// fixos e amostra quando a conversão em andamento já terminou
+const uint32_t TICK_CONTROLE_MS = 125;      // Cabe a conversão de 9 bits (94 ms)
+const uint32_t MARGEM_CONVERSAO_MS = 25;    // Folga sobre o tempo nominal de conversão
+const uint32_t PERIODO_HISTORICO_MS = 500;  // Histórico e registro em flash têm período fixo
+const float TEMPO_AMOSTRA_INICIAL_SEG = 0.5; // Período da resolução padrão (375 ms + margem)
+
+// Tarefa de controle
+const UBaseType_t PRIORIDADE_CONTROLE = 5;  // Acima do loop do Arduino e do servidor web
+const BaseType_t NUCLEO_CONTROLE = 1;       // WiFi e lwIP rodam no núcleo 0
+const uint32_t PILHA_CONTROLE = 4096;
+
+// Estado do controle (pertence à tarefa de controle; o servidor lê o snapshot)
+Controlador controladores[NUM_CANAIS] = {
+    Controlador(TEMPO_AMOSTRA_INICIAL_SEG),
+};
+SaidaPWM saidas[NUM_CANAIS];       // Frequência, resolução, rampa e dithering em saida_pwm.h
+EstatisticasPeriodo estatisticas_periodo(TICK_CONTROLE_MS * 1000);
+Historico historico(PERIODO_HISTORICO_MS);
+RegistroFlash registro;
 
 // Objetos
+CanalSnapshot canal_snapshot[NUM_CANAIS];
+uint32_t ciclo_controle = 0;
+uint32_t periodo_amostra_ms = TEMPO_AMOSTRA_INICIAL_SEG * 1000;
 OneWire unWire(PINO_DS18B20);
 DallasTemperature sensores(&unWire);
+LeitorDS18B20 leitor(unWire, sensores);
 AsyncWebServer servidor(80);
+TelemetriaSSE telemetria_sse(canal_snapshot, NUM_CANAIS);
+TelemetriaWS telemetria_ws(NUM_CANAIS);
+TaskHandle_t tarefa_telemetria = NULL;
+AlocadorJson alocador_servidor;    // Documentos JSON das rotas (todas na tarefa do AsyncTCP)
 
-// HTML permanece o mesmo
-const char *PAGINA_HTML = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Controle Peltier 4°C</title>
-    <style>
-        * {
-            margin: 0;
-            padding: 0;
-            box-sizing: border-box;
-        }
-        
-        body {
-            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            min-height: 100vh;
-            padding: 20px;
-            color: #333;
-        }
-        
-        .container {
-            max-width: 1200px;
-            margin: 0 auto;
-            background: rgba(255, 255, 255, 0.95);
-            border-radius: 20px;
-            padding: 30px;
-            box-shadow: 0 20px 40px rgba(0,0,0,0.1);
-            backdrop-filter: blur(10px);
-        }
-        
-        .header {
-            text-align: center;
-            margin-bottom: 30px;
-        }
-        
-        .header h1 {
-            color: #2c3e50;
-            font-size: 2.5em;
-            margin-bottom: 10px;
-            text-shadow: 2px 2px 4px rgba(0,0,0,0.1);
-        }
-        
-        .header p {
-            color: #7f8c8d;
-            font-size: 1.1em;
-        }
-        
-        .dashboard {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(300px, 1fr));
-            gap: 20px;
-            margin-bottom: 30px;
-        }
-        
-        .card {
-            background: #fff;
-            border-radius: 15px;
-            padding: 25px;
-            box-shadow: 0 10px 30px rgba(0,0,0,0.1);
-            transition: transform 0.3s ease, box-shadow 0.3s ease;
-        }
-        
-        .card:hover {
-            transform: translateY(-5px);
-            box-shadow: 0 15px 40px rgba(0,0,0,0.15);
-        }
-        
-        .card h3 {
-            color: #2c3e50;
-            margin-bottom: 15px;
-            font-size: 1.4em;
-            border-bottom: 2px solid #3498db;
-            padding-bottom: 10px;
-        }
-        
-        .temp-display {
-            font-size: 3em;
-            font-weight: bold;
-            text-align: center;
-            margin: 20px 0;
-            color: #2980b9;
-            text-shadow: 2px 2px 4px rgba(0,0,0,0.1);
-        }
-        
-        .status-indicator {
-            display: inline-block;
-            width: 12px;
-            height: 12px;
-            border-radius: 50%;
-            margin-right: 8px;
-            animation: pulse 2s infinite;
-        }
-        
-        .status-on { background-color: #27ae60; }
-        .status-cooling { background-color: #3498db; }
-        .status-stable { background-color: #f39c12; }
-        .status-limit { background-color: #e74c3c; }
-        .status-off { background-color: #95a5a6; }
-        
-        @keyframes pulse {
-            0% { opacity: 1; }
-            50% { opacity: 0.5; }
-            100% { opacity: 1; }
-        }
-        
-        .control-group {
-            margin: 20px 0;
-        }
-        
-        .control-group label {
-            display: block;
-            margin-bottom: 8px;
-            font-weight: 600;
-            color: #2c3e50;
-        }
-        
-        .control-group input {
-            width: 100%;
-            padding: 12px;
-            border: 2px solid #bdc3c7;
-            border-radius: 8px;
-            font-size: 1em;
-            transition: border-color 0.3s ease;
-        }
-        
-        .control-group input:focus {
-            outline: none;
-            border-color: #3498db;
-        }
-        
-        .btn {
-            background: linear-gradient(45deg, #3498db, #2980b9);
-            color: white;
-            border: none;
-            padding: 12px 25px;
-            border-radius: 8px;
-            font-size: 1em;
-            font-weight: 600;
-            cursor: pointer;
-            transition: all 0.3s ease;
-            margin: 5px;
-            box-shadow: 0 4px 15px rgba(52, 152, 219, 0.3);
-        }
-        
-        .btn:hover {
-            transform: translateY(-2px);
-            box-shadow: 0 6px 20px rgba(52, 152, 219, 0.4);
-        }
-        
-        .btn.danger {
-            background: linear-gradient(45deg, #e74c3c, #c0392b);
-            box-shadow: 0 4px 15px rgba(231, 76, 60, 0.3);
-        }
-        
-        .btn.danger:hover {
-            box-shadow: 0 6px 20px rgba(231, 76, 60, 0.4);
-        }
-        
-        .progress-bar {
-            width: 100%;
-            height: 20px;
-            background: #ecf0f1;
-            border-radius: 10px;
-            overflow: hidden;
-            margin: 10px 0;
-        }
-        
-        .progress-fill {
-            height: 100%;
-            background: linear-gradient(45deg, #3498db, #2980b9);
-            border-radius: 10px;
-            transition: width 0.3s ease;
-        }
-        
-        .info-grid {
-            display: grid;
-            grid-template-columns: 1fr 1fr;
-            gap: 15px;
-            margin-top: 20px;
-        }
-        
-        .info-item {
-            text-align: center;
-            padding: 15px;
-            background: #f8f9fa;
-            border-radius: 10px;
-        }
-        
-        .info-item .value {
-            font-size: 1.5em;
-            font-weight: bold;
-            color: #2c3e50;
-        }
-        
-        .info-item .label {
-            font-size: 0.9em;
-            color: #7f8c8d;
-            margin-top: 5px;
-        }
-        
-        .alert {
-            background: #e74c3c;
-            color: white;
-            padding: 15px;
-            border-radius: 10px;
-            margin: 10px 0;
-            text-align: center;
-            font-weight: bold;
-        }
-        
-        @media (max-width: 768px) {
-            .dashboard {
-                grid-template-columns: 1fr;
-            }
-            
-            .header h1 {
-                font-size: 2em;
-            }
-            
-            .temp-display {
-                font-size: 2.5em;
-            }
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div class="header">
-            <h1>🧊 Controle Peltier</h1>
-            <p>Sistema de Controle de Temperatura</p>
-        </div>
-        
-        <div class="dashboard">
-            <div class="card">
-                <h3>🌡️ Temperatura Atual</h3>
-                <div class="temp-display" id="tempAtual">--°C</div>
-                <div class="info-grid">
-                    <div class="info-item">
-                        <div class="value" id="tempAlvo">4.0°C</div>
-                        <div class="label">Alvo</div>
-                    </div>
-                    <div class="info-item">
-                        <div class="value" id="erro">--°C</div>
-                        <div class="label">Erro</div>
-                    </div>
-                </div>
-            </div>
-            
-            <div class="card">
-                <h3>⚡ Status do Sistema</h3>
-                <div id="limitAlert" class="alert" style="display: none;">
-                    ⚠️ LIMITE DO SISTEMA ATINGIDO - Setpoint pode ser inatingível!
-                </div>
-                <div style="margin: 20px 0;">
-                    <span class="status-indicator status-on" id="statusIndicator"></span>
-                    <span id="statusText">Carregando...</span>
-                </div>
-                <div class="progress-bar">
-                    <div class="progress-fill" id="pwmProgress" style="width: 0%"></div>
-                </div>
-                <div class="info-grid">
-                    <div class="info-item">
-                        <div class="value" id="pwmValue">0</div>
-                        <div class="label">PWM</div>
-                    </div>
-                    <div class="info-item">
-                        <div class="value" id="pwmPercent">0%</div>
-                        <div class="label">Potência</div>
-                    </div>
-                </div>
-            </div>
-            
-            <div class="card">
-                <h3>🎛️ Controles</h3>
-                <div class="control-group">
-                    <label for="tempTarget">Temperatura Alvo:</label>
-                    <input type="number" id="tempTarget" value="4.0" step="0.1" min="-10" max="50">
-                </div>
-                <div class="control-group">
-                    <button class="btn" onclick="definirAlvo()">Definir Alvo</button>
-                    <button class="btn danger" onclick="alternarSistema()">Ligar/Desligar</button>
-                    <button class="btn" onclick="resetarLimite()">Reset Limite</button>
-                </div>
-            </div>
-            
-            <div class="card">
-                <h3>🔧 Parâmetros PID</h3>
-                <div class="control-group">
-                    <label for="valorKp">Kp (Proporcional):</label>
-                    <input type="number" id="valorKp" value="30.0" step="0.1">
-                </div>
-                <div class="control-group">
-                    <label for="valorKi">Ki (Integral):</label>
-                    <input type="number" id="valorKi" value="0.1" step="0.1">
-                </div>
-                <div class="control-group">
-                    <label for="valorKd">Kd (Derivativo):</label>
-                    <input type="number" id="valorKd" value="10.0" step="0.1">
-                </div>
-                <button class="btn" onclick="definirPID()">Atualizar PID</button>
-            </div>
-        </div>
-    </div>
-
-    <script>
-        function atualizarDados() {
-            fetch('/dados')
-                .then(response => response.json())
-                .then(data => {
-                    document.getElementById('tempAtual').textContent = data.temperatura.toFixed(1) + '°C';
-                    document.getElementById('tempAlvo').textContent = data.alvo.toFixed(1) + '°C';
-                    document.getElementById('erro').textContent = Math.abs(data.erro).toFixed(2) + '°C';
-                    document.getElementById('pwmValue').textContent = data.pwm;
-                    document.getElementById('pwmPercent').textContent = Math.round((data.pwm / 255) * 100) + '%';
-                    document.getElementById('pwmProgress').style.width = Math.round((data.pwm / 255) * 100) + '%';
-                    document.getElementById('statusText').textContent = data.status;
-                    
-                    // Mostrar alerta de limite
-                    const limitAlert = document.getElementById('limitAlert');
-                    limitAlert.style.display = data.limitReached ? 'block' : 'none';
-                    
-                    // Atualizar indicador de status
-                    const indicator = document.getElementById('statusIndicator');
-                    indicator.className = 'status-indicator ';
-                    if (!data.ligado) {
-                        indicator.className += 'status-off';
-                    } else if (data.limitReached) {
-                        indicator.className += 'status-limit';
-                    } else if (data.status.includes('INICIAL')) {
-                        indicator.className += 'status-cooling';
-                    } else if (data.status.includes('ESTÁVEL')) {
-                        indicator.className += 'status-stable';
-                    } else {
-                        indicator.className += 'status-on';
-                    }
-                })
-                .catch(error => console.error('Erro:', error));
-        }
-        
-        function definirAlvo() {
-            const alvo = document.getElementById('tempTarget').value;
-            fetch('/definirAlvo', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({alvo: parseFloat(alvo)})
-            });
-        }
-        
-        function alternarSistema() {
-            fetch('/alternar', {method: 'POST'});
-        }
-        
-        function resetarLimite() {
-            fetch('/resetarLimite', {method: 'POST'});
-        }
-        
-        function definirPID() {
-            const kp = document.getElementById('valorKp').value;
-            const ki = document.getElementById('valorKi').value;
-            const kd = document.getElementById('valorKd').value;
-            
-            fetch('/definirPID', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({
-                    kp: parseFloat(kp),
-                    ki: parseFloat(ki),
-                    kd: parseFloat(kd)
-                })
-            });
-        }
-        
-        setInterval(atualizarDados, 2000);
-        atualizarDados();
-    </script>
-</body>
-</html>
-)rawliteral";
-
-void resetar_controlador() {
-    integral = 0;
-    ultimo_erro = 0;
-    ultimo_tempo = millis();
-    tempo_no_maximo = 0;
-    limite_sistema_atingido = false;
-    resfriamento_inicial = false;
-    Serial.println("Controlador resetado");
+void aplicar_comando(const Comando &comando) {
+    if (comando.tipo == CMD_RESETAR_TEMPORIZACAO) {
+        estatisticas_periodo.zerar();
+        leitor.zerar_tempos();
+        return;
+    }
+    
+    if (comando.canal >= NUM_CANAIS) {
+        return;
+    }
+    Controlador &controlador = controladores[comando.canal];
+    controlador.aplicar_comando(comando);
+    if (!controlador.ligado()) {
+        saidas[comando.canal].desligar();
+        ledcWrite(comando.canal, 0);
+    }
 }
 
-void iniciar_resfriamento() {
-    resfriamento_inicial = true;
-    integral = 0;
-    ultimo_erro = 0;
-    Serial.println("Iniciando resfriamento inicial...");
+void executar_amostra(unsigned long agora) {
+    // Ler temperaturas (conversão disparada na amostra anterior)
+    float temperaturas[MAXIMO_CANAIS];
+    float quentes[MAXIMO_CANAIS];
+    if (!leitor.amostrar(agora, temperaturas, quentes)) {
+        return; // Primeira conversão ainda em andamento
+    }
+    
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        Controlador &controlador = controladores[canal];
+        controlador.processar_leitura(temperaturas[canal], agora, quentes[canal]);
+        saidas[canal].definir_alvo(controlador.saida() / PWM_MAXIMO);
+    }
 }
 
-int calcular_pid(float temperatura_atual) {
-    unsigned long agora = millis();
-    float dt = (agora - ultimo_tempo) / 1000.0;
-    
-    // Garante sample time mínimo
-    if (dt < TEMPO_AMOSTRA_SEG) {
-        return saida_pwm_atual; // Mantém saída anterior
+// Escolhe a resolução das próximas conversões e devolve em quantos ticks sai
+// a próxima amostra. A resolução vale para o barramento inteiro, então, com
+// vários canais, prevalece a mais fina pedida.
+uint32_t agendar_proxima_amostra() {
+    uint8_t resolucao = RESOLUCAO_RAPIDA;
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        uint8_t desejada = controladores[canal].resolucao_desejada();
+        if (desejada > resolucao) {
+            resolucao = desejada;
+        }
     }
+    leitor.definir_resolucao(resolucao);
     
-    ultimo_tempo = agora;
-    
-    // CORREÇÃO CRÍTICA: erro = temperatura_atual - setpoint
-    // Positivo = precisa resfriar, Negativo = não precisa resfriar
-    float erro = temperatura_atual - TEMPERATURA_ALVO;
-    
-    // Se não precisa resfriar (temperatura abaixo do setpoint)
-    if (erro <= 0) {
-        integral = 0; // Evita windup quando não há necessidade de resfriamento
-        resfriamento_inicial = false;
-        limite_sistema_atingido = false;
-        tempo_no_maximo = 0;
-        status_atual = "SEM RESFRIAMENTO";
-        Serial.println("Setpoint atingido - PWM = 0");
-        return 0;
+    // A próxima leitura é a da conversão que acabou de ser disparada
+    uint32_t ticks = (leitor.tempo_conversao_ms() + MARGEM_CONVERSAO_MS + TICK_CONTROLE_MS - 1) / TICK_CONTROLE_MS;
+    periodo_amostra_ms = ticks * TICK_CONTROLE_MS;
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        controladores[canal].definir_periodo(periodo_amostra_ms / 1000.0f);
     }
-    
-    // Resfriamento inicial
-    if (resfriamento_inicial) {
-        status_atual = "RESFR. INICIAL";
-        if (erro <= LIMITE_INICIAL) {
-            // Transição suave para PID
-            resfriamento_inicial = false;
-            integral = 0; // Bumpless transfer
-            Serial.println("Transição para controle PID");
-        }
-        return PWM_MAXIMO;
+    return ticks;
+}
+
+void publicar_snapshot(unsigned long agora) {
+    ciclo_controle++;
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        SnapshotControlador snapshot;
+        snapshot.ciclo = ciclo_controle;
+        snapshot.tempo_ms = agora;
+        snapshot.canal = canal;
+        snapshot.resolucao = leitor.resolucao_leitura();
+        snapshot.periodo_ms = periodo_amostra_ms;
+        controladores[canal].preencher_snapshot(snapshot);
+        canal_snapshot[canal].publicar(snapshot);
     }
-    
-    // Controle PID
-    float derivada = 0;
-    if (ultimo_tempo > 0) {
-        derivada = (erro - ultimo_erro) / dt;
+}
+
+// ?canal=N escolhe a malha da rota; sem o parâmetro vale o canal 0
+bool ler_canal(AsyncWebServerRequest *request, uint8_t &canal) {
+    canal = 0;
+    if (!request->hasParam("canal")) {
+        return true;
     }
-    
-    float proporcional = kp * erro;
-    float termo_integral = ki * integral;
-    float termo_derivativo = kd * derivada;
-    
-    float saida = proporcional + termo_integral + termo_derivativo;
-    
-    // Anti-windup inteligente
-    bool saturando_alto = (saida >= PWM_MAXIMO && erro > 0);
-    bool saturando_baixo = (saida <= 0 && erro < 0);
-    
-    if (!saturando_alto && !saturando_baixo) {
-        integral += erro * dt;
-        integral = constrain(integral, -INTEGRAL_MAXIMO, INTEGRAL_MAXIMO);
+    const String &valor = request->getParam("canal")->value();
+    char *fim;
+    unsigned long numero = strtoul(valor.c_str(), &fim, 10);
+    if (valor.length() == 0 || *fim != '\0' || numero >= NUM_CANAIS) {
+        request->send(400, "text/plain", "Canal inválido");
+        return false;
     }
-    
-    // Recalcular com integral atualizada
-    saida = proporcional + (ki * integral) + termo_derivativo;
-    saida = constrain(saida, 0, PWM_MAXIMO);
-    
-    // Deadband para estabilidade
-    if (abs(erro) <= BANDA_MORTA) {
-        status_atual = "ESTÁVEL (DEADBAND)";
-        // Mantém a saída calculada pelo PID, não força zero!
-    } else {
-        status_atual = "CONTROLE PID";
+    canal = numero;
+    return true;
+}
+
+// Cópia do snapshot para uma rota; no caso raro de não conseguir uma cópia
+// consistente responde 503 em vez de esperar o controle
+bool ler_snapshot(AsyncWebServerRequest *request, uint8_t canal, SnapshotControlador &snapshot) {
+    if (!canal_snapshot[canal].ler(snapshot)) {
+        request->send(503, "text/plain", "Snapshot em atualização, tente de novo");
+        return false;
     }
-    
-    // Detectar saturação prolongada
-    if (saida >= PWM_MAXIMO - 1) {
-        if (tempo_no_maximo == 0) {
-            tempo_no_maximo = agora;
-        } else if (agora - tempo_no_maximo > TIMEOUT_LIMITE_MS) {
-            limite_sistema_atingido = true;
-            status_atual = "LIMITE ATINGIDO";
-            Serial.println("⚠️ LIMITE DO SISTEMA - Setpoint pode ser inatingível!");
-        }
-    } else {
-        tempo_no_maximo = 0;
-        if (limite_sistema_atingido && erro > LIMITE_INICIAL) {
-            limite_sistema_atingido = false; // Reset se saiu da saturação
-        }
+    return true;
+}
+
+void formatar_endereco(const uint8_t *endereco, char *texto) {
+    for (uint8_t i = 0; i < 8; i++) {
+        snprintf(texto + 2 * i, 3, "%02X", endereco[i]);
     }
+}
+
+// POST com corpo JSON que vira um comando da malha de ?canal=N
+void registrar_comando_json(const char *uri, TipoComando tipo) {
+    servidor.addHandler(new RotaCorpo(uri, [tipo](AsyncWebServerRequest *request, const uint8_t *corpo, size_t tamanho) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        Comando comando;
+        if (!interpretar_comando_json(tipo, corpo, tamanho, comando)) {
+            request->send(400, "text/plain", "JSON inválido");
+            return;
+        }
+        comando.canal = canal;
+        if (!enviar_comando(comando)) {
+            request->send(503, "text/plain", "Fila de comandos cheia");
+            return;
+        }
+        request->send(200, "text/plain", "OK");
+    }));
+}
+
+// Laço de controle com período determinístico: vTaskDelayUntil acorda a
+// tarefa em múltiplos exatos do tick, independente do tráfego HTTP
+void tarefa_controle(void *parametro) {
+    const TickType_t periodo = pdMS_TO_TICKS(TICK_CONTROLE_MS);
+    const uint32_t ticks_por_historico = PERIODO_HISTORICO_MS / TICK_CONTROLE_MS;
+    TickType_t ultimo_despertar = xTaskGetTickCount();
+    int64_t ultimo_inicio_us = 0;
+    uint32_t tick = 0;
+    uint32_t proxima_amostra = 0;
     
-    ultimo_erro = erro;
-    
-    // Debug PID detalhado
-    if (millis() % 5000 < 500) {
-        Serial.println("PID: P=" + String(proporcional, 1) + 
-                      " I=" + String(termo_integral, 1) + 
-                      " D=" + String(termo_derivativo, 1) + 
-                      " Err=" + String(erro, 2) + 
-                      " Out=" + String(saida, 1));
+    for (;;) {
+        vTaskDelayUntil(&ultimo_despertar, periodo);
+        tick++;
+        
+        int64_t inicio_us = esp_timer_get_time();
+        if (ultimo_inicio_us != 0) {
+            estatisticas_periodo.registrar(inicio_us - ultimo_inicio_us);
+        }
+        ultimo_inicio_us = inicio_us;
+        
+        Comando comando;
+        while (receber_comando(comando)) {
+            aplicar_comando(comando);
+        }
+        
+        unsigned long agora = millis();
+        if ((int32_t)(tick - proxima_amostra) >= 0) {
+            executar_amostra(agora);
+            publicar_snapshot(agora);
+            proxima_amostra = tick + agendar_proxima_amostra();
+            xTaskNotifyGive(tarefa_telemetria);
+        }
+        
+        // A saída anda a cada tick: rampa e dithering são mais rápidos que a amostra
+        for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+            ledcWrite(canal, saidas[canal].atualizar(TICK_CONTROLE_MS / 1000.0f));
+        }
+        
+        // Histórico e registro em flash acompanham só o canal 0
+        // (só depois da primeira conversão, para não gravar os 0°C iniciais)
+        if (tick % ticks_por_historico == 0 && controladores[0].recebeu_leitura()) {
+            historico.registrar(agora, controladores[0].temperatura(), controladores[0].pwm(), controladores[0].estado());
+        }
     }
-    
-    return (int)saida;
 }
 
 void setup() {
     Serial.begin(115200);
-    sensores.begin();
+    leitor.iniciar(RESOLUCAO_PADRAO, CANAIS, NUM_CANAIS);
     
-    pinMode(pino_peltier, OUTPUT);
-    ledcSetup(0, 1000, 8);
-    ledcAttachPin(pino_peltier, 0);
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        pinMode(CANAIS[canal].pino_pwm, OUTPUT);
+        if (ledcSetup(canal, FREQUENCIA_PWM_HZ, RESOLUCAO_PWM_BITS) == 0) {
+            Serial.printf("Canal %u: ledc não suporta %u Hz com %u bits\n",
+                          (unsigned)canal, (unsigned)FREQUENCIA_PWM_HZ, RESOLUCAO_PWM_BITS);
+        }
+        ledcAttachPin(CANAIS[canal].pino_pwm, canal);
+    }
     
-    resetar_controlador();
+    iniciar_fila_comandos();
+    publicar_snapshot(millis());
+    registro.iniciar(PERIODO_HISTORICO_MS);
     
     // WiFi
     WiFi.softAP(nome_rede, senha_rede);
     
     // Rotas do servidor
+    // Página gerada por scripts/gerar_pagina.py a partir de web/index.html
     servidor.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send_P(200, "text/html", PAGINA_HTML);
-    });
+        AsyncWebServerResponse *resposta;
+        if (request->hasHeader("If-None-Match") && request->header("If-None-Match").indexOf(PAGINA_ETAG) >= 0) {
+            resposta = request->beginResponse(304);
+        } else {
+            resposta = request->beginResponse(200, "text/html", PAGINA_GZ, PAGINA_GZ_TAMANHO);
+            resposta->addHeader("Content-Encoding", "gzip");
+        }
+        resposta->addHeader("ETag", PAGINA_ETAG);
+        resposta->addHeader("Cache-Control", "no-cache");
+        request->send(resposta);
+    }).addInterestingHeader("If-None-Match");
 
     servidor.on("/dados", HTTP_GET, [](AsyncWebServerRequest *request) {
-        StaticJsonDocument<300> doc;
-        doc["temperatura"] = temperatura_atual;
-        doc["alvo"] = TEMPERATURA_ALVO;
-        doc["erro"] = temperatura_atual - TEMPERATURA_ALVO;
-        doc["pwm"] = saida_pwm_atual;
-        doc["ligado"] = sistema_ligado;
-        doc["status"] = status_atual;
-        doc["limitReached"] = limite_sistema_atingido;
-        
-        String resposta;
-        serializeJson(doc, resposta);
-        request->send(200, "application/json", resposta);
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        SnapshotControlador snapshot;
+        if (!ler_snapshot(request, canal, snapshot)) {
+            return;
+        }
+        RespostaJson *resposta = new RespostaJson();
+        resposta->serializar_snapshot(snapshot, alocador_servidor);
+        request->send(resposta);
     });
 
-    servidor.on("/definirAlvo", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL,
-              [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        StaticJsonDocument<100> doc;
-        deserializeJson(doc, (const char*)data);
-        
-        float novo_alvo = doc["alvo"];
-        
-        // Bumpless transfer ao mudar setpoint
-        if (sistema_ligado) {
-            float erro_atual = temperatura_atual - TEMPERATURA_ALVO;
-            float novo_erro = temperatura_atual - novo_alvo;
-            
-            // Se mudou de precisar resfriar para não precisar, ou vice-versa
-            if ((erro_atual > 0) != (novo_erro > 0)) {
-                resetar_controlador();
+    // Canais configurados e sensores achados no barramento
+    servidor.on("/canais", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        char endereco[17];
+        JsonArray canais = doc["canais"].to<JsonArray>();
+        for (size_t i = 0; i < NUM_CANAIS; i++) {
+            JsonObject canal = canais.add<JsonObject>();
+            canal["canal"] = i;
+            canal["pino_pwm"] = CANAIS[i].pino_pwm;
+            canal["frequencia_pwm"] = FREQUENCIA_PWM_HZ;
+            canal["resolucao_pwm"] = RESOLUCAO_PWM_BITS;
+            const uint8_t *sensor = leitor.endereco_canal(i);
+            if (sensor) {
+                formatar_endereco(sensor, endereco);
+                canal["sensor"] = endereco;
+            } else {
+                canal["sensor"] = nullptr;
             }
-            
-            // Se o novo setpoint requer resfriamento inicial
-            if (novo_erro > LIMITE_INICIAL) {
-                iniciar_resfriamento();
+            const uint8_t *quente = leitor.endereco_quente(i);
+            if (quente) {
+                formatar_endereco(quente, endereco);
+                canal["sensor_quente"] = endereco;
+            } else {
+                canal["sensor_quente"] = nullptr;
             }
         }
+        JsonArray sensores = doc["sensores"].to<JsonArray>();
+        for (uint8_t i = 0; i < leitor.sensores_encontrados(); i++) {
+            formatar_endereco(leitor.endereco_encontrado(i), endereco);
+            sensores.add(endereco);
+        }
         
-        TEMPERATURA_ALVO = novo_alvo;
+        String resposta;
+        serializeJson(doc, resposta);
+        request->send(200, "application/json", resposta);
+    });
+
+    // /historico?from=&to=&res= (ms desde o boot; res em segundos: 0, 10 ou 300)
+    servidor.on("/historico", HTTP_GET, [](AsyncWebServerRequest *request) {
+        uint32_t de = 0;
+        uint32_t ate = millis();
+        uint32_t resolucao = 0;
+        if (request->hasParam("from")) {
+            de = strtoul(request->getParam("from")->value().c_str(), NULL, 10);
+        }
+        if (request->hasParam("to")) {
+            ate = strtoul(request->getParam("to")->value().c_str(), NULL, 10);
+        }
+        if (request->hasParam("res")) {
+            resolucao = strtoul(request->getParam("res")->value().c_str(), NULL, 10);
+        }
+        
+        NivelHistorico nivel;
+        if (resolucao == 0) {
+            nivel = NIVEL_BRUTO;
+        } else if (resolucao == Historico::PERIODO_10S_MS / 1000) {
+            nivel = NIVEL_10S;
+        } else if (resolucao == Historico::PERIODO_5MIN_MS / 1000) {
+            nivel = NIVEL_5MIN;
+        } else {
+            request->send(400, "text/plain", "res deve ser 0, 10 ou 300");
+            return;
+        }
+        
+        // O CSV é gerado bloco a bloco direto do anel, sem montar a resposta inteira
+        std::shared_ptr<CursorHistorico> cursor = std::make_shared<CursorHistorico>();
+        cursor->iniciar(historico, nivel, de, ate);
+        request->sendChunked("text/csv", [cursor](uint8_t *buffer, size_t tamanho, size_t indice) -> size_t {
+            size_t escrito = cursor->ler_csv((char *)buffer, tamanho);
+            // Um bloco vazio encerra a resposta: sem espaço para a próxima linha, espera o próximo ack
+            return escrito == 0 && !cursor->terminou() ? RESPONSE_TRY_AGAIN : escrito;
+        });
+    });
+
+    servidor.on("/temporizacao", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["periodo_nominal_us"] = estatisticas_periodo.periodo_nominal_us();
+        doc["amostras"] = estatisticas_periodo.amostras();
+        doc["min_us"] = estatisticas_periodo.amostras() ? estatisticas_periodo.minimo_us() : 0;
+        doc["max_us"] = estatisticas_periodo.maximo_us();
+        doc["p99_us"] = estatisticas_periodo.percentil_us(99);
+        doc["barramento_us"] = leitor.tempo_barramento_us();
+        doc["barramento_max_us"] = leitor.tempo_barramento_max_us();
+        doc["busca_us"] = leitor.tempo_busca_us();
+        doc["buscas"] = leitor.buscas();
         
-        Serial.println("Nova temperatura alvo: " + String(TEMPERATURA_ALVO) + "°C");
+        String resposta;
+        serializeJson(doc, resposta);
+        request->send(200, "application/json", resposta);
+    });
+
+    servidor.on("/resetarTemporizacao", HTTP_POST, [](AsyncWebServerRequest *request) {
+        enviar_comando(CMD_RESETAR_TEMPORIZACAO);
         request->send(200, "text/plain", "OK");
     });
 
+    registrar_comando_json("/definirAlvo", CMD_DEFINIR_ALVO);
+
     servidor.on("/alternar", HTTP_POST, [](AsyncWebServerRequest *request) {
-        sistema_ligado = !sistema_ligado;
-        if (!sistema_ligado) {
-            ledcWrite(0, 0);
-            saida_pwm_atual = 0;
-            status_atual = "DESLIGADO";
-        } else {
-            resetar_controlador();
-            float erro = temperatura_atual - TEMPERATURA_ALVO;
-            if (erro > LIMITE_INICIAL) {
-                iniciar_resfriamento();
-            }
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        if (!enviar_comando(CMD_ALTERNAR, 0, 0, 0, canal)) {
+            request->send(503, "text/plain", "Fila de comandos cheia");
+            return;
         }
-        Serial.println("Sistema " + String(sistema_ligado ? "LIGADO" : "DESLIGADO"));
         request->send(200, "text/plain", "OK");
     });
 
     servidor.on("/resetarLimite", HTTP_POST, [](AsyncWebServerRequest *request) {
-        limite_sistema_atingido = false;
-        tempo_no_maximo = 0;
-        Serial.println("Limite resetado pelo usuário");
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        if (!enviar_comando(CMD_RESETAR_LIMITE, 0, 0, 0, canal)) {
+            request->send(503, "text/plain", "Fila de comandos cheia");
+            return;
+        }
         request->send(200, "text/plain", "OK");
     });
 
-    servidor.on("/definirPID", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL,
-              [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        StaticJsonDocument<100> doc;
-        deserializeJson(doc, (const char*)data);
-        kp = doc["kp"];
-        ki = doc["ki"];
-        kd = doc["kd"];
-        integral = 0; // Reset integral quando muda parâmetros
-        Serial.println("PID atualizado - Kp:" + String(kp) + " Ki:" + String(ki) + " Kd:" + String(kd));
+    registrar_comando_json("/definirPID", CMD_DEFINIR_PID);
+
+    // Peso do alvo em P e D e filtro da derivada (ver nucleo_pid.h)
+    registrar_comando_json("/definirEstruturaPID", CMD_DEFINIR_ESTRUTURA_PID);
+
+    // Ação antecipatória pelo lado quente (ver antecipacao.h)
+    registrar_comando_json("/definirAntecipacao", CMD_DEFINIR_ANTECIPACAO);
+
+    servidor.on("/antecipacao", HTTP_GET, [](AsyncWebServerRequest *request) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        SnapshotControlador snapshot;
+        if (!ler_snapshot(request, canal, snapshot)) {
+            return;
+        }
+        char json[128];
+        serializar_antecipacao_json(snapshot, json, sizeof(json));
+        request->send(200, "application/json", json);
+    });
+
+    // Pipeline de filtragem da leitura (ver filtros.h)
+    registrar_comando_json("/definirFiltro", CMD_DEFINIR_FILTRO);
+
+    servidor.on("/filtro", HTTP_GET, [](AsyncWebServerRequest *request) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        SnapshotControlador snapshot;
+        if (!ler_snapshot(request, canal, snapshot)) {
+            return;
+        }
+        char json[128];
+        serializar_filtro_json(snapshot, json, sizeof(json));
+        request->send(200, "application/json", json);
+    });
+
+    // Autoajuste por relé: POST inicia, GET acompanha o progresso e o resultado
+    servidor.addHandler(new RotaCorpo("/autoajuste", [](AsyncWebServerRequest *request, const uint8_t *corpo, size_t tamanho) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        Comando comando;
+        if (!interpretar_comando_json(CMD_AUTOAJUSTAR, corpo, tamanho, comando)) {
+            request->send(400, "text/plain", "JSON inválido");
+            return;
+        }
+        comando.canal = canal;
+        SnapshotControlador snapshot;
+        if (!ler_snapshot(request, canal, snapshot)) {
+            return;
+        }
+        if (!snapshot.ligado) {
+            request->send(409, "text/plain", "Ligue o sistema antes do autoajuste");
+            return;
+        }
+        if (!enviar_comando(comando)) {
+            request->send(503, "text/plain", "Fila de comandos cheia");
+            return;
+        }
+        request->send(200, "text/plain", "OK");
+    }));
+
+    servidor.on("/autoajuste", HTTP_GET, [](AsyncWebServerRequest *request) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        SnapshotControlador snapshot;
+        if (!ler_snapshot(request, canal, snapshot)) {
+            return;
+        }
+        char json[256];
+        serializar_autoajuste_json(snapshot.autoajuste, json, sizeof(json));
+        request->send(200, "application/json", json);
+    });
+
+    servidor.on("/cancelarAutoajuste", HTTP_POST, [](AsyncWebServerRequest *request) {
+        uint8_t canal;
+        if (!ler_canal(request, canal)) {
+            return;
+        }
+        if (!enviar_comando(CMD_CANCELAR_AUTOAJUSTE, 0, 0, 0, canal)) {
+            request->send(503, "text/plain", "Fila de comandos cheia");
+            return;
+        }
         request->send(200, "text/plain", "OK");
     });
 
+    // Segmentos gravados na flash em /registro/sNNNNN.bin e o índice deles em
+    // /registro. Os arquivos vêm antes porque a rota do índice também aceita
+    // /registro/...; o que sobra para ela fora de /registro é segmento inexistente.
+    servidor.serveStatic("/registro/", LittleFS, "/log/").setCacheControl("no-cache");
+    servidor.on("/registro", HTTP_GET, [](AsyncWebServerRequest *request) {
+        if (request->url() != "/registro") {
+            request->send(404, "text/plain", "Segmento inexistente");
+            return;
+        }
+        EntradaIndice entradas[RegistroFlash::MAXIMO_SEGMENTOS];
+        size_t quantidade = registro.copiar_indice(entradas, RegistroFlash::MAXIMO_SEGMENTOS);
+        
+        JsonDocument doc;
+        doc["periodo_ms"] = registro.periodo_ms();
+        JsonArray segmentos = doc["segmentos"].to<JsonArray>();
+        for (size_t i = 0; i < quantidade; i++) {
+            char arquivo[24];
+            snprintf(arquivo, sizeof(arquivo), "s%05lu.bin", (unsigned long)entradas[i].segmento);
+            JsonObject segmento = segmentos.add<JsonObject>();
+            segmento["arquivo"] = arquivo;
+            segmento["boot"] = entradas[i].boot;
+            segmento["tempo_inicial_ms"] = entradas[i].tempo_inicial_ms;
+            segmento["indice_inicial"] = entradas[i].indice_inicial;
+            segmento["amostras"] = entradas[i].amostras;
+        }
+        
+        String resposta;
+        serializeJson(doc, resposta);
+        request->send(200, "application/json", resposta);
+    });
+
+    telemetria_sse.registrar(servidor);
+    telemetria_ws.registrar(servidor);
+    // Só ficam os cabeçalhos que alguma rota lê; o resto do que o navegador
+    // manda é descartado ainda na análise, sem ocupar o heap
+    servidor.setCollectAllHeaders(false);
     servidor.begin();
+    
+    // O loop do Arduino vira a tarefa de telemetria, acordada a cada ciclo
+    tarefa_telemetria = xTaskGetCurrentTaskHandle();
+    
+    xTaskCreatePinnedToCore(tarefa_controle, "controle", PILHA_CONTROLE, NULL,
+                            PRIORIDADE_CONTROLE, NULL, NUCLEO_CONTROLE);
+    
     Serial.println("=== Sistema de Controle Peltier Iniciado ===");
     Serial.println("Versão com correções técnicas implementadas");
     Serial.println("Acesse: http://" + WiFi.softAPIP().toString());
 }
 
-void loop() {
-    unsigned long agora = millis();
-    static unsigned long ultima_amostra = 0;
-    
-    // Sample time rigoroso
-    if (agora - ultima_amostra < (TEMPO_AMOSTRA_SEG * 1000)) {
-        return;
-    }
-    ultima_amostra = agora;
-    
-    // Ler temperatura
-    sensores.requestTemperatures();
-    temperatura_atual = sensores.getTempCByIndex(0);
-    
-    // Verificar sensor
-    if (temperatura_atual == DEVICE_DISCONNECTED_C || temperatura_atual < -50) {
-        Serial.println("ERRO: Sensor desconectado!");
-        ledcWrite(0, 0);
-        saida_pwm_atual = 0;
-        status_atual = "ERRO SENSOR";
-        return;
+// Log de cada amostra, a partir do snapshot: no Serial cheio a escrita
+// bloqueia, e isso só pode atrasar a telemetria, nunca tarefa_controle
+void registrar_amostra(const SnapshotControlador &snapshot) {
+    static uint32_t ultimo_debug_ms[MAXIMO_CANAIS];
+    Serial.printf("[%u] Temp: %.2f°C | Alvo: %.1f°C | Erro: %.2f°C | PWM: %d | Status: %s\n", snapshot.canal,
+                  snapshot.temperatura, snapshot.alvo, snapshot.temperatura - snapshot.alvo, snapshot.pwm,
+                  nome_estado((EstadoControlador)snapshot.estado));
+
+    // Debug PID detalhado
+    if (snapshot.tempo_ms - ultimo_debug_ms[snapshot.canal] >= 5000) {
+        ultimo_debug_ms[snapshot.canal] = snapshot.tempo_ms;
+        Serial.printf("PID: P=%.1f I=%.1f D=%.1f FF=%.1f Err=%.2f Out=%d\n", snapshot.termo_p, snapshot.termo_i,
+                      snapshot.termo_d, snapshot.termo_ff, snapshot.erro, snapshot.pwm);
     }
+}
+
+void loop() {
+    // O controle roda em tarefa_controle; aqui só se envia a telemetria,
+    // com prioridade menor, para que o lwIP nunca atrase o laço de controle
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     
-    // Filtro simples de temperatura (média móvel)
-    static float buffer_temperatura[3] = {0};
-    buffer_temperatura[0] = buffer_temperatura[1];
-    buffer_temperatura[1] = buffer_temperatura[2];
-    buffer_temperatura[2] = temperatura_atual;
-    temperatura_atual = (buffer_temperatura[0] + buffer_temperatura[1] + buffer_temperatura[2]) / 3.0;
-    
-    int saida_pwm = 0;
-    
-    if (sistema_ligado) {
-        saida_pwm = calcular_pid(temperatura_atual);
-    } else {
-        status_atual = "DESLIGADO";
+    for (size_t canal = 0; canal < NUM_CANAIS; canal++) {
+        SnapshotControlador snapshot;
+        if (!canal_snapshot[canal].ler(snapshot)) {
+            continue;   // Sai no próximo ciclo
+        }
+        telemetria_sse.publicar(snapshot);
+        telemetria_ws.publicar(snapshot);
+        registrar_amostra(snapshot);
     }
     
-    saida_pwm_atual = saida_pwm;
-    ledcWrite(0, saida_pwm);
-    
-    // Log detalhado
-    Serial.print("Temp: ");
-    Serial.print(temperatura_atual, 2);
-    Serial.print("°C | Alvo: ");
-    Serial.print(TEMPERATURA_ALVO, 1);
-    Serial.print("°C | Erro: ");
-    Serial.print(temperatura_atual - TEMPERATURA_ALVO, 2);
-    Serial.print("°C | PWM: ");
-    Serial.print(saida_pwm);
-    Serial.print(" | Status: ");
-    Serial.println(status_atual);
-}
\ No newline at end of file
+    // A escrita na flash pode levar dezenas de ms; aqui ela só atrasa a telemetria
+    registro.sincronizar(historico);
+}
@@ -0,0 +1,275 @@
+#include "registro_flash.h"
+#include <LittleFS.h>
+
+static const char *DIRETORIO_REGISTRO = "/log";
+static const char *CAMINHO_INDICE = "/log/indice.bin";
+static const char *CAMINHO_INDICE_TEMP = "/log/indice.tmp";
+
+static void caminho_segmento(char *destino, size_t tamanho, uint32_t numero) {
+    snprintf(destino, tamanho, "/log/s%05lu.bin", (unsigned long)numero);
+}
+
+bool RegistroFlash::iniciar(uint16_t periodo_ms) {
+    periodo_ms_ = periodo_ms;
+
+    if (!LittleFS.begin(true)) {
+        Serial.println("ERRO: LittleFS indisponível, registro persistente desativado");
+        return false;
+    }
+    if (!LittleFS.exists(DIRETORIO_REGISTRO)) {
+        LittleFS.mkdir(DIRETORIO_REGISTRO);
+    }
+
+    if (!carregar_indice()) {
+        Serial.println("Índice do registro ausente ou corrompido, reconstruindo...");
+        reconstruir_indice();
+    } else if (num_segmentos_ > 0) {
+        // O último segmento estava aberto quando o sistema caiu: recontar até o último bloco íntegro
+        EntradaIndice &ultimo = indice_[num_segmentos_ - 1];
+        if (!verificar_segmento(ultimo.segmento, ultimo)) {
+            ultimo.amostras = 0;
+        }
+    }
+
+    if (num_segmentos_ > 0) {
+        boot_ = indice_[num_segmentos_ - 1].boot + 1;
+        proximo_segmento_ = indice_[num_segmentos_ - 1].segmento + 1;
+    }
+    pronto_ = gravar_indice();
+
+    Serial.printf("Registro: boot %lu, %u segmentos na flash\n", (unsigned long)boot_, (unsigned)num_segmentos_);
+    return pronto_;
+}
+
+bool RegistroFlash::carregar_indice() {
+    fs::File arquivo = LittleFS.open(CAMINHO_INDICE, "r");
+    if (!arquivo) {
+        return false;
+    }
+
+    CabecalhoIndice cabecalho;
+    EntradaIndice entradas[MAXIMO_SEGMENTOS];
+    bool valido = arquivo.read((uint8_t *)&cabecalho, sizeof(cabecalho)) == sizeof(cabecalho) &&
+                  cabecalho.assinatura == ASSINATURA_INDICE &&
+                  cabecalho.versao == VERSAO_REGISTRO &&
+                  cabecalho.quantidade <= MAXIMO_SEGMENTOS;
+    if (valido) {
+        size_t tamanho = cabecalho.quantidade * sizeof(EntradaIndice);
+        valido = arquivo.read((uint8_t *)entradas, tamanho) == tamanho &&
+                 calcular_crc32(entradas, tamanho) == cabecalho.crc;
+    }
+    arquivo.close();
+    if (!valido) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> trava(trava_indice_);
+    memcpy(indice_, entradas, cabecalho.quantidade * sizeof(EntradaIndice));
+    num_segmentos_ = cabecalho.quantidade;
+    return true;
+}
+
+bool RegistroFlash::gravar_indice() {
+    CabecalhoIndice cabecalho;
+    EntradaIndice entradas[MAXIMO_SEGMENTOS];
+    cabecalho.quantidade = copiar_indice(entradas, MAXIMO_SEGMENTOS);
+    cabecalho.assinatura = ASSINATURA_INDICE;
+    cabecalho.versao = VERSAO_REGISTRO;
+    cabecalho.crc = calcular_crc32(entradas, cabecalho.quantidade * sizeof(EntradaIndice));
+
+    // Grava em um temporário e renomeia: o índice antigo só some quando o novo está completo
+    fs::File arquivo = LittleFS.open(CAMINHO_INDICE_TEMP, "w");
+    if (!arquivo) {
+        return false;
+    }
+    size_t tamanho = cabecalho.quantidade * sizeof(EntradaIndice);
+    bool ok = arquivo.write((const uint8_t *)&cabecalho, sizeof(cabecalho)) == sizeof(cabecalho) &&
+              arquivo.write((const uint8_t *)entradas, tamanho) == tamanho;
+    arquivo.close();
+    return ok && LittleFS.rename(CAMINHO_INDICE_TEMP, CAMINHO_INDICE);
+}
+
+bool RegistroFlash::verificar_segmento(uint32_t numero, EntradaIndice &entrada) {
+    char caminho[24];
+    caminho_segmento(caminho, sizeof(caminho), numero);
+    fs::File arquivo = LittleFS.open(caminho, "r");
+    if (!arquivo) {
+        return false;
+    }
+
+    CabecalhoSegmento cabecalho;
+    ContagemSegmento contagem;
+    bool valido = varrer_segmento(arquivo, cabecalho, lote_, AMOSTRAS_POR_BLOCO, contagem);
+    arquivo.close();
+    if (!valido) {
+        return false;
+    }
+    entrada.segmento = numero;
+    entrada.boot = cabecalho.boot;
+    entrada.tempo_inicial_ms = cabecalho.tempo_inicial_ms;
+    entrada.indice_inicial = contagem.indice_inicial;
+    entrada.amostras = contagem.amostras;
+    return true;
+}
+
+void RegistroFlash::inserir_no_indice(const EntradaIndice &entrada) {
+    std::lock_guard<std::mutex> trava(trava_indice_);
+
+    // Mantém a ordem por número de segmento
+    size_t posicao = num_segmentos_;
+    while (posicao > 0 && indice_[posicao - 1].segmento > entrada.segmento) {
+        posicao--;
+    }
+    if (num_segmentos_ == MAXIMO_SEGMENTOS) {
+        if (posicao == 0) {
+            return; // Mais antigo que tudo que já está no índice
+        }
+        memmove(&indice_[0], &indice_[1], (posicao - 1) * sizeof(EntradaIndice));
+        posicao--;
+    } else {
+        memmove(&indice_[posicao + 1], &indice_[posicao], (num_segmentos_ - posicao) * sizeof(EntradaIndice));
+        num_segmentos_++;
+    }
+    indice_[posicao] = entrada;
+}
+
+void RegistroFlash::reconstruir_indice() {
+    {
+        std::lock_guard<std::mutex> trava(trava_indice_);
+        num_segmentos_ = 0;
+    }
+
+    fs::File diretorio = LittleFS.open(DIRETORIO_REGISTRO);
+    fs::File arquivo = diretorio.openNextFile();
+    while (arquivo) {
+        const char *nome = strrchr(arquivo.name(), '/');
+        nome = nome ? nome + 1 : arquivo.name();
+        unsigned long numero;
+        bool eh_segmento = sscanf(nome, "s%lu.bin", &numero) == 1;
+        arquivo.close();
+
+        EntradaIndice entrada;
+        if (eh_segmento && verificar_segmento(numero, entrada)) {
+            inserir_no_indice(entrada);
+        }
+        arquivo = diretorio.openNextFile();
+    }
+    diretorio.close();
+}
+
+void RegistroFlash::remover_mais_antigo() {
+    char caminho[24];
+    {
+        std::lock_guard<std::mutex> trava(trava_indice_);
+        if (num_segmentos_ == 0) {
+            return;
+        }
+        caminho_segmento(caminho, sizeof(caminho), indice_[0].segmento);
+        memmove(&indice_[0], &indice_[1], (num_segmentos_ - 1) * sizeof(EntradaIndice));
+        num_segmentos_--;
+    }
+    LittleFS.remove(caminho);
+}
+
+bool RegistroFlash::abrir_segmento(uint32_t tempo_inicial_ms, uint32_t indice_inicial) {
+    if (num_segmentos_ == MAXIMO_SEGMENTOS) {
+        remover_mais_antigo();
+    }
+
+    char caminho[24];
+    caminho_segmento(caminho, sizeof(caminho), proximo_segmento_);
+    segmento_ = LittleFS.open(caminho, "w");
+    if (!segmento_) {
+        return false;
+    }
+
+    CabecalhoSegmento cabecalho;
+    cabecalho.periodo_ms = periodo_ms_;
+    cabecalho.boot = boot_;
+    cabecalho.tempo_inicial_ms = tempo_inicial_ms;
+    selar_segmento(cabecalho);
+    if (segmento_.write((const uint8_t *)&cabecalho, sizeof(cabecalho)) != sizeof(cabecalho)) {
+        segmento_.close();
+        return false;
+    }
+    segmento_.flush();
+    tamanho_segmento_ = sizeof(cabecalho);
+
+    {
+        std::lock_guard<std::mutex> trava(trava_indice_);
+        EntradaIndice &entrada = indice_[num_segmentos_++];
+        entrada.segmento = proximo_segmento_;
+        entrada.boot = boot_;
+        entrada.tempo_inicial_ms = tempo_inicial_ms;
+        entrada.indice_inicial = indice_inicial;
+        entrada.amostras = 0;
+    }
+    proximo_segmento_++;
+    return gravar_indice();
+}
+
+bool RegistroFlash::gravar_bloco(uint32_t indice_inicial, uint16_t quantidade, uint32_t tempo_inicial_ms) {
+    const size_t tamanho_bloco = sizeof(CabecalhoBloco) + quantidade * sizeof(AmostraBruta);
+
+    if (segmento_ && tamanho_segmento_ + tamanho_bloco > TAMANHO_MAXIMO_SEGMENTO) {
+        segmento_.close();
+    }
+    if (!segmento_ && !abrir_segmento(tempo_inicial_ms, indice_inicial)) {
+        return false;
+    }
+
+    CabecalhoBloco bloco;
+    bloco.quantidade = quantidade;
+    bloco.indice_inicial = indice_inicial;
+    selar_bloco(bloco, lote_);
+
+    size_t tamanho_amostras = quantidade * sizeof(AmostraBruta);
+    if (segmento_.write((const uint8_t *)&bloco, sizeof(bloco)) != sizeof(bloco) ||
+        segmento_.write((const uint8_t *)lote_, tamanho_amostras) != tamanho_amostras) {
+        segmento_.close();
+        return false;
+    }
+    segmento_.flush();
+    tamanho_segmento_ += tamanho_bloco;
+
+    std::lock_guard<std::mutex> trava(trava_indice_);
+    indice_[num_segmentos_ - 1].amostras += quantidade;
+    return true;
+}
+
+void RegistroFlash::sincronizar(const Historico &historico) {
+    if (!pronto_) {
+        return;
+    }
+
+    const AnelHistorico<AmostraBruta, 1200> &anel = historico.bruto();
+    while (anel.total() - proximo_indice_ >= AMOSTRAS_POR_BLOCO) {
+        // Se a flash ficou para trás a ponto do anel ter dado a volta, pula o que se perdeu
+        if (proximo_indice_ < anel.mais_antigo()) {
+            proximo_indice_ = anel.mais_antigo();
+            continue;
+        }
+
+        uint16_t quantidade = 0;
+        while (quantidade < AMOSTRAS_POR_BLOCO && anel.ler(proximo_indice_ + quantidade, lote_[quantidade])) {
+            quantidade++;
+        }
+        if (quantidade < AMOSTRAS_POR_BLOCO) {
+            continue; // Sobrescrito durante a cópia
+        }
+
+        if (!gravar_bloco(proximo_indice_, quantidade, historico.tempo_inicial_ms())) {
+            Serial.println("ERRO: falha ao gravar na flash, registro persistente desativado");
+            pronto_ = false;
+            return;
+        }
+        proximo_indice_ += quantidade;
+    }
+}
+
+size_t RegistroFlash::copiar_indice(EntradaIndice *destino, size_t maximo) const {
+    std::lock_guard<std::mutex> trava(trava_indice_);
+    size_t quantidade = num_segmentos_ < maximo ? num_segmentos_ : maximo;
+    memcpy(destino, indice_, quantidade * sizeof(EntradaIndice));
+    return quantidade;
+}
@@ -0,0 +1,120 @@
+#include "telemetria.h"
+#include "comandos.h"
+#include "protocolo_ws.h"
+
+static const char *EVENTO_TELEMETRIA = "telemetria";
+
+TelemetriaSSE::TelemetriaSSE(const CanalSnapshot *canais, size_t num_canais)
+    : canais_(canais), num_canais_(num_canais), eventos_("/eventos") {}
+
+void TelemetriaSSE::registrar(AsyncWebServer &servidor) {
+    // Quem acabou de conectar recebe o estado atual sem esperar o próximo ciclo
+    eventos_.onConnect([this](AsyncEventSourceClient *cliente) {
+        for (size_t canal = 0; canal < num_canais_; canal++) {
+            SnapshotControlador snapshot;
+            if (!canais_[canal].ler(snapshot)) {
+                continue;
+            }
+            char json[TAMANHO_JSON_SNAPSHOT];
+            serializar_snapshot_json(snapshot, json, sizeof(json));
+            cliente->send(json, EVENTO_TELEMETRIA, snapshot.ciclo);
+        }
+    });
+    servidor.addHandler(&eventos_);
+}
+
+void TelemetriaSSE::publicar(const SnapshotControlador &snapshot) {
+    if (eventos_.count() == 0) {
+        return;
+    }
+
+    char json[TAMANHO_JSON_SNAPSHOT];
+    size_t tamanho = serializar_snapshot_json(snapshot, json, sizeof(json), alocador_);
+
+    // Quadro SSE já formatado: "id: N\nevent: telemetria\ndata: {...}\n\n"
+    AsyncEvent_SharedData_t quadro = std::make_shared<String>();
+    quadro->reserve(tamanho + 48);
+    *quadro += "id: ";
+    *quadro += snapshot.ciclo;
+    *quadro += "\nevent: ";
+    *quadro += EVENTO_TELEMETRIA;
+    *quadro += "\ndata: ";
+    quadro->concat(json, tamanho);
+    *quadro += "\n\n";
+
+    eventos_.write(quadro);
+}
+
+// Interpreta um quadro de comando e o encaminha à tarefa de controle
+static ResultadoComandoWS aplicar_quadro_comando(const uint8_t *dados, size_t tamanho, size_t num_canais) {
+    Comando comando;
+    if (!interpretar_quadro_comando(dados, tamanho, comando) || comando.canal >= num_canais) {
+        return RESULTADO_INVALIDO;
+    }
+    return enviar_comando(comando) ? RESULTADO_OK : RESULTADO_FILA_CHEIA;
+}
+
+TelemetriaWS::TelemetriaWS(size_t num_canais) : num_canais_(num_canais), ws_("/ws") {}
+
+void TelemetriaWS::registrar(AsyncWebServer &servidor) {
+    ws_.onEvent([this](AsyncWebSocket *servidor_ws, AsyncWebSocketClient *cliente, AwsEventType tipo,
+                       void *arg, uint8_t *dados, size_t tamanho) {
+        tratar_evento(cliente, tipo, arg, dados, tamanho);
+    });
+    servidor.addHandler(&ws_);
+}
+
+void TelemetriaWS::tratar_evento(AsyncWebSocketClient *cliente, AwsEventType tipo, void *arg,
+                                 uint8_t *dados, size_t tamanho) {
+    if (tipo == WS_EVT_CONNECT) {
+        // Perder telemetria antiga é melhor que derrubar a conexão do painel
+        cliente->setCloseClientOnQueueFull(false);
+        return;
+    }
+    if (tipo != WS_EVT_DATA) {
+        return;
+    }
+
+    // Comandos são pequenos: só aceita mensagens binárias em um único quadro
+    AwsFrameInfo *info = (AwsFrameInfo *)arg;
+    if (!info->final || info->index != 0 || info->len != tamanho || info->opcode != WS_BINARY || tamanho == 0) {
+        return;
+    }
+
+    QuadroResposta resposta;
+    resposta.tipo = QUADRO_RESPOSTA;
+    resposta.comando = dados[0];
+    resposta.resultado = aplicar_quadro_comando(dados, tamanho, num_canais_);
+    cliente->binary((const uint8_t *)&resposta, sizeof(resposta));
+}
+
+void TelemetriaWS::publicar(const SnapshotControlador &snapshot) {
+    ws_.cleanupClients();
+    if (ws_.count() == 0) {
+        return;
+    }
+
+    QuadroTelemetria quadro;
+    quadro.tipo = QUADRO_TELEMETRIA;
+    quadro.estado = snapshot.estado;
+    quadro.flags = (snapshot.ligado ? FLAG_LIGADO : 0) | (snapshot.limite_atingido ? FLAG_LIMITE_ATINGIDO : 0);
+    quadro.canal = snapshot.canal;
+    quadro.ciclo = snapshot.ciclo;
+    quadro.tempo_ms = snapshot.tempo_ms;
+    quadro.temperatura = snapshot.temperatura;
+    quadro.alvo = snapshot.alvo;
+    quadro.erro = snapshot.erro;
+    quadro.termo_p = snapshot.termo_p;
+    quadro.termo_i = snapshot.termo_i;
+    quadro.termo_d = snapshot.termo_d;
+    quadro.pwm = snapshot.pwm;
+    quadro.periodo_ms = snapshot.periodo_ms;
+    quadro.resolucao = snapshot.resolucao;
+    quadro.termo_ff = snapshot.termo_ff;
+    quadro.temperatura_quente = snapshot.temperatura_quente;
+
+    // Um único buffer referenciado pela fila de todos os clientes
+    const uint8_t *bytes = (const uint8_t *)&quadro;
+    AsyncWebSocketSharedBuffer buffer = std::make_shared<std::vector<uint8_t>>(bytes, bytes + sizeof(quadro));
+    ws_.binaryAll(buffer);
+}
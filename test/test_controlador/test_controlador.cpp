@@ -0,0 +1,179 @@
+// Máquina de estados do Controlador (controlador.h): resfriamento inicial,
+// banda morta, erro do sensor, limite do sistema e comandos
+#include <unity.h>
+#include <Arduino.h>
+#include "controlador.h"
+
+static const float DT = 0.5f;
+static const unsigned long PERIODO_MS = 500;
+
+static unsigned long agora;
+
+// Leituras iguais em sequência, para o filtro não pesar no resultado
+static int ler(Controlador &controlador, float temperatura, int vezes = 1) {
+    int pwm = 0;
+    for (int i = 0; i < vezes; i++) {
+        agora += PERIODO_MS;
+        pwm = controlador.processar_leitura(temperatura, agora);
+    }
+    return pwm;
+}
+
+static void comandar(Controlador &controlador, TipoComando tipo, float v0 = 0, float v1 = 0, float v2 = 0) {
+    Comando comando = {tipo, {v0, v1, v2}, 0};
+    controlador.aplicar_comando(comando);
+}
+
+void setUp(void) {
+    Serial.silenciar(true);
+    agora = 0;
+}
+
+void tearDown(void) {}
+
+void test_desligado_nao_resfria(void) {
+    Controlador controlador(DT);
+    TEST_ASSERT_FALSE(controlador.recebeu_leitura());
+    TEST_ASSERT_EQUAL(0, ler(controlador, 30.0f, 3));
+    TEST_ASSERT_TRUE(controlador.recebeu_leitura());
+    TEST_ASSERT_EQUAL(ESTADO_DESLIGADO, controlador.estado());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, controlador.temperatura());
+}
+
+void test_resfriamento_inicial_em_potencia_maxima(void) {
+    Controlador controlador(DT);
+    ler(controlador, 25.0f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    TEST_ASSERT_TRUE(controlador.ligado());
+    TEST_ASSERT_EQUAL(PWM_MAXIMO, ler(controlador, 25.0f));
+    TEST_ASSERT_EQUAL(ESTADO_RESFRIAMENTO_INICIAL, controlador.estado());
+    TEST_ASSERT_EQUAL(RESOLUCAO_RAPIDA, controlador.resolucao_desejada());
+}
+
+void test_sai_do_resfriamento_perto_do_alvo(void) {
+    Controlador controlador(DT);
+    ler(controlador, 25.0f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    ler(controlador, 25.0f);
+    // A mediana e a média de 3 levam algumas leituras para largar os 25°C
+    ler(controlador, ALVO_INICIAL + LIMITE_INICIAL / 2, 8);
+    TEST_ASSERT_EQUAL(ESTADO_CONTROLE_PID, controlador.estado());
+    TEST_ASSERT_LESS_THAN(PWM_MAXIMO, controlador.pwm());
+}
+
+void test_banda_morta_pede_resolucao_fina(void) {
+    Controlador controlador(DT);
+    ler(controlador, ALVO_INICIAL + 0.1f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    ler(controlador, ALVO_INICIAL + 0.1f);
+    TEST_ASSERT_EQUAL(ESTADO_BANDA_MORTA, controlador.estado());
+    TEST_ASSERT_EQUAL(RESOLUCAO_FINA, controlador.resolucao_desejada());
+    // A banda morta mantém a saída do PID, não força zero
+    TEST_ASSERT_GREATER_THAN(0, controlador.pwm());
+}
+
+void test_resolucao_com_histerese_na_borda_da_banda_morta(void) {
+    // A temperatura oscilando em torno de ±BANDA_MORTA alterna o estado
+    // entre banda morta, PID e sem resfriamento, mas não a resolução
+    Controlador controlador(DT);
+    ler(controlador, ALVO_INICIAL + 0.1f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    ler(controlador, ALVO_INICIAL + 0.1f);
+    TEST_ASSERT_EQUAL(RESOLUCAO_FINA, controlador.resolucao_desejada());
+    const float oscilacao[] = {0.4f, 0.4f, 0.4f, -0.4f, -0.4f, -0.4f};
+    bool saiu_da_banda = false;
+    for (int i = 0; i < 48; i++) {
+        ler(controlador, ALVO_INICIAL + oscilacao[i % 6]);
+        saiu_da_banda = saiu_da_banda || controlador.estado() != ESTADO_BANDA_MORTA;
+        TEST_ASSERT_EQUAL(RESOLUCAO_FINA, controlador.resolucao_desejada());
+    }
+    TEST_ASSERT_TRUE(saiu_da_banda);
+
+    // Além da histerese volta à padrão, e só retorna à fina na banda morta
+    ler(controlador, ALVO_INICIAL + BANDA_MORTA + HISTERESE_RESOLUCAO + 0.2f, 4);
+    TEST_ASSERT_EQUAL(RESOLUCAO_PADRAO, controlador.resolucao_desejada());
+    ler(controlador, ALVO_INICIAL + BANDA_MORTA + HISTERESE_RESOLUCAO / 2, 4);
+    TEST_ASSERT_EQUAL(RESOLUCAO_PADRAO, controlador.resolucao_desejada());
+
+    // O mesmo na borda da resolução rápida
+    ler(controlador, ALVO_INICIAL + ERRO_RESOLUCAO_RAPIDA + 0.5f, 4);
+    TEST_ASSERT_EQUAL(RESOLUCAO_RAPIDA, controlador.resolucao_desejada());
+    ler(controlador, ALVO_INICIAL + ERRO_RESOLUCAO_RAPIDA - HISTERESE_RESOLUCAO / 2, 4);
+    TEST_ASSERT_EQUAL(RESOLUCAO_RAPIDA, controlador.resolucao_desejada());
+    ler(controlador, ALVO_INICIAL + ERRO_RESOLUCAO_RAPIDA - 2 * HISTERESE_RESOLUCAO, 4);
+    TEST_ASSERT_EQUAL(RESOLUCAO_PADRAO, controlador.resolucao_desejada());
+}
+
+void test_abaixo_do_alvo_desliga_a_saida(void) {
+    Controlador controlador(DT);
+    ler(controlador, ALVO_INICIAL - 1, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    TEST_ASSERT_EQUAL(0, ler(controlador, ALVO_INICIAL - 1));
+    TEST_ASSERT_EQUAL(ESTADO_SEM_RESFRIAMENTO, controlador.estado());
+}
+
+void test_erro_do_sensor_zera_a_saida(void) {
+    Controlador controlador(DT);
+    ler(controlador, 25.0f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    TEST_ASSERT_EQUAL(PWM_MAXIMO, ler(controlador, 25.0f));
+    TEST_ASSERT_EQUAL(0, ler(controlador, -127.0f));
+    TEST_ASSERT_EQUAL(ESTADO_ERRO_SENSOR, controlador.estado());
+    TEST_ASSERT_EQUAL_FLOAT(0, controlador.saida());
+}
+
+void test_saturacao_prolongada_marca_limite(void) {
+    Controlador controlador(DT);
+    ler(controlador, ALVO_INICIAL + 1, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    comandar(controlador, CMD_DEFINIR_PID, 1000, 0, 0);
+    ler(controlador, ALVO_INICIAL + 1, 2);
+    TEST_ASSERT_EQUAL(ESTADO_CONTROLE_PID, controlador.estado());
+    ler(controlador, ALVO_INICIAL + 1, (TIMEOUT_LIMITE_MS + 1000) / PERIODO_MS);
+    TEST_ASSERT_EQUAL(ESTADO_LIMITE_ATINGIDO, controlador.estado());
+
+    SnapshotControlador snapshot{};
+    controlador.preencher_snapshot(snapshot);
+    TEST_ASSERT_TRUE(snapshot.limite_atingido);
+
+    comandar(controlador, CMD_RESETAR_LIMITE);
+    controlador.preencher_snapshot(snapshot);
+    TEST_ASSERT_FALSE(snapshot.limite_atingido);
+}
+
+void test_novo_alvo_acima_reinicia_resfriamento(void) {
+    Controlador controlador(DT);
+    ler(controlador, ALVO_INICIAL + 0.1f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    ler(controlador, ALVO_INICIAL + 0.1f);
+    comandar(controlador, CMD_DEFINIR_ALVO, ALVO_INICIAL - 5);
+    TEST_ASSERT_EQUAL_FLOAT(ALVO_INICIAL - 5, controlador.alvo());
+    TEST_ASSERT_EQUAL(PWM_MAXIMO, ler(controlador, ALVO_INICIAL + 0.1f));
+    TEST_ASSERT_EQUAL(ESTADO_RESFRIAMENTO_INICIAL, controlador.estado());
+}
+
+void test_desligar_zera_pwm(void) {
+    Controlador controlador(DT);
+    ler(controlador, 25.0f, 3);
+    comandar(controlador, CMD_ALTERNAR);
+    ler(controlador, 25.0f);
+    comandar(controlador, CMD_ALTERNAR);
+    TEST_ASSERT_FALSE(controlador.ligado());
+    TEST_ASSERT_EQUAL(0, controlador.pwm());
+    TEST_ASSERT_EQUAL(ESTADO_DESLIGADO, controlador.estado());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_desligado_nao_resfria);
+    RUN_TEST(test_resfriamento_inicial_em_potencia_maxima);
+    RUN_TEST(test_sai_do_resfriamento_perto_do_alvo);
+    RUN_TEST(test_banda_morta_pede_resolucao_fina);
+    RUN_TEST(test_resolucao_com_histerese_na_borda_da_banda_morta);
+    RUN_TEST(test_abaixo_do_alvo_desliga_a_saida);
+    RUN_TEST(test_erro_do_sensor_zera_a_saida);
+    RUN_TEST(test_saturacao_prolongada_marca_limite);
+    RUN_TEST(test_novo_alvo_acima_reinicia_resfriamento);
+    RUN_TEST(test_desligar_zera_pwm);
+    return UNITY_END();
+}
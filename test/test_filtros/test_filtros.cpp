@@ -0,0 +1,108 @@
+// Filtros da leitura (filtros.h): aquecimento pela primeira amostra, ganho
+// DC unitário e validação da configuração do pipeline
+#include <unity.h>
+#include "filtros.h"
+
+static const float DT = 0.5f;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_media_movel_comeca_na_primeira_amostra(void) {
+    MediaMovel<3> media;
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, media.filtrar(20.0f));
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, media.filtrar(22.0f));
+    TEST_ASSERT_EQUAL_FLOAT(22.0f, media.filtrar(24.0f));
+    // Janela cheia: a primeira amostra sai da soma
+    TEST_ASSERT_EQUAL_FLOAT(24.0f, media.filtrar(26.0f));
+}
+
+void test_mediana_descarta_pico_isolado(void) {
+    Mediana<3> mediana;
+    mediana.filtrar(4.0f);
+    mediana.filtrar(4.1f);
+    // 85°C: o DS18B20 perdeu a alimentação no meio da conversão
+    TEST_ASSERT_EQUAL_FLOAT(4.1f, mediana.filtrar(85.0f));
+    TEST_ASSERT_EQUAL_FLOAT(4.2f, mediana.filtrar(4.2f));
+}
+
+void test_exponencial_converge_para_degrau(void) {
+    MediaExponencial exponencial(1.0f, DT);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, exponencial.filtrar(10.0f));
+    float saida = 0;
+    for (int i = 0; i < 40; i++) {
+        saida = exponencial.filtrar(20.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, saida);
+}
+
+void test_biquad_mantem_entrada_constante(void) {
+    PassaBaixasBiquad biquad(0.2f, DT);
+    for (int i = 0; i < 20; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, 12.5f, biquad.filtrar(12.5f));
+    }
+}
+
+void test_biquad_limita_corte_abaixo_de_nyquist(void) {
+    // Corte acima de 1/(2 dt): sem o limite, tan() estoura e o filtro diverge
+    PassaBaixasBiquad biquad(50.0f, DT);
+    float saida = 0;
+    for (int i = 0; i < 50; i++) {
+        saida = biquad.filtrar(i % 2 ? 11.0f : 9.0f);
+    }
+    TEST_ASSERT_TRUE(isfinite(saida));
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 10.0f, saida);
+}
+
+void test_kalman_aproxima_leitura(void) {
+    KalmanEscalar kalman(0.01f, VARIANCIA_SENSOR_KALMAN, DT);
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, kalman.filtrar(5.0f));
+    float saida = 0;
+    for (int i = 0; i < 200; i++) {
+        saida = kalman.filtrar(6.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 6.0f, saida);
+}
+
+void test_pipeline_rejeita_configuracao_invalida(void) {
+    FiltroTemperatura filtro(FILTRO_MEDIA_MOVEL, true, 1.0f, DT);
+    TEST_ASSERT_FALSE(filtro.configurar(FILTRO_EXPONENCIAL, false, 0));
+    TEST_ASSERT_FALSE(filtro.configurar(FILTRO_EXPONENCIAL, false, NAN));
+    TEST_ASSERT_FALSE(filtro.configurar(NUM_TIPOS_FILTRO, false, 1.0f));
+    TEST_ASSERT_EQUAL(FILTRO_MEDIA_MOVEL, filtro.tipo());
+    TEST_ASSERT_TRUE(filtro.mediana());
+
+    TEST_ASSERT_TRUE(filtro.configurar(FILTRO_KALMAN, false, 0.02f));
+    TEST_ASSERT_EQUAL(FILTRO_KALMAN, filtro.tipo());
+    TEST_ASSERT_FALSE(filtro.mediana());
+    TEST_ASSERT_EQUAL_FLOAT(0.02f, filtro.parametro());
+}
+
+void test_pipeline_reinicia_ao_trocar_filtro(void) {
+    FiltroTemperatura filtro(FILTRO_MEDIA_MOVEL, false, 1.0f, DT);
+    filtro.filtrar(30.0f);
+    filtro.filtrar(30.0f);
+    filtro.configurar(FILTRO_EXPONENCIAL, false, 5.0f);
+    // Sem histórico: a primeira amostra depois da troca sai inteira
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, filtro.filtrar(4.0f));
+}
+
+void test_nomes_dos_filtros(void) {
+    TEST_ASSERT_EQUAL_STRING("media", nome_filtro(FILTRO_MEDIA_MOVEL));
+    TEST_ASSERT_EQUAL_STRING("kalman", nome_filtro(FILTRO_KALMAN));
+    TEST_ASSERT_EQUAL_STRING("?", nome_filtro(NUM_TIPOS_FILTRO));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_media_movel_comeca_na_primeira_amostra);
+    RUN_TEST(test_mediana_descarta_pico_isolado);
+    RUN_TEST(test_exponencial_converge_para_degrau);
+    RUN_TEST(test_biquad_mantem_entrada_constante);
+    RUN_TEST(test_biquad_limita_corte_abaixo_de_nyquist);
+    RUN_TEST(test_kalman_aproxima_leitura);
+    RUN_TEST(test_pipeline_rejeita_configuracao_invalida);
+    RUN_TEST(test_pipeline_reinicia_ao_trocar_filtro);
+    RUN_TEST(test_nomes_dos_filtros);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+// Formato do registro em flash (formato_registro.h): um segmento cortado em
+// qualquer ponto por falta de energia é recuperado até o último bloco íntegro
+#include <unity.h>
+#include <string.h>
+#include "formato_registro.h"
+
+static const uint16_t AMOSTRAS_POR_BLOCO = 60;     // Como em RegistroFlash
+static const uint32_t PRIMEIRO_INDICE = 1200;
+
+// Arquivo em memória com a mesma leitura de fs::File
+struct ArquivoMemoria {
+    const uint8_t *dados;
+    size_t tamanho;
+    size_t posicao;
+
+    size_t read(uint8_t *destino, size_t quantidade) {
+        if (quantidade > tamanho - posicao) {
+            quantidade = tamanho - posicao;
+        }
+        memcpy(destino, dados + posicao, quantidade);
+        posicao += quantidade;
+        return quantidade;
+    }
+};
+
+static uint8_t segmento[sizeof(CabecalhoSegmento) + 3 * (sizeof(CabecalhoBloco) + AMOSTRAS_POR_BLOCO * 4)];
+static size_t fim_do_bloco[3];      // Tamanho do arquivo logo depois de cada bloco
+static AmostraBruta lote[AMOSTRAS_POR_BLOCO];
+
+// Segmento como RegistroFlash grava: cabeçalho e três blocos cheios
+static void montar_segmento() {
+    CabecalhoSegmento cabecalho;
+    cabecalho.periodo_ms = 500;
+    cabecalho.boot = 3;
+    cabecalho.tempo_inicial_ms = 1234;
+    selar_segmento(cabecalho);
+    memcpy(segmento, &cabecalho, sizeof(cabecalho));
+    size_t tamanho = sizeof(cabecalho);
+
+    for (uint32_t b = 0; b < 3; b++) {
+        AmostraBruta amostras[AMOSTRAS_POR_BLOCO];
+        for (uint16_t i = 0; i < AMOSTRAS_POR_BLOCO; i++) {
+            amostras[i].temperatura = 400 + b * 100 + i;
+            amostras[i].pwm = i;
+            amostras[i].estado = 2;
+        }
+        CabecalhoBloco bloco;
+        bloco.quantidade = AMOSTRAS_POR_BLOCO;
+        bloco.indice_inicial = PRIMEIRO_INDICE + b * AMOSTRAS_POR_BLOCO;
+        selar_bloco(bloco, amostras);
+        memcpy(segmento + tamanho, &bloco, sizeof(bloco));
+        tamanho += sizeof(bloco);
+        memcpy(segmento + tamanho, amostras, sizeof(amostras));
+        tamanho += sizeof(amostras);
+        fim_do_bloco[b] = tamanho;
+    }
+}
+
+static bool varrer(const uint8_t *dados, size_t tamanho, ContagemSegmento &contagem) {
+    ArquivoMemoria arquivo = {dados, tamanho, 0};
+    CabecalhoSegmento cabecalho;
+    return varrer_segmento(arquivo, cabecalho, lote, AMOSTRAS_POR_BLOCO, contagem);
+}
+
+void setUp(void) {
+    montar_segmento();
+}
+
+void tearDown(void) {}
+
+void test_segmento_inteiro(void) {
+    ContagemSegmento contagem;
+    TEST_ASSERT_TRUE(varrer(segmento, sizeof(segmento), contagem));
+    TEST_ASSERT_EQUAL(PRIMEIRO_INDICE, contagem.indice_inicial);
+    TEST_ASSERT_EQUAL(3 * AMOSTRAS_POR_BLOCO, contagem.amostras);
+}
+
+void test_corte_em_qualquer_byte(void) {
+    // Reproduz a queda de energia em cada byte da gravação: só contam os
+    // blocos que chegaram inteiros à flash
+    for (size_t corte = 0; corte <= sizeof(segmento); corte++) {
+        ContagemSegmento contagem;
+        bool valido = varrer(segmento, corte, contagem);
+        if (corte < sizeof(CabecalhoSegmento)) {
+            TEST_ASSERT_FALSE(valido);
+            continue;
+        }
+        uint32_t blocos = 0;
+        while (blocos < 3 && fim_do_bloco[blocos] <= corte) {
+            blocos++;
+        }
+        TEST_ASSERT_TRUE(valido);
+        TEST_ASSERT_EQUAL(blocos * AMOSTRAS_POR_BLOCO, contagem.amostras);
+        TEST_ASSERT_EQUAL(blocos ? PRIMEIRO_INDICE : 0, contagem.indice_inicial);
+    }
+}
+
+void test_bloco_corrompido_encerra_a_leitura(void) {
+    // A flash apagada é 0xFF; um bloco meio programado mistura os dois
+    uint8_t copia[sizeof(segmento)];
+    for (size_t b = 0; b < 3; b++) {
+        size_t inicio = b ? fim_do_bloco[b - 1] : sizeof(CabecalhoSegmento);
+        for (size_t byte = inicio; byte < fim_do_bloco[b]; byte += 7) {
+            memcpy(copia, segmento, sizeof(segmento));
+            copia[byte] ^= 0x10;
+            ContagemSegmento contagem;
+            TEST_ASSERT_TRUE(varrer(copia, sizeof(copia), contagem));
+            TEST_ASSERT_EQUAL(b * AMOSTRAS_POR_BLOCO, contagem.amostras);
+        }
+        memcpy(copia, segmento, sizeof(segmento));
+        memset(copia + inicio + sizeof(CabecalhoBloco) + 10, 0xFF, fim_do_bloco[b] - inicio - sizeof(CabecalhoBloco) - 10);
+        ContagemSegmento contagem;
+        TEST_ASSERT_TRUE(varrer(copia, sizeof(copia), contagem));
+        TEST_ASSERT_EQUAL(b * AMOSTRAS_POR_BLOCO, contagem.amostras);
+    }
+}
+
+void test_cabecalho_do_segmento_corrompido(void) {
+    uint8_t copia[sizeof(segmento)];
+    memcpy(copia, segmento, sizeof(segmento));
+    copia[offsetof(CabecalhoSegmento, boot)] ^= 1;
+    ContagemSegmento contagem;
+    TEST_ASSERT_FALSE(varrer(copia, sizeof(copia), contagem));
+}
+
+void test_crc32_conhecido(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, calcular_crc32("123456789", 9));
+    // Encadeado dá o mesmo que de uma vez
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, calcular_crc32("6789", 4, calcular_crc32("12345", 5)));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_segmento_inteiro);
+    RUN_TEST(test_corte_em_qualquer_byte);
+    RUN_TEST(test_bloco_corrompido_encerra_a_leitura);
+    RUN_TEST(test_cabecalho_do_segmento_corrompido);
+    RUN_TEST(test_crc32_conhecido);
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+// Histórico em RAM (historico.h): anel de três resoluções e a leitura em CSV
+// em blocos, como a resposta de GET /historico
+#include <unity.h>
+#include <string.h>
+#include "historico.h"
+
+static const uint32_t PERIODO_MS = 500;
+static Historico *historico;
+
+// Lê o CSV inteiro em blocos de `bloco` bytes; devolve o comprimento
+static size_t ler_tudo(CursorHistorico &cursor, char *destino, size_t capacidade, size_t bloco) {
+    size_t total = 0;
+    int blocos_vazios = 0;
+    while (!cursor.terminou() && blocos_vazios < 3) {
+        size_t n = cursor.ler_csv(destino + total, capacidade - total < bloco ? capacidade - total : bloco);
+        blocos_vazios = n == 0 ? blocos_vazios + 1 : 0;
+        total += n;
+    }
+    destino[total] = '\0';
+    return total;
+}
+
+void setUp(void) {
+    historico = new Historico(PERIODO_MS);
+}
+
+void tearDown(void) {
+    delete historico;
+}
+
+void test_csv_bruto(void) {
+    historico->registrar(1000, 4.25f, 128, 2);
+    historico->registrar(1500, -1.5f, 255, 1);
+    CursorHistorico cursor;
+    cursor.iniciar(*historico, NIVEL_BRUTO, 0, 10000);
+    char csv[256];
+    ler_tudo(cursor, csv, sizeof(csv) - 1, sizeof(csv) - 1);
+    TEST_ASSERT_EQUAL_STRING("t_ms,temperatura,pwm,estado\n1000,4.25,128,2\n1500,-1.50,255,1\n", csv);
+}
+
+void test_sensor_ausente_vira_campo_vazio(void) {
+    historico->registrar(1000, -127.0f, 0, 5);
+    CursorHistorico cursor;
+    cursor.iniciar(*historico, NIVEL_BRUTO, 0, 10000);
+    char csv[128];
+    ler_tudo(cursor, csv, sizeof(csv) - 1, sizeof(csv) - 1);
+    TEST_ASSERT_EQUAL_STRING("t_ms,temperatura,pwm,estado\n1000,,0,5\n", csv);
+}
+
+void test_bloco_menor_que_a_linha_nao_encerra(void) {
+    // Um bloco que não cabe o cabeçalho nem a próxima linha escreve 0 bytes,
+    // mas o cursor ainda não terminou: a resposta tem de tentar de novo
+    historico->registrar(1000, 4.25f, 128, 2);
+    CursorHistorico cursor;
+    cursor.iniciar(*historico, NIVEL_BRUTO, 0, 10000);
+    char pequeno[8];
+    TEST_ASSERT_EQUAL(0, cursor.ler_csv(pequeno, sizeof(pequeno)));
+    TEST_ASSERT_FALSE(cursor.terminou());
+
+    char csv[128];
+    size_t n = cursor.ler_csv(csv, 28);     // Só o cabeçalho
+    TEST_ASSERT_EQUAL(28, n);
+    TEST_ASSERT_EQUAL(0, cursor.ler_csv(csv + n, 8));
+    TEST_ASSERT_FALSE(cursor.terminou());
+    n += cursor.ler_csv(csv + n, sizeof(csv) - 1 - n);
+    csv[n] = '\0';
+    TEST_ASSERT_TRUE(cursor.terminou());
+    TEST_ASSERT_EQUAL_STRING("t_ms,temperatura,pwm,estado\n1000,4.25,128,2\n", csv);
+}
+
+void test_blocos_pequenos_reproduzem_o_csv_inteiro(void) {
+    for (uint32_t i = 0; i < 40; i++) {
+        historico->registrar(1000 + i * PERIODO_MS, 3.0f + i * 0.01f, i, 2);
+    }
+    char inteiro[2048];
+    char em_blocos[2048];
+    CursorHistorico cursor;
+    cursor.iniciar(*historico, NIVEL_BRUTO, 0, 100000);
+    size_t n = ler_tudo(cursor, inteiro, sizeof(inteiro) - 1, sizeof(inteiro) - 1);
+    cursor.iniciar(*historico, NIVEL_BRUTO, 0, 100000);
+    TEST_ASSERT_EQUAL(n, ler_tudo(cursor, em_blocos, sizeof(em_blocos) - 1, 30));
+    TEST_ASSERT_EQUAL_STRING(inteiro, em_blocos);
+}
+
+void test_agregado_de_10s(void) {
+    const uint32_t por_10s = Historico::PERIODO_10S_MS / PERIODO_MS;
+    for (uint32_t i = 0; i < por_10s; i++) {
+        historico->registrar(i * PERIODO_MS, i % 2 ? 5.0f : 3.0f, 100, 2);
+    }
+    TEST_ASSERT_EQUAL(1, historico->nivel_10s().total());
+    AmostraAgregada agregada;
+    TEST_ASSERT_TRUE(historico->nivel_10s().ler(0, agregada));
+    TEST_ASSERT_EQUAL(300, agregada.minimo);
+    TEST_ASSERT_EQUAL(500, agregada.maximo);
+    TEST_ASSERT_EQUAL(400, agregada.media);
+    TEST_ASSERT_EQUAL(100, agregada.pwm_medio);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_csv_bruto);
+    RUN_TEST(test_sensor_ausente_vira_campo_vazio);
+    RUN_TEST(test_bloco_menor_que_a_linha_nao_encerra);
+    RUN_TEST(test_blocos_pequenos_reproduzem_o_csv_inteiro);
+    RUN_TEST(test_agregado_de_10s);
+    return UNITY_END();
+}
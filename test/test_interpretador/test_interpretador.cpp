@@ -0,0 +1,171 @@
+// Comandos vindos da rede (interpretador.h): corpos JSON dos POST e quadros
+// binários do WebSocket
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "controlador.h"
+#include "filtros.h"
+#include "interpretador.h"
+#include "protocolo_ws.h"
+
+static bool json(TipoComando tipo, const char *corpo, Comando &comando) {
+    return interpretar_comando_json(tipo, (const uint8_t *)corpo, strlen(corpo), comando);
+}
+
+// Quadro de comando: tipo, valores em float e o canal opcional
+static size_t montar_quadro(uint8_t *quadro, uint8_t tipo, const float *valores, size_t num_valores, int canal = -1) {
+    quadro[0] = tipo;
+    memcpy(quadro + 1, valores, num_valores * sizeof(float));
+    size_t tamanho = 1 + num_valores * sizeof(float);
+    if (canal >= 0) {
+        quadro[tamanho++] = canal;
+    }
+    return tamanho;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_json_definir_alvo(void) {
+    Comando comando;
+    TEST_ASSERT_TRUE(json(CMD_DEFINIR_ALVO, "{\"alvo\":3.5}", comando));
+    TEST_ASSERT_EQUAL(CMD_DEFINIR_ALVO, comando.tipo);
+    TEST_ASSERT_EQUAL_FLOAT(3.5f, comando.valores[0]);
+    TEST_ASSERT_EQUAL(0, comando.canal);
+}
+
+void test_json_rejeita_corpo_invalido(void) {
+    Comando comando;
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"alvo\":", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"temperatura\":3}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"alvo\":\"frio\"}", comando));
+}
+
+void test_json_corpo_sem_terminador(void) {
+    // O corpo chega do servidor sem '\0': só os `tamanho` primeiros bytes valem
+    const char corpo[] = "{\"alvo\":7}lixo";
+    Comando comando;
+    TEST_ASSERT_TRUE(interpretar_comando_json(CMD_DEFINIR_ALVO, (const uint8_t *)corpo, 10, comando));
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, comando.valores[0]);
+}
+
+void test_json_definir_pid(void) {
+    Comando comando;
+    TEST_ASSERT_TRUE(json(CMD_DEFINIR_PID, "{\"kp\":30,\"ki\":0.1,\"kd\":10}", comando));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, comando.valores[0]);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, comando.valores[1]);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, comando.valores[2]);
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_PID, "{\"kp\":30,\"ki\":0.1}", comando));
+}
+
+void test_json_alvo_e_ganhos_fora_da_faixa(void) {
+    Comando comando;
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"alvo\":1e39}", comando));   // Vira infinito em float
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"alvo\":-60}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ALVO, "{\"alvo\":100}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_PID, "{\"kp\":-1,\"ki\":0.1,\"kd\":10}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_PID, "{\"kp\":30,\"ki\":1e39,\"kd\":10}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ANTECIPACAO, "{\"ganho\":1e39,\"base\":0}", comando));
+    TEST_ASSERT_TRUE(json(CMD_DEFINIR_PID, "{\"kp\":0,\"ki\":0,\"kd\":0}", comando));
+}
+
+void test_json_estrutura_pid_fora_da_faixa(void) {
+    Comando comando;
+    TEST_ASSERT_TRUE(json(CMD_DEFINIR_ESTRUTURA_PID, "{\"b\":0.5,\"c\":0,\"n\":8}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ESTRUTURA_PID, "{\"b\":1.5,\"c\":0,\"n\":8}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_ESTRUTURA_PID, "{\"b\":0.5,\"c\":0,\"n\":-1}", comando));
+}
+
+void test_json_filtro_por_nome(void) {
+    Comando comando;
+    TEST_ASSERT_TRUE(json(CMD_DEFINIR_FILTRO, "{\"filtro\":\"kalman\",\"mediana\":true}", comando));
+    TEST_ASSERT_EQUAL_FLOAT(FILTRO_KALMAN, comando.valores[0]);
+    TEST_ASSERT_EQUAL_FLOAT(1, comando.valores[1]);
+    TEST_ASSERT_EQUAL_FLOAT(parametro_padrao_filtro(FILTRO_KALMAN), comando.valores[2]);
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_FILTRO, "{\"filtro\":\"fir\"}", comando));
+    TEST_ASSERT_FALSE(json(CMD_DEFINIR_FILTRO, "{\"filtro\":\"biquad\",\"parametro\":0}", comando));
+}
+
+void test_json_autoajuste_padrao(void) {
+    Comando comando;
+    TEST_ASSERT_TRUE(json(CMD_AUTOAJUSTAR, "{}", comando));
+    TEST_ASSERT_EQUAL_FLOAT(REGRA_ZIEGLER_NICHOLS, comando.valores[0]);
+    TEST_ASSERT_TRUE(json(CMD_AUTOAJUSTAR, "{\"regra\":\"tl\",\"histerese\":0.3}", comando));
+    TEST_ASSERT_EQUAL_FLOAT(REGRA_TYREUS_LUYBEN, comando.valores[0]);
+    TEST_ASSERT_FALSE(json(CMD_AUTOAJUSTAR, "{\"regra\":\"cc\"}", comando));
+    TEST_ASSERT_FALSE(json(CMD_AUTOAJUSTAR, "{\"histerese\":-1}", comando));
+}
+
+void test_quadro_definir_alvo_com_canal(void) {
+    uint8_t quadro[16];
+    float alvo = 6.25f;
+    Comando comando;
+    TEST_ASSERT_TRUE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_ALVO, &alvo, 1), comando));
+    TEST_ASSERT_EQUAL(CMD_DEFINIR_ALVO, comando.tipo);
+    TEST_ASSERT_EQUAL_FLOAT(alvo, comando.valores[0]);
+    TEST_ASSERT_EQUAL(0, comando.canal);
+
+    TEST_ASSERT_TRUE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_ALVO, &alvo, 1, 2), comando));
+    TEST_ASSERT_EQUAL(2, comando.canal);
+}
+
+void test_quadro_definir_pid(void) {
+    uint8_t quadro[16];
+    const float ganhos[3] = {30, 0.1f, 10};
+    Comando comando;
+    TEST_ASSERT_TRUE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_PID, ganhos, 3), comando));
+    TEST_ASSERT_EQUAL(CMD_DEFINIR_PID, comando.tipo);
+    TEST_ASSERT_EQUAL_MEMORY(ganhos, comando.valores, sizeof(ganhos));
+}
+
+void test_quadro_tamanho_ou_tipo_errado(void) {
+    uint8_t quadro[16];
+    const float ganhos[3] = {30, 0.1f, 10};
+    Comando comando;
+    size_t tamanho = montar_quadro(quadro, QUADRO_DEFINIR_PID, ganhos, 3);
+    TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, tamanho - 1, comando));
+    TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, tamanho + 2, comando));
+    quadro[0] = QUADRO_TELEMETRIA;
+    TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, tamanho, comando));
+}
+
+void test_quadro_rejeita_nao_finito_e_fora_da_faixa(void) {
+    uint8_t quadro[16];
+    Comando comando;
+    const float alvos[] = {NAN, INFINITY, -INFINITY, ALVO_MINIMO - 1, ALVO_MAXIMO + 1};
+    for (size_t i = 0; i < sizeof(alvos) / sizeof(alvos[0]); i++) {
+        TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_ALVO, &alvos[i], 1),
+                                                     comando));
+    }
+    const float ganhos_nan[3] = {30, NAN, 10};
+    const float ganhos_negativos[3] = {30, 0.1f, -10};
+    TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_PID, ganhos_nan, 3),
+                                                 comando));
+    TEST_ASSERT_FALSE(interpretar_quadro_comando(quadro, montar_quadro(quadro, QUADRO_DEFINIR_PID, ganhos_negativos, 3),
+                                                 comando));
+}
+
+void test_quadro_sem_valores(void) {
+    const uint8_t alternar[] = {QUADRO_ALTERNAR};
+    Comando comando;
+    TEST_ASSERT_TRUE(interpretar_quadro_comando(alternar, sizeof(alternar), comando));
+    TEST_ASSERT_EQUAL(CMD_ALTERNAR, comando.tipo);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_json_definir_alvo);
+    RUN_TEST(test_json_rejeita_corpo_invalido);
+    RUN_TEST(test_json_corpo_sem_terminador);
+    RUN_TEST(test_json_definir_pid);
+    RUN_TEST(test_json_alvo_e_ganhos_fora_da_faixa);
+    RUN_TEST(test_json_estrutura_pid_fora_da_faixa);
+    RUN_TEST(test_json_filtro_por_nome);
+    RUN_TEST(test_json_autoajuste_padrao);
+    RUN_TEST(test_quadro_definir_alvo_com_canal);
+    RUN_TEST(test_quadro_definir_pid);
+    RUN_TEST(test_quadro_tamanho_ou_tipo_errado);
+    RUN_TEST(test_quadro_rejeita_nao_finito_e_fora_da_faixa);
+    RUN_TEST(test_quadro_sem_valores);
+    return UNITY_END();
+}
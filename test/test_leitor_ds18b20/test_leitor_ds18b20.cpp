@@ -0,0 +1,199 @@
+// Leitura não bloqueante do DS18B20 (leitor_ds18b20.h) contra o sensor
+// simulado com a latência do barramento: a tarefa de controle, acordando em
+// ticks fixos como em main.cpp, não pode atrasar mais que 1 ms
+#include <unity.h>
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include "leitor_ds18b20.h"
+
+static const uint32_t TICK_MS = 125;            // TICK_CONTROLE_MS de main.cpp
+static const uint32_t MARGEM_CONVERSAO_MS = 25;
+static const uint32_t JITTER_MAXIMO_US = 1000;
+static const uint32_t TICKS_TESTE = 2000;       // Pouco mais de 4 minutos
+
+static const ConfiguracaoCanal CANAIS[MAXIMO_CANAIS] = {{0, {0}}, {1, {0}}, {2, {0}}, {3, {0}}};
+
+struct ResultadoLaco {
+    uint32_t atraso_maximo_us;  // Maior atraso de um despertar sobre o nominal
+    uint32_t amostras;
+    uint32_t leituras;
+};
+
+// tarefa_controle de main.cpp: acorda em múltiplos exatos do tick
+// (vTaskDelayUntil, que acorda na hora se o tick anterior passou do prazo)
+// e amostra quando a conversão em andamento já deve ter terminado.
+// `amostrar` devolve se houve leitura e em quantos ticks vem a próxima.
+template <typename Amostra>
+static ResultadoLaco rodar_tarefa(uint32_t ticks, Amostra amostrar) {
+    ResultadoLaco resultado = {0, 0, 0};
+    unsigned long despertar_us = micros();
+    uint32_t proxima_amostra = 0;
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        despertar_us += TICK_MS * 1000;
+        if (micros() < despertar_us) {
+            avancar_micros_nativo(despertar_us - micros());
+        }
+        uint32_t atraso_us = micros() - despertar_us;
+        if (atraso_us > resultado.atraso_maximo_us) {
+            resultado.atraso_maximo_us = atraso_us;
+        }
+
+        if ((int32_t)(tick - proxima_amostra) >= 0) {
+            uint32_t ticks_ate_proxima = 1;
+            resultado.leituras += amostrar(millis(), ticks_ate_proxima) ? 1 : 0;
+            resultado.amostras++;
+            proxima_amostra = tick + ticks_ate_proxima;
+        }
+    }
+    return resultado;
+}
+
+static uint32_t ticks_da_conversao(const LeitorDS18B20 &leitor) {
+    return (leitor.tempo_conversao_ms() + MARGEM_CONVERSAO_MS + TICK_MS - 1) / TICK_MS;
+}
+
+void setUp(void) {
+    Serial.silenciar(true);
+    definir_millis_nativo(0);
+}
+
+void tearDown(void) {}
+
+static void testar_sem_bloqueio(uint8_t resolucao, uint8_t num_sensores) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    sensores.simular_latencia(true);
+    sensores.definir_quantidade(num_sensores);
+    for (uint8_t i = 0; i < num_sensores; i++) {
+        sensores.definir_temperatura(4.5f + i, i);
+    }
+    LeitorDS18B20 leitor(barramento, sensores);
+    leitor.iniciar(resolucao, CANAIS, num_sensores);
+
+    float temperaturas[MAXIMO_CANAIS];
+    ResultadoLaco resultado = rodar_tarefa(TICKS_TESTE, [&](unsigned long agora, uint32_t &ticks) {
+        bool leu = leitor.amostrar(agora, temperaturas);
+        ticks = ticks_da_conversao(leitor);
+        return leu;
+    });
+
+    TEST_ASSERT_LESS_THAN_UINT32(JITTER_MAXIMO_US, resultado.atraso_maximo_us);
+    // Toda amostra depois da primeira (que só dispara a conversão) traz leitura
+    TEST_ASSERT_EQUAL_UINT32(resultado.amostras - 1, resultado.leituras);
+    for (uint8_t i = 0; i < num_sensores; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.5f, 4.5f + i, temperaturas[i]);
+    }
+    // Nenhuma amostra ocupa o barramento por um tick inteiro
+    TEST_ASSERT_LESS_THAN_UINT32(TICK_MS * 1000, leitor.tempo_barramento_max_us());
+}
+
+void test_doze_bits_sem_atraso_no_tick(void) {
+    testar_sem_bloqueio(12, 1);
+}
+
+void test_nove_bits_quatro_sensores_sem_atraso_no_tick(void) {
+    // Amostra a cada tick, lendo os quatro sensores pelo endereço
+    testar_sem_bloqueio(9, 4);
+}
+
+void test_conversao_ainda_em_andamento_nao_bloqueia(void) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    sensores.simular_latencia(true);
+    LeitorDS18B20 leitor(barramento, sensores);
+    leitor.iniciar(12, CANAIS, 1);
+
+    float temperatura;
+    TEST_ASSERT_FALSE(leitor.amostrar(millis(), &temperatura));
+    // 100 ms depois a conversão de 750 ms não terminou: só um bit é lido
+    avancar_micros_nativo(100000);
+    unsigned long inicio_us = micros();
+    TEST_ASSERT_FALSE(leitor.amostrar(millis(), &temperatura));
+    TEST_ASSERT_LESS_THAN_UINT32(JITTER_MAXIMO_US, micros() - inicio_us);
+}
+
+void test_troca_de_resolucao_so_no_scratchpad(void) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    sensores.simular_latencia(true);
+    sensores.definir_quantidade(3);
+    LeitorDS18B20 leitor(barramento, sensores);
+
+    // Os sensores saem de fábrica com 12 bits: nada a gravar
+    leitor.iniciar(12, CANAIS, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, barramento.gravacoes_scratchpad());
+
+    float temperaturas[MAXIMO_CANAIS];
+    leitor.amostrar(millis(), temperaturas);
+    leitor.definir_resolucao(9);
+    avancar_micros_nativo(800000);
+    unsigned long inicio_us = micros();
+    leitor.amostrar(millis(), temperaturas);
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(9, barramento.resolucao(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, barramento.gravacoes_scratchpad());
+    TEST_ASSERT_EQUAL_UINT32(0, barramento.copias_eeprom());
+    // Três leituras, três gravações e o disparo cabem folgados no tick
+    TEST_ASSERT_LESS_THAN_UINT32(TICK_MS * 1000 / 2, micros() - inicio_us);
+    TEST_ASSERT_EQUAL(94, leitor.tempo_conversao_ms());
+
+    // Pedir a mesma resolução não toca no barramento
+    leitor.definir_resolucao(9);
+    avancar_micros_nativo(100000);
+    leitor.amostrar(millis(), temperaturas);
+    TEST_ASSERT_EQUAL_UINT32(3, leitor.gravacoes_resolucao());
+
+    // TH e TL continuam os de antes
+    TEST_ASSERT_EQUAL(75, barramento.alarme_alto(0));
+    TEST_ASSERT_EQUAL(70, barramento.alarme_baixo(0));
+}
+
+void test_sensor_novo_recebe_a_resolucao_na_busca(void) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    sensores.definir_quantidade(1);
+    LeitorDS18B20 leitor(barramento, sensores);
+    leitor.iniciar(11, CANAIS, 2);
+    TEST_ASSERT_EQUAL_UINT32(1, barramento.gravacoes_scratchpad());
+
+    // O segundo sensor aparece; a busca só grava o que ainda está em 12 bits
+    sensores.definir_quantidade(2);
+    float temperaturas[MAXIMO_CANAIS];
+    leitor.amostrar(millis(), temperaturas);
+    avancar_micros_nativo((LeitorDS18B20::INTERVALO_BUSCA_MS + 1000) * 1000);
+    leitor.amostrar(millis(), temperaturas);
+    TEST_ASSERT_EQUAL(2, leitor.sensores_encontrados());
+    TEST_ASSERT_EQUAL(11, barramento.resolucao(1));
+    TEST_ASSERT_EQUAL_UINT32(2, barramento.gravacoes_scratchpad());
+    TEST_ASSERT_EQUAL_UINT32(0, barramento.copias_eeprom());
+}
+
+// Referência: a leitura antiga, com requestTemperatures() esperando a
+// conversão, passa do tick. Garante que o laço acima mede o bloqueio.
+void test_leitura_bloqueante_estoura_o_tick(void) {
+    OneWire barramento(0);
+    DallasTemperature sensores(&barramento);
+    sensores.simular_latencia(true);
+    sensores.begin();
+    sensores.setResolution(12);
+
+    ResultadoLaco resultado = rodar_tarefa(40, [&](unsigned long agora, uint32_t &ticks) {
+        sensores.requestTemperatures();
+        ticks = 4;  // TEMPO_AMOSTRA_SEG = 0.5 de antes
+        return sensores.getTempCByIndex(0) != DEVICE_DISCONNECTED_C;
+    });
+
+    TEST_ASSERT_GREATER_THAN(JITTER_MAXIMO_US, resultado.atraso_maximo_us);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_doze_bits_sem_atraso_no_tick);
+    RUN_TEST(test_nove_bits_quatro_sensores_sem_atraso_no_tick);
+    RUN_TEST(test_conversao_ainda_em_andamento_nao_bloqueia);
+    RUN_TEST(test_troca_de_resolucao_so_no_scratchpad);
+    RUN_TEST(test_sensor_novo_recebe_a_resolucao_na_busca);
+    RUN_TEST(test_leitura_bloqueante_estoura_o_tick);
+    return UNITY_END();
+}
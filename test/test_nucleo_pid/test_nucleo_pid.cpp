@@ -0,0 +1,178 @@
+// Núcleo do PID (nucleo_pid.h) em ponto fixo contra a referência em float,
+// como a ferramenta comparar_pid, a saturação do Q16.16 (ponto_fixo.h) e a
+// estrutura de dois graus de liberdade: pesos b e c e o filtro n da derivada
+#include <unity.h>
+#include <math.h>
+#include "controlador.h"
+#include "nucleo_pid.h"
+#include "ponto_fixo.h"
+
+static const float DT = 0.5f;
+
+// O mesmo limite de comparar_pid: 0.01 PWM, ou 2 LSB do Q16.16 por unidade de ganho
+static float erro_permitido_passo(float kp, float ki, float kd) {
+    return fmaxf(0.01f, (kp + ki * DT + kd / DT) * 2.0f / Q16::UM);
+}
+
+// Mesma sequência em toda execução: passeio entre -10 e 30 °C do alvo
+static float proximo_erro(uint32_t &estado, float erro) {
+    estado = estado * 1103515245u + 12345u;
+    float aleatorio = (float)((estado >> 8) & 0xFFFF) / 0xFFFF - 0.5f;
+    erro = (estado >> 24) == 0 ? aleatorio * 40 + 10 : erro + aleatorio * 0.25f;
+    return constrain(erro, -10.0f, 30.0f);
+}
+
+// Maior diferença de um passo, partindo do mesmo estado nas duas versões
+static float maior_erro_de_um_passo(float kp, float ki, float kd) {
+    uint32_t estado = 12345;
+    float anterior = 10, erro = 10;
+    float maior = 0;
+    for (int i = 0; i < 2000; i++) {
+        anterior = erro;
+        erro = proximo_erro(estado, erro);
+        NucleoPID<float> referencia(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+        NucleoPID<Q16> fixo(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+        referencia.definir_ganhos(kp, ki, kd);
+        fixo.definir_ganhos(kp, ki, kd);
+        referencia.calcular(anterior, 0);
+        fixo.calcular(Q16::de_float(anterior), Q16::de_float(0));
+        referencia.zerar_integral();
+        fixo.zerar_integral();
+
+        float saida_float = referencia.calcular(erro, 0);
+        float saida_fixo = fixo.calcular(Q16::de_float(erro), Q16::de_float(0)).para_float();
+        maior = fmaxf(maior, fabsf(saida_float - saida_fixo));
+    }
+    return maior;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_conversao_satura(void) {
+    TEST_ASSERT_EQUAL(INT32_MAX, Q16::de_float(40000.0f).bruto);
+    TEST_ASSERT_EQUAL(INT32_MIN, Q16::de_float(-40000.0f).bruto);
+    TEST_ASSERT_EQUAL(INT32_MAX, Q16::de_float(INFINITY).bruto);
+    TEST_ASSERT_EQUAL(0, Q16::de_float(NAN).bruto);
+    TEST_ASSERT_EQUAL(-(3 << 15), Q16::de_float(-1.5f).bruto);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / Q16::UM, 32767.99f, Q16::de_float(32767.99f).para_float());
+}
+
+void test_operacoes_saturam(void) {
+    const Q16 grande = Q16::de_float(30000);
+    TEST_ASSERT_EQUAL(INT32_MAX, (grande * Q16::de_float(2)).bruto);
+    TEST_ASSERT_EQUAL(INT32_MIN, (grande * Q16::de_float(-2)).bruto);
+    TEST_ASSERT_EQUAL(INT32_MAX, (grande + grande).bruto);
+    TEST_ASSERT_EQUAL(INT32_MIN, (-grande - grande).bruto);
+    TEST_ASSERT_EQUAL(INT32_MAX, (-Q16::de_bruto(INT32_MIN)).bruto);
+    Q16 acumulado = grande;
+    acumulado += grande;
+    TEST_ASSERT_EQUAL(INT32_MAX, acumulado.bruto);
+    // O mínimo saturado ainda converte para inteiro
+    TEST_ASSERT_EQUAL(-32768, Q16::de_bruto(INT32_MIN).para_int());
+    TEST_ASSERT_EQUAL(-2, Q16::de_float(-2.75f).para_int());
+    // Dentro da faixa nada muda
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -7.5f, (Q16::de_float(2.5f) * Q16::de_float(-3)).para_float());
+}
+
+void test_erro_de_um_passo_dentro_do_limite(void) {
+    TEST_ASSERT_LESS_THAN_FLOAT(erro_permitido_passo(KP_INICIAL, KI_INICIAL, KD_INICIAL),
+                                maior_erro_de_um_passo(KP_INICIAL, KI_INICIAL, KD_INICIAL));
+}
+
+void test_ganho_grande_nao_inverte_a_saida(void) {
+    // kp * erro e o termo D passam de 32768 (o maior Q16.16): sem saturação o
+    // produto dava a volta, a saída trocava de sinal e ia a zero em vez do máximo
+    TEST_ASSERT_LESS_THAN_FLOAT(erro_permitido_passo(2000, 20, 500), maior_erro_de_um_passo(2000, 20, 500));
+
+    NucleoPID<Q16> fixo(DT, PWM_MAXIMO, INTEGRAL_MAXIMO);
+    fixo.definir_ganhos(2000, 20, 500);
+    for (float erro = 1; erro <= 30; erro += 1) {
+        TEST_ASSERT_EQUAL(PWM_MAXIMO, fixo.calcular(Q16::de_float(erro), Q16::de_float(0)).para_int());
+    }
+    // Erro negativo grande: a saída vai ao mínimo
+    TEST_ASSERT_EQUAL(0, fixo.calcular(Q16::de_float(-30), Q16::de_float(0)).para_int());
+}
+
+// Medida parada em 8°C e o alvo sobe de 4 para 4.5: só o termo D de c = 1
+// enxerga o degrau
+template <typename N>
+static void degrau_de_alvo(float c, float &termo_d_antes, float &termo_d_depois, float &saida_antes,
+                           float &saida_depois) {
+    NucleoPID<N> pid(DT, 10000, INTEGRAL_MAXIMO);
+    pid.definir_ganhos(10, 0, 20);
+    pid.definir_estrutura(1, c, 0);
+    for (int i = 0; i < 4; i++) {
+        saida_antes = numero_para_float(pid.calcular(numero_de_float<N>(8), numero_de_float<N>(4)));
+    }
+    termo_d_antes = numero_para_float(pid.termo_d());
+    saida_depois = numero_para_float(pid.calcular(numero_de_float<N>(8), numero_de_float<N>(4.5f)));
+    termo_d_depois = numero_para_float(pid.termo_d());
+}
+
+void test_derivada_da_medida_sem_pico_no_degrau(void) {
+    float d_antes, d_depois, antes, depois;
+    degrau_de_alvo<float>(0, d_antes, d_depois, antes, depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0, d_depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10 * 0.5f, antes - depois);     // Só o P: kp * 0.5
+    degrau_de_alvo<Q16>(0, d_antes, d_depois, antes, depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0, d_depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 10 * 0.5f, antes - depois);
+
+    // c = 1: kd * 0.5 / dt a mais, de uma vez
+    degrau_de_alvo<float>(1, d_antes, d_depois, antes, depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0, d_antes);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -20 * 0.5f / DT, d_depois);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10 * 0.5f + 20 * 0.5f / DT, antes - depois);
+}
+
+void test_peso_b_no_termo_p(void) {
+    const float pesos[] = {1, 0.5f, 0};
+    for (float b : pesos) {
+        NucleoPID<float> pid(DT, 10000, INTEGRAL_MAXIMO);
+        pid.definir_ganhos(10, 0, 0);
+        pid.definir_estrutura(b, 0, 0);
+        pid.calcular(5, 4);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10 * (5 - b * 4), pid.termo_p());
+    }
+}
+
+void test_filtro_da_derivada_de_primeira_ordem(void) {
+    // Rampa de 0.1°C/s na medida: sem filtro o D vai direto a kd * 0.1; com
+    // n = 2 sobe como 1 - exp(-t/Tf), Tf = kd / (kp * n) = 10 s
+    const float kp = 10, kd = 200, n = 2, inclinacao = 0.1f;
+    const float tf = kd / (kp * n);
+    const float final_d = kd * inclinacao;
+    NucleoPID<float> pid(DT, 10000, INTEGRAL_MAXIMO);
+    NucleoPID<float> sem_filtro(DT, 10000, INTEGRAL_MAXIMO);
+    pid.definir_ganhos(kp, 0, kd);
+    pid.definir_estrutura(1, 0, n);
+    sem_filtro.definir_ganhos(kp, 0, kd);
+    sem_filtro.definir_estrutura(1, 0, 0);
+    float medida = 5;
+    pid.calcular(medida, 4);
+    sem_filtro.calcular(medida, 4);
+    const float alfa = tf / (tf + DT);
+    for (int k = 1; k <= 80; k++) {
+        medida += inclinacao * DT;
+        pid.calcular(medida, 4);
+        sem_filtro.calcular(medida, 4);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, final_d, sem_filtro.termo_d());
+        // Euler implícito: d_k = kd * s * (1 - alfa^k)
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, final_d * (1 - powf(alfa, k)), pid.termo_d());
+        // e a resposta contínua, a menos do erro da discretização
+        TEST_ASSERT_FLOAT_WITHIN(0.02f * final_d, final_d * (1 - expf(-k * DT / tf)), pid.termo_d());
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_conversao_satura);
+    RUN_TEST(test_operacoes_saturam);
+    RUN_TEST(test_erro_de_um_passo_dentro_do_limite);
+    RUN_TEST(test_ganho_grande_nao_inverte_a_saida);
+    RUN_TEST(test_derivada_da_medida_sem_pico_no_degrau);
+    RUN_TEST(test_peso_b_no_termo_p);
+    RUN_TEST(test_filtro_da_derivada_de_primeira_ordem);
+    return UNITY_END();
+}